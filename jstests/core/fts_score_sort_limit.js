@@ -0,0 +1,56 @@
+// Test that a text search sorted by text score with a limit returns the same scores as the
+// unlimited sort, even though the text stage can stop reading the index early.
+(function() {
+    "use strict";
+
+    var t = db.fts_score_sort_limit;
+    t.drop();
+
+    var words = ["apple", "banana", "cherry", "grape", "melon", "orange", "peach", "plum"];
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        var text = [];
+        for (var j = 0; j < words.length; j++) {
+            for (var n = (i * (j + 3)) % 7; n > 0; n--) {
+                text.push(words[j]);
+            }
+        }
+        text.push("filler" + (i % 11));
+        bulk.insert({_id: i, a: text.join(" "), b: words[i % words.length]});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.createIndex({a: "text", b: "text"}, {weights: {a: 2, b: 5}}));
+
+    function query(search, limit) {
+        var cursor = t.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+                         .sort({score: {$meta: "textScore"}});
+        if (limit) {
+            cursor = cursor.limit(limit);
+        }
+        return cursor;
+    }
+
+    function scores(search, limit) {
+        return query(search, limit).toArray().map(function(doc) {
+            return doc.score;
+        });
+    }
+
+    ["apple", "apple banana", "cherry grape melon", "orange peach plum filler3", "filler5 nothing"]
+        .forEach(function(search) {
+            var all = scores(search, 0);
+            [1, 5, 50, 1000].forEach(function(limit) {
+                assert.eq(all.slice(0, limit), scores(search, limit), search + " " + limit);
+            });
+        });
+
+    // With a single term, the top five are known after reading about five index keys rather than
+    // the keys of every document containing the term.
+    function keysExamined(search, limit) {
+        return query(search, limit).explain("executionStats").executionStats.totalKeysExamined;
+    }
+
+    var unlimitedKeys = keysExamined("apple", 0);
+    var limitedKeys = keysExamined("apple", 5);
+    assert.lt(limitedKeys, unlimitedKeys, "text search with a limit did not stop reading early");
+})();
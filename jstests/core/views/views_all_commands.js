@@ -546,6 +546,7 @@
         // Percona commands
         auditGetOptions: {skip: isUnrelated},
         createBackup: {skip: isUnrelated},
+        rotateMasterKey: {skip: isUnrelated},
     };
 
     /**
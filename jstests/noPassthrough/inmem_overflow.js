@@ -0,0 +1,87 @@
+// Tests the inMemory engine's overflow to disk options and the serverStatus section reporting on
+// them, and that an overflow path not created for overflow files is refused rather than emptied.
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine !== "inMemory") {
+        jsTestLog("Skipping test because storageEngine is not inMemory");
+        return;
+    }
+
+    const baseDir = MongoRunner.dataPath + "inmem_overflow";
+    const overflowPath = baseDir + "/overflow";
+    resetDbpath(baseDir);
+
+    // Without overflow, the section reports it as disabled.
+    let conn = MongoRunner.runMongod({storageEngine: 'inMemory'});
+    assert.neq(null, conn, "mongod failed to start with the inMemory engine");
+    let overflow = assert.commandWorked(conn.adminCommand({serverStatus: 1})).inMemory.overflow;
+    assert.eq(false, overflow.enabled, tojson(overflow));
+    MongoRunner.stopMongod(conn);
+
+    // With overflow, the directory is created, marked, and reported on.
+    conn = MongoRunner.runMongod({
+        storageEngine: 'inMemory',
+        inMemoryOverflowToDisk: '',
+        inMemoryOverflowPath: overflowPath,
+    });
+    assert.neq(null, conn, "mongod failed to start with --inMemoryOverflowToDisk");
+
+    const coll = conn.getDB("test").inmem_overflow;
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({_id: i, x: "a".repeat(1024)}));
+    }
+    assert.eq(100, coll.find().itcount());
+
+    overflow = assert.commandWorked(conn.adminCommand({serverStatus: 1})).inMemory.overflow;
+    assert.eq(true, overflow.enabled, tojson(overflow));
+    assert.eq(overflowPath, overflow.path, tojson(overflow));
+    assert.gte(overflow.cacheHitRatio, 0, tojson(overflow));
+    assert.lte(overflow.cacheHitRatio, 1, tojson(overflow));
+    ["pagesReadFromDisk",
+     "bytesReadFromDisk",
+     "pagesWrittenToDisk",
+     "bytesWrittenToDisk",
+     "bytesOnDisk"]
+        .forEach(function(field) {
+            assert.gte(overflow[field], 0, field + ": " + tojson(overflow));
+        });
+    MongoRunner.stopMongod(conn);
+
+    const hasMarker = function(dir) {
+        return listFiles(dir).some(function(file) {
+            return file.baseName === ".inMemoryOverflow";
+        });
+    };
+    assert(hasMarker(overflowPath), tojson(listFiles(overflowPath)));
+
+    // A directory previously used for overflow is emptied and reused. The data is not kept.
+    conn = MongoRunner.runMongod({
+        storageEngine: 'inMemory',
+        inMemoryOverflowToDisk: '',
+        inMemoryOverflowPath: overflowPath,
+    });
+    assert.neq(null, conn, "mongod failed to reuse its own overflow directory");
+    assert.eq(0, conn.getDB("test").inmem_overflow.find().itcount());
+    MongoRunner.stopMongod(conn);
+
+    // A non-empty directory without the marker, such as another mongod's dbpath, is refused and
+    // left untouched.
+    const otherDir = baseDir + "/other";
+    mkdir(otherDir);
+    writeFile(otherDir + "/WiredTiger", "");
+    clearRawMongoProgramOutput();
+    conn = MongoRunner.runMongod({
+        storageEngine: 'inMemory',
+        inMemoryOverflowToDisk: '',
+        inMemoryOverflowPath: otherDir,
+    });
+    assert.eq(null, conn, "mongod started with an overflow path it did not create");
+    assert(rawMongoProgramOutput().match("has no .inMemoryOverflow marker file"),
+           "mongod did not report why the overflow path was refused");
+    assert(listFiles(otherDir).some(function(file) {
+        return file.baseName === "WiredTiger";
+    }),
+           "the refused overflow path was modified");
+    assert(!hasMarker(otherDir), tojson(listFiles(otherDir)));
+}());
@@ -0,0 +1,32 @@
+// Tests that the time for oplog writes to become visible is reported in serverStatus.
+// @tags: [requires_wiredtiger, requires_replication]
+(function() {
+    "use strict";
+
+    var rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    var primary = rst.getPrimary();
+    var coll = primary.getDB("test").getCollection("test");
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i}, {writeConcern: {w: "majority"}}));
+    }
+
+    var stats = assert.commandWorked(primary.adminCommand({serverStatus: 1}))
+                    .wiredTiger.oplogVisibility;
+    assert(stats, "missing oplogVisibility section");
+    assert.gt(stats.count, 0, tojson(stats));
+    assert.gte(stats.totalLatencyMicros, 0, tojson(stats));
+
+    // Background oplog writes keep updating the counters while serverStatus reads them. The
+    // histogram is read before the count, so it can lag behind the count but never exceed it.
+    var histogramCount = 0;
+    stats.histogram.forEach(function(bucket) {
+        histogramCount += bucket.count;
+    });
+    assert.gt(histogramCount, 0, tojson(stats));
+    assert.lte(histogramCount, stats.count, tojson(stats));
+
+    rst.stopSet();
+})();
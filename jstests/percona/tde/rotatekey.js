@@ -0,0 +1,60 @@
+/**
+ * Tests that the master key can be rotated at startup
+ * without touching the data files.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+    load('jstests/backup/_backup_helpers.js');
+
+    // Run the original instance and fill it with data.
+    var dbPath = MongoRunner.dataPath + 'rotatekey';
+    var conn = MongoRunner.runMongod({
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileGood,
+        encryptionCipherMode: TestData.cipherMode,
+    });
+
+    fillData(conn);
+    var hashesOrig = computeHashes(conn);
+    MongoRunner.stopMongod(conn);
+
+    // Rotate the master key - ensure data is still readable and writable
+    conn = MongoRunner.runMongod({
+        noCleanData: true,
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileGood,
+        encryptionRotateKeyFile: TestData.keyFileWrong,
+        encryptionCipherMode: TestData.cipherMode,
+    });
+    assert.hashesEq(hashesOrig, computeHashes(conn));
+    fillData(conn, 500);
+    var hashesRotated = computeHashes(conn);
+    MongoRunner.stopMongod(conn);
+
+    // Start with the old key - ensure it fails and names the new key file
+    clearRawMongoProgramOutput();
+    assert.isnull(MongoRunner.runMongod({
+        noCleanData: true,
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileGood,
+        encryptionCipherMode: TestData.cipherMode,
+    }));
+    assert.gte(rawMongoProgramOutput().indexOf(
+                   'The master key was rotated to the key from ' + TestData.keyFileWrong),
+               0);
+
+    // Start with the new key - ensure it succeeds and DBHash is correct
+    conn = MongoRunner.runMongod({
+        noCleanData: true,
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileWrong,
+        encryptionCipherMode: TestData.cipherMode,
+    });
+    assert.hashesEq(hashesRotated, computeHashes(conn));
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,57 @@
+/**
+ * Tests that the master key can be rotated on a running server
+ * without touching the data files.
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    'use strict';
+    load('jstests/backup/_backup_helpers.js');
+
+    var dbPath = MongoRunner.dataPath + 'rotatekey_online';
+    var conn = MongoRunner.runMongod({
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileGood,
+        encryptionCipherMode: TestData.cipherMode,
+    });
+    fillData(conn);
+    var hashesOrig = computeHashes(conn);
+
+    // Rotate the master key - ensure data is still readable and writable
+    var adminDB = conn.getDB('admin');
+    assert.commandFailedWithCode(adminDB.runCommand({rotateMasterKey: 1}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailed(adminDB.runCommand({rotateMasterKey: 1, keyFile: dbPath + '/nokey'}));
+    assert.commandWorked(adminDB.runCommand({rotateMasterKey: 1, keyFile: TestData.keyFileWrong}));
+    assert.hashesEq(hashesOrig, computeHashes(conn));
+    // new databases get their keys from the rotated keys DB
+    assert.commandWorked(conn.getDB('rotatekey_online').c.insert({a: 1}));
+    fillData(conn, 500);
+    var hashesRotated = computeHashes(conn);
+    MongoRunner.stopMongod(conn);
+
+    // Start with the old key - ensure it fails and names the new key file
+    clearRawMongoProgramOutput();
+    assert.isnull(MongoRunner.runMongod({
+        noCleanData: true,
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileGood,
+        encryptionCipherMode: TestData.cipherMode,
+    }));
+    assert.gte(rawMongoProgramOutput().indexOf(
+                   'The master key was rotated to the key from ' + TestData.keyFileWrong),
+               0);
+
+    // Start with the new key - ensure it succeeds and DBHash is correct
+    conn = MongoRunner.runMongod({
+        noCleanData: true,
+        dbpath: dbPath,
+        enableEncryption: '',
+        encryptionKeyFile: TestData.keyFileWrong,
+        encryptionCipherMode: TestData.cipherMode,
+    });
+    assert.hashesEq(hashesRotated, computeHashes(conn));
+    assert.eq(1, conn.getDB('rotatekey_online').c.find().itcount());
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,49 @@
+/**
+ * Tests that a multi-delete which removes its documents in batches writes one oplog entry per
+ * document, at increasing optimes, and that the secondaries apply them.
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.batched_multi_delete;
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, internalDeleteMaxBatchSize: 7}));
+
+    const nDocs = 50;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, x: i % 2, y: nDocs - i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({y: 1}));
+    rst.awaitReplication();
+
+    assert.writeOK(coll.remove({x: 0}));
+    assert.eq(nDocs / 2, coll.find().itcount());
+
+    const deletes = primary.getDB("local")
+                        .oplog.rs.find({op: "d", ns: coll.getFullName()})
+                        .sort({$natural: 1})
+                        .toArray();
+    assert.eq(nDocs / 2, deletes.length, tojson(deletes));
+    for (let i = 1; i < deletes.length; i++) {
+        assert.lt(0, timestampCmp(deletes[i].ts, deletes[i - 1].ts), tojson(deletes));
+    }
+    deletes.forEach(function(entry) {
+        assert.eq(0, entry.o._id % 2, tojson(entry));
+    });
+
+    rst.awaitReplication();
+    const secondaryColl = rst.getSecondary().getDB("test").batched_multi_delete;
+    assert.eq(nDocs / 2, secondaryColl.find().itcount());
+    assert.eq(nDocs / 2, secondaryColl.find().hint({y: 1}).itcount());
+    assert.eq(0, secondaryColl.find({x: 0}).itcount());
+
+    rst.stopSet();
+})();
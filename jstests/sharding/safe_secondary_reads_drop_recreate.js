@@ -304,6 +304,7 @@
         // Percona commands
         auditGetOptions: {skip: "does not return user data"},
         createBackup: {skip: "does not return user data"},
+        rotateMasterKey: {skip: "does not return user data"},
     };
 
     commandsRemovedFromMongosIn42.forEach(function(cmd) {
@@ -720,4 +720,28 @@ TEST(BSONObj, sizeChecks) {
         ErrorCodes::BSONObjectTooLarge);
 }
 
+TEST(BSONObjGetField, FindsFieldsOfEveryNameLength) {
+    BSONObjBuilder bob;
+    std::vector<std::string> names;
+    for (size_t len = 0; len < 40; ++len) {
+        names.push_back(std::string(len, 'a' + len % 26));
+        bob.append(names.back(), static_cast<int>(len));
+    }
+    bob.appendNull("z");
+    const BSONObj obj = bob.obj();
+
+    for (size_t len = 0; len < names.size(); ++len) {
+        BSONElement e = obj.getField(names[len]);
+        ASSERT_EQ(NumberInt, e.type()) << "length " << len;
+        ASSERT_EQ(static_cast<int>(len), e.numberInt());
+        ASSERT_EQ(names[len], e.fieldNameStringData());
+    }
+    ASSERT_EQ(jstNULL, obj.getField("z").type());
+
+    // Prefixes and extensions of existing names must not match.
+    ASSERT(obj.getField("bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb").eoo());
+    ASSERT(obj.getField("zz").eoo());
+    ASSERT(BSONObj().getField("").eoo());
+}
+
 }  // unnamed namespace
@@ -30,6 +30,7 @@
  *    it in the license file.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <vector>
@@ -38,6 +39,7 @@
 #include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/oid.h"
+#include "mongo/bson/util/cstring_scan.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/platform/decimal128.h"
@@ -417,6 +419,127 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * Checks the same rules as validateBSONIterative(), but without tracking _id or building error
+ * messages, and with the nesting kept in a fixed size stack. Returns true only if the buffer is
+ * valid. Returns false if it is invalid or uses something this does not handle (CodeWScope, DBRef,
+ * deep nesting), in which case validateBSONIterative() decides and explains.
+ */
+bool validateBSONFast(const char* buffer, uint64_t maxLength) {
+    const char* const end = buffer + maxLength;
+    const uint32_t maxDepth = std::min<uint32_t>(BSONDepth::getMaxAllowableDepth(), 32);
+
+    struct Frame {
+        const char* start;
+        int32_t expectedSize;
+    };
+    Frame frames[32];
+    uint32_t depth = 0;
+    const char* p = buffer;
+
+    auto remaining = [&] { return static_cast<uint64_t>(end - p); };
+    auto readInt32 = [&] { return ConstDataView(p).read<LittleEndian<int32_t>>(); };
+
+    while (true) {
+        // Start of an object or array: 'p' points at its length.
+        if (depth > maxDepth || depth == 32 || remaining() < sizeof(int32_t))
+            return false;
+        frames[depth++] = {p, readInt32()};
+        p += sizeof(int32_t);
+
+        while (true) {
+            if (remaining() < 1)
+                return false;
+            const signed char type = *p++;
+
+            if (type == EOO) {
+                const Frame& frame = frames[--depth];
+                if (p - frame.start != frame.expectedSize)
+                    return false;
+                if (depth == 0)
+                    return true;
+                continue;
+            }
+
+            const char* nameEnd = findCStringEnd(p, end);
+            if (nameEnd == end)
+                return false;
+            p = nameEnd + 1;
+
+            // Fixed size values. Like Buffer::skip(), require at least one byte to follow.
+            uint64_t valueSize;
+            switch (type) {
+                case MinKey:
+                case MaxKey:
+                case jstNULL:
+                case Undefined:
+                    continue;
+                case jstOID:
+                    valueSize = OID::kOIDSize;
+                    break;
+                case NumberInt:
+                    valueSize = sizeof(int32_t);
+                    break;
+                case Bool:
+                    if (remaining() < 1 || static_cast<uint8_t>(*p) > 1)
+                        return false;
+                    ++p;
+                    continue;
+                case NumberDouble:
+                case NumberLong:
+                case bsonTimestamp:
+                case Date:
+                    valueSize = sizeof(int64_t);
+                    break;
+                case NumberDecimal:
+                    valueSize = sizeof(Decimal128::Value);
+                    break;
+                case Code:
+                case Symbol:
+                case String: {
+                    if (remaining() < sizeof(int32_t))
+                        return false;
+                    const int32_t sz = readInt32();
+                    p += sizeof(int32_t);
+                    if (sz <= 0 || static_cast<uint64_t>(sz) > remaining() || p[sz - 1] != '\0')
+                        return false;
+                    p += sz;
+                    continue;
+                }
+                case BinData: {
+                    if (remaining() < sizeof(int32_t))
+                        return false;
+                    const int32_t sz = readInt32();
+                    p += sizeof(int32_t);
+                    if (sz < 0 || sz == std::numeric_limits<int32_t>::max())
+                        return false;
+                    valueSize = 1 + static_cast<uint64_t>(sz);
+                    break;
+                }
+                case RegEx:
+                    for (int i = 0; i < 2; ++i) {
+                        const char* patternEnd = findCStringEnd(p, end);
+                        if (patternEnd == end)
+                            return false;
+                        p = patternEnd + 1;
+                    }
+                    continue;
+                case Object:
+                case Array:
+                    break;
+                default:
+                    return false;
+            }
+
+            if (type == Object || type == Array)
+                break;
+            if (valueSize >= remaining())
+                return false;
+            p += valueSize;
+        }
+    }
+}
+
 }  // namespace
 
 Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
@@ -424,6 +547,9 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
+    if (validateBSONFast(originalBuffer, maxLength))
+        return Status::OK();
+
     Buffer buf(originalBuffer, maxLength, version);
     return validateBSONIterative(&buf);
 }
@@ -33,6 +33,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/data_view.h"
+#include "mongo/bson/bson_depth.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/random.h"
@@ -357,4 +358,46 @@ TEST(BSONValidateBool, BoolValuesAreValidated) {
     }
 }
 
+TEST(BSONValidateDepth, NestingAroundTheLimit) {
+    const auto maxDepth = BSONDepth::getMaxAllowableDepth();
+    for (uint32_t depth = 1; depth <= maxDepth + 2; ++depth) {
+        BSONObj obj = BSON("x" << 1);
+        for (uint32_t i = 1; i < depth; ++i) {
+            obj = BSON("a" << obj);
+        }
+        // Every level adds one frame; the top level object itself is not counted.
+        auto status = validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest);
+        if (depth <= maxDepth + 1) {
+            ASSERT_OK(status) << "depth " << depth;
+        } else {
+            ASSERT_EQ(ErrorCodes::Overflow, status.code()) << "depth " << depth;
+        }
+    }
+}
+
+TEST(BSONValidateTruncated, EveryPrefixOfAValidObjectIsRejected) {
+    BSONObjBuilder bob;
+    bob.append("a_field_name_longer_than_sixteen_bytes", "a string value longer than sixteen");
+    bob.append("b", 1);
+    bob.append("c", 2.5);
+    bob.append("d", true);
+    bob.appendNull("e");
+    bob.appendBinData("f", 3, BinDataGeneral, "abc");
+    bob.appendRegex("g", "^ab", "i");
+    bob.append("h", BSON("i" << BSON_ARRAY(1 << "two" << 3LL)));
+    bob.appendCode("j", "function() {}");
+    bob.appendCodeWScope("k", "x", BSON("y" << 1));
+    bob.append("l", OID::gen());
+    const BSONObj obj = bob.obj();
+
+    ASSERT_OK(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+
+    // Shortening the buffer must fail without reading past its end, whichever element it cuts.
+    for (int len = 5; len < obj.objsize(); ++len) {
+        std::unique_ptr<char[]> copy(new char[len]);
+        memcpy(copy.get(), obj.objdata(), len);
+        ASSERT_NOT_OK(validateBSON(copy.get(), len, BSONVersion::kLatest)) << "length " << len;
+    }
+}
+
 }  // namespace
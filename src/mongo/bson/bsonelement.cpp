@@ -57,6 +57,27 @@ using std::dec;
 using std::hex;
 using std::string;
 
+namespace {
+
+/**
+ * Writes 'str' to 's' with the same escaping as escape(). Runs of characters that need no escaping
+ * are written directly rather than copied through a temporary string.
+ */
+void writeEscaped(std::stringstream& s, StringData str) {
+    const char* runStart = str.rawData();
+    const char* const end = runStart + str.size();
+    for (const char* p = runStart; p != end; ++p) {
+        if (*p != '"' && *p != '\\' && (*p < 0 || *p > 0x1f))
+            continue;
+        s.write(runStart, p - runStart);
+        s << escape(StringData(p, 1));
+        runStart = p + 1;
+    }
+    s.write(runStart, end - runStart);
+}
+
+}  // namespace
+
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
     std::stringstream s;
     BSONElement::jsonStringStream(format, includeFieldNames, pretty, s);
@@ -67,12 +88,17 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
                                    bool includeFieldNames,
                                    int pretty,
                                    std::stringstream& s) const {
-    if (includeFieldNames)
-        s << '"' << escape(fieldName()) << "\" : ";
+    if (includeFieldNames) {
+        s << '"';
+        writeEscaped(s, fieldNameStringData());
+        s << "\" : ";
+    }
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"';
+            writeEscaped(s, StringData(valuestr(), valuestrsize() - 1));
+            s << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
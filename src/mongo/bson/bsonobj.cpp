@@ -35,6 +35,7 @@
 #include "mongo/base/data_range.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonelement_comparator_interface.h"
+#include "mongo/bson/util/cstring_scan.h"
 #include "mongo/db/json.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/hex.h"
@@ -468,15 +469,22 @@ void BSONObj::getFields(unsigned n, const char** fieldNames, BSONElement* fields
 }
 
 BSONElement BSONObj::getField(StringData name) const {
-    BSONObjIterator i(*this);
-    while (i.more()) {
-        BSONElement e = i.next();
-        // We know that e has a cached field length since BSONObjIterator::next internally
-        // called BSONElement::size on the BSONElement that it returned, so it is more
-        // efficient to re-use that information by obtaining the field name as a
-        // StringData, which will be pre-populated with the cached length.
+    const int size = objsize();
+    if (MONGO_unlikely(size == 0))
+        return BSONElement();
+
+    // Same walk as BSONObjIterator, but the field name length comes from a bounded vectorized
+    // scan rather than strlen, and is compared before any name bytes are. The scan may include
+    // the terminating EOO byte, which ends every well formed object.
+    const char* pos = objdata() + 4;
+    const char* const end = objdata() + size - 1;
+    while (pos < end) {
+        const char* fieldName = pos + 1;
+        const int fieldNameSize = findCStringEnd(fieldName, end + 1) - fieldName + 1;
+        BSONElement e(pos, fieldNameSize, -1, BSONElement::CachedSizeTag());
         if (name == e.fieldNameStringData())
             return e;
+        pos += e.size();
     }
     return BSONElement();
 }
@@ -0,0 +1,119 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document shaped like a typical application record: an _id, a handful of short scalar
+ * fields, a nested subdocument and an array of small subdocuments.
+ */
+BSONObj makeDocument(int numItems) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    bob.append("userName", "someone@example.com");
+    bob.append("createdAt", Date_t::fromMillisSinceEpoch(1540000000000LL));
+    bob.append("active", true);
+    bob.append("score", 1234.5);
+    bob.append("visits", 42);
+    {
+        BSONObjBuilder address(bob.subobjStart("address"));
+        address.append("street", "1 Main Street");
+        address.append("city", "Springfield");
+        address.append("zip", "12345");
+    }
+    {
+        BSONArrayBuilder items(bob.subarrayStart("items"));
+        for (int i = 0; i < numItems; ++i) {
+            items.append(BSON("sku" << i << "quantity" << i % 7 << "price" << i * 1.25
+                                    << "description"
+                                    << "an item description of moderate length"));
+        }
+    }
+    bob.append("lastFieldInTheDocument", 1LL);
+    return bob.obj();
+}
+
+void BM_validateBSON(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(doc.objdata(), doc.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+void BM_getFieldFirst(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.getField("_id"));
+    }
+}
+
+void BM_getFieldLast(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.getField("lastFieldInTheDocument"));
+    }
+}
+
+void BM_getFieldMissing(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.getField("notThere"));
+    }
+}
+
+void BM_iterateFields(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto _ : state) {
+        size_t total = 0;
+        for (auto&& elem : doc) {
+            total += elem.fieldNameSize();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+}
+
+BENCHMARK(BM_validateBSON)->Arg(0)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_getFieldFirst)->Arg(0);
+BENCHMARK(BM_getFieldLast)->Arg(0)->Arg(100);
+BENCHMARK(BM_getFieldMissing)->Arg(0)->Arg(100);
+BENCHMARK(BM_iterateFields)->Arg(0)->Arg(100);
+
+}  // namespace
+}  // namespace mongo
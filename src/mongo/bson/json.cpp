@@ -34,8 +34,13 @@
 
 #include <cstdint>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "mongo/base/parse_number.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/platform/strtoll.h"
 #include "mongo/util/base64.h"
@@ -83,6 +88,45 @@ static const char *LBRACE = "{", *RBRACE = "}", *LBRACKET = "[", *RBRACKET = "]"
                   *RPAREN = ")", *COLON = ":", *COMMA = ",", *FORWARDSLASH = "/",
                   *SINGLEQUOTE = "'", *DOUBLEQUOTE = "\"";
 
+namespace {
+
+inline bool isControlChar(char c) {
+    return 0x00 <= c && c <= 0x1F;
+}
+
+/**
+ * Returns the end of the run of characters starting at 'begin' that can be copied into a string
+ * as is: anything but 'terminal', a backslash or a control character. On x86_64 this checks 16
+ * bytes at a time with SSE2.
+ */
+const char* plainCharsEnd(const char* begin, const char* end, char terminal) {
+#if defined(__SSE2__)
+    const __m128i terminals = _mm_set1_epi8(terminal);
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i spaces = _mm_set1_epi8(0x20);
+    const __m128i minusOnes = _mm_set1_epi8(-1);
+    for (; end - begin >= static_cast<std::ptrdiff_t>(sizeof(__m128i)); begin += sizeof(__m128i)) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        // Bytes are signed here, so 0x80 and up are negative and must not count as control.
+        const __m128i control =
+            _mm_and_si128(_mm_cmplt_epi8(chunk, spaces), _mm_cmpgt_epi8(chunk, minusOnes));
+        const __m128i special = _mm_or_si128(
+            control,
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, terminals), _mm_cmpeq_epi8(chunk, backslashes)));
+        const unsigned mask = _mm_movemask_epi8(special);
+        if (mask)
+            return begin + countTrailingZeros64(mask);
+    }
+#endif
+    for (; begin != end; ++begin) {
+        if (*begin == terminal || *begin == '\\' || isControlChar(*begin))
+            return begin;
+    }
+    return end;
+}
+
+}  // namespace
+
 JParse::JParse(StringData str)
     : _buf(str.rawData()), _input(_buf), _input_end(_input + str.size()) {}
 
@@ -98,7 +142,30 @@ Status JParse::parseError(StringData msg) {
 
 Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
     MONGO_JSON_DEBUG("fieldName: " << fieldName);
-    if (peekToken(LBRACE)) {
+
+    // Numbers and strings are by far the most common values. None of the keywords below can start
+    // with a digit or a quote, so dispatch on those directly instead of trying every keyword.
+    const char* next = _input;
+    while (next < _input_end && isspace(*reinterpret_cast<const unsigned char*>(next))) {
+        ++next;
+    }
+    const bool startsWithDigit = next < _input_end &&
+        (isdigit(*reinterpret_cast<const unsigned char*>(next)) ||
+         (*next == '-' && next + 1 < _input_end &&
+          isdigit(*reinterpret_cast<const unsigned char*>(next + 1))));
+    const bool startsWithQuote = next < _input_end && (*next == '"' || *next == '\'');
+
+    if (startsWithDigit) {
+        return number(fieldName, builder);
+    } else if (startsWithQuote) {
+        // The string is copied into the builder right away, so one buffer serves every value.
+        _stringValue.clear();
+        Status ret = quotedString(&_stringValue);
+        if (ret != Status::OK()) {
+            return ret;
+        }
+        builder.append(fieldName, _stringValue);
+    } else if (peekToken(LBRACE)) {
         Status ret = object(fieldName, builder);
         if (ret != Status::OK()) {
             return ret;
@@ -153,14 +220,6 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         if (ret != Status::OK()) {
             return ret;
         }
-    } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
-        if (ret != Status::OK()) {
-            return ret;
-        }
-        builder.append(fieldName, valueString);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -317,17 +376,18 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // The builder copies each name, so the remaining names reuse the first one's buffer.
+        std::string& nextFieldName = firstField;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
-            Status fieldRet = field(&fieldName);
+            nextFieldName.clear();
+            Status fieldRet = field(&nextFieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
             }
             if (!readToken(COLON)) {
                 return parseError("Expecting ':'");
             }
-            Status valueRet = value(fieldName, *objBuilder);
+            Status valueRet = value(nextFieldName, *objBuilder);
             if (valueRet != Status::OK()) {
                 return valueRet;
             }
@@ -1103,16 +1163,27 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
     if (_input >= _input_end) {
         return parseError("Unexpected end of input");
     }
+    // Quoted strings end at a single character and allow anything else, so runs without escapes
+    // or control characters can be copied in one go.
+    const bool copyRuns = allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0';
     const char* q = _input;
     while (q < _input_end && !match(*q, terminalSet)) {
         MONGO_JSON_DEBUG("q: " << q);
+        if (copyRuns) {
+            const char* runEnd = plainCharsEnd(q, _input_end, terminalSet[0]);
+            if (runEnd != q) {
+                result->append(q, runEnd);
+                q = runEnd;
+                continue;
+            }
+        }
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
                 _input = q;
                 return Status::OK();
             }
         }
-        if (0x00 <= *q && *q <= 0x1F) {
+        if (isControlChar(*q)) {
             return parseError("Invalid control character");
         }
         if (*q == '\\' && q + 1 < _input_end) {
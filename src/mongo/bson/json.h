@@ -494,6 +494,9 @@ private:
     const char* const _buf;
     const char* _input;
     const char* const _input_end;
+
+    // Scratch space for quoted string values, reused across values.
+    std::string _stringValue;
 };
 
 }  // namespace mongo
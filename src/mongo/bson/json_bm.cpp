@@ -0,0 +1,88 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document shaped like a typical imported record, with 'numItems' entries in its array.
+ */
+BSONObj makeDocument(int numItems) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    bob.append("userName", "someone@example.com");
+    bob.append("createdAt", Date_t::fromMillisSinceEpoch(1540000000000LL));
+    bob.append("active", true);
+    bob.append("score", 1234.5);
+    bob.append("visits", 42);
+    bob.append("bio", "A longer free text field with \"quotes\", a tab\tand a newline\n in it.");
+    {
+        BSONArrayBuilder items(bob.subarrayStart("items"));
+        for (int i = 0; i < numItems; ++i) {
+            items.append(BSON("sku" << i << "quantity" << i % 7 << "price" << i * 1.25
+                                    << "description"
+                                    << "an item description of moderate length"));
+        }
+    }
+    return bob.obj();
+}
+
+void BM_fromjson(benchmark::State& state) {
+    const std::string json = tojson(makeDocument(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+
+void BM_jsonString(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        auto json = doc.jsonString(Strict);
+        totalBytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+BENCHMARK(BM_fromjson)->Arg(0)->Arg(10)->Arg(1000);
+BENCHMARK(BM_jsonString)->Arg(0)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,68 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+#include "mongo/platform/bits.h"
+#endif
+
+namespace mongo {
+
+/**
+ * Returns a pointer to the first NUL byte in [begin, end), or 'end' if there is none. Never reads
+ * outside of that range, so it is safe to use on untrusted buffers.
+ *
+ * BSON field names are short and scanned constantly, so on x86_64 this checks 16 bytes at a time
+ * with SSE2, which is part of the baseline instruction set and needs no runtime detection. Other
+ * platforms and the tail of the range use a plain byte loop.
+ */
+inline const char* findCStringEnd(const char* begin, const char* end) {
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; end - begin >= static_cast<std::ptrdiff_t>(sizeof(__m128i)); begin += sizeof(__m128i)) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+        if (mask)
+            return begin + countTrailingZeros64(mask);
+    }
+#endif
+    for (; begin != end; ++begin) {
+        if (*begin == '\0')
+            return begin;
+    }
+    return end;
+}
+
+}  // namespace mongo
@@ -0,0 +1,76 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/cstring_scan.h"
+
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(FindCStringEnd, EmptyRange) {
+    const char buf[] = "abc";
+    ASSERT_EQ(buf, findCStringEnd(buf, buf));
+}
+
+TEST(FindCStringEnd, FindsFirstNulAtEveryOffset) {
+    // Cover NULs before, inside and after each 16 byte block, and short tails.
+    for (size_t len = 0; len < 70; ++len) {
+        std::string buf(len, 'x');
+        buf.push_back('\0');
+        buf.append(20, 'y');
+        buf.push_back('\0');
+        ASSERT_EQ(buf.data() + len, findCStringEnd(buf.data(), buf.data() + buf.size()))
+            << "length " << len;
+    }
+}
+
+TEST(FindCStringEnd, StopsAtEndOfRange) {
+    for (size_t len = 0; len < 70; ++len) {
+        // The NUL just past the range must not be found.
+        std::string buf(len, 'x');
+        buf.push_back('\0');
+        ASSERT_EQ(buf.data() + len, findCStringEnd(buf.data(), buf.data() + len))
+            << "length " << len;
+    }
+}
+
+TEST(FindCStringEnd, HighBitBytesAreNotTerminators) {
+    std::string buf(40, '\xff');
+    buf[33] = '\0';
+    ASSERT_EQ(buf.data() + 33, findCStringEnd(buf.data(), buf.data() + buf.size()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -238,6 +238,14 @@ public:
                                     bool noWarn,
                                     StoreDeletedDoc storeDeletedDoc) = 0;
 
+        virtual void deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     const std::vector<OplogSlot>& oplogSlots,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) = 0;
+
         virtual Status insertDocuments(OperationContext* opCtx,
                                        std::vector<InsertStatement>::const_iterator begin,
                                        std::vector<InsertStatement>::const_iterator end,
@@ -463,6 +471,25 @@ public:
             opCtx, stmtId, loc, opDebug, fromMigrate, noWarn, storeDeletedDoc);
     }
 
+    /**
+     * Deletes the documents with the given RecordIds inside one WUOW, removing their index keys in
+     * key order and logging them with one write to the oplog.
+     *
+     * 'oplogSlots' is either empty or holds the reserved oplog slot of each delete, in the order
+     * of 'locs'; each delete is timestamped and logged at its slot.
+     * The remaining arguments are as for deleteDocument().
+     */
+    inline void deleteDocuments(OperationContext* const opCtx,
+                                StmtId stmtId,
+                                const std::vector<RecordId>& locs,
+                                const std::vector<OplogSlot>& oplogSlots,
+                                OpDebug* const opDebug,
+                                const bool fromMigrate = false,
+                                const bool noWarn = false) {
+        return this->_impl().deleteDocuments(
+            opCtx, stmtId, locs, oplogSlots, opDebug, fromMigrate, noWarn);
+    }
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -596,6 +596,65 @@ void CollectionImpl::deleteDocument(OperationContext* opCtx,
         opCtx, ns(), uuid(), stmtId, fromMigrate, deletedDoc);
 }
 
+void CollectionImpl::deleteDocuments(OperationContext* opCtx,
+                                     StmtId stmtId,
+                                     const std::vector<RecordId>& locs,
+                                     const std::vector<OplogSlot>& oplogSlots,
+                                     OpDebug* opDebug,
+                                     bool fromMigrate,
+                                     bool noWarn) {
+    if (isCapped()) {
+        log() << "failing remove on a capped ns " << _ns;
+        uasserted(10089, "cannot remove from a capped collection");
+        return;
+    }
+
+    invariant(oplogSlots.empty() || oplogSlots.size() == locs.size());
+    if (locs.empty()) {
+        return;
+    }
+
+    std::vector<DeleteStatement> stmts;
+    stmts.reserve(locs.size());
+    for (size_t i = 0; i < locs.size(); ++i) {
+        stmts.emplace_back(stmtId,
+                           docFor(opCtx, locs[i]).value().getOwned(),
+                           oplogSlots.empty() ? OplogSlot() : oplogSlots[i]);
+    }
+
+    std::vector<BsonRecord> bsonRecords;
+    bsonRecords.reserve(locs.size());
+    for (size_t i = 0; i < locs.size(); ++i) {
+        BsonRecord bsonRecord = {
+            locs[i], stmts[i].oplogSlot.opTime.getTimestamp(), &(stmts[i].doc)};
+        bsonRecords.push_back(bsonRecord);
+    }
+
+    // A transaction's commit timestamps may not go backwards from the first one it sets, and the
+    // index keys below are removed in key order rather than slot order, so start at the earliest.
+    if (!oplogSlots.empty()) {
+        uassertStatusOK(
+            opCtx->recoveryUnit()->setTimestamp(oplogSlots.front().opTime.getTimestamp()));
+    }
+
+    int64_t keysDeleted;
+    _indexCatalog->unindexRecords(opCtx, bsonRecords, noWarn, &keysDeleted);
+    if (opDebug) {
+        opDebug->additiveMetrics.incrementKeysDeleted(keysDeleted);
+    }
+
+    for (size_t i = 0; i < locs.size(); ++i) {
+        if (!oplogSlots.empty()) {
+            uassertStatusOK(
+                opCtx->recoveryUnit()->setTimestamp(oplogSlots[i].opTime.getTimestamp()));
+        }
+        _recordStore->deleteRecord(opCtx, locs[i]);
+    }
+
+    getGlobalServiceContext()->getOpObserver()->onDeletes(
+        opCtx, ns(), uuid(), stmts.cbegin(), stmts.cend(), fromMigrate);
+}
+
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
@@ -148,6 +148,20 @@ public:
         bool noWarn = false,
         Collection::StoreDeletedDoc storeDeletedDoc = Collection::StoreDeletedDoc::Off) final;
 
+    /**
+     * Deletes the documents with the given RecordIds inside one WUOW.
+     *
+     * 'oplogSlots' is either empty or holds the reserved oplog slot of each delete, in the order
+     * of 'locs'. Slots must be increasing, as getNextOpTimes() returns them.
+     */
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         const std::vector<OplogSlot>& oplogSlots,
+                         OpDebug* opDebug,
+                         bool fromMigrate = false,
+                         bool noWarn = false) final;
+
     /*
      * Inserts all documents inside one WUOW.
      * Caller should ensure vector is appropriately sized for this.
@@ -131,6 +131,16 @@ public:
         std::abort();
     }
 
+    void deleteDocuments(OperationContext* opCtx,
+                         StmtId stmtId,
+                         const std::vector<RecordId>& locs,
+                         const std::vector<OplogSlot>& oplogSlots,
+                         OpDebug* opDebug,
+                         bool fromMigrate,
+                         bool noWarn) {
+        std::abort();
+    }
+
     Status insertDocuments(OperationContext* opCtx,
                            std::vector<InsertStatement>::const_iterator begin,
                            std::vector<InsertStatement>::const_iterator end,
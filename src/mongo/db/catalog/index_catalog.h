@@ -365,6 +365,18 @@ public:
                                const bool noWarn,
                                int64_t* const keysDeletedOut) = 0;
 
+    /**
+     * Unindexes a batch of records, removing the keys of each index in key order. Each key is
+     * removed at the timestamp of its record, if the record has one.
+     *
+     * When 'keysDeletedOut' is not null, it will be set to the number of index keys removed by
+     * this operation.
+     */
+    virtual void unindexRecords(OperationContext* const opCtx,
+                                const std::vector<BsonRecord>& bsonRecords,
+                                const bool noWarn,
+                                int64_t* const keysDeletedOut) = 0;
+
     virtual std::string getAccessMethodName(const BSONObj& keyPattern) = 0;
 
     /**
@@ -0,0 +1,160 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("index_catalog_bm.coll");
+
+const int kMaxIndexes = 16;
+
+// Number of records indexed per benchmark iteration, in batches of the size being benchmarked.
+const int kRecordsPerIteration = 256;
+
+/**
+ * A mongod service context on the ephemeralForTest engine, with a collection that has an index on
+ * each of the first N fields of its documents. The collection has no _id index, so that the same
+ * documents can be indexed again under new RecordIds on every iteration.
+ */
+class IndexCatalogFixture : public ServiceContextMongoDTest {
+public:
+    explicit IndexCatalogFixture(int numIndexes) {
+        auto service = getServiceContext();
+        auto replCoord = stdx::make_unique<repl::ReplicationCoordinatorMock>(service);
+        invariant(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+
+        _opCtx = makeOperationContext();
+        AutoGetOrCreateDb autoDb(_opCtx.get(), kNss.db(), MODE_X);
+        WriteUnitOfWork wuow(_opCtx.get());
+        Collection* coll = autoDb.getDb()->createCollection(
+            _opCtx.get(), kNss.ns(), CollectionOptions(), false /* createDefaultIndexes */);
+        for (int i = 0; i < numIndexes; ++i) {
+            const std::string field = str::stream() << "f" << i;
+            uassertStatusOK(coll->getIndexCatalog()->createIndexOnEmptyCollection(
+                _opCtx.get(),
+                BSON("v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion) << "key"
+                         << BSON(field << 1)
+                         << "name"
+                         << (field + "_1")
+                         << "ns"
+                         << kNss.ns())));
+        }
+        wuow.commit();
+
+        // Random values, so that the documents' keys are spread over each index as they are in
+        // a typical ingest workload.
+        PseudoRandom random(1);
+        for (int i = 0; i < kRecordsPerIteration; ++i) {
+            BSONObjBuilder doc;
+            for (int field = 0; field < kMaxIndexes; ++field) {
+                doc.append(str::stream() << "f" << field, random.nextInt64());
+            }
+            _docs.push_back(doc.obj());
+        }
+    }
+
+    OperationContext* getOperationContext() const {
+        return _opCtx.get();
+    }
+
+    const std::vector<BSONObj>& getDocs() const {
+        return _docs;
+    }
+
+private:
+    void _doTest() override {}
+
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::vector<BSONObj> _docs;
+};
+
+/**
+ * Benchmark indexing records into a collection with a number of indexes, as a multi-document
+ * insert does. The first argument is the number of indexes, the second the number of records
+ * handed to IndexCatalog::indexRecords() at once. Batches of one take the record by record path,
+ * larger ones generate the keys of the whole batch, in parallel across indexes, and insert them in
+ * index order.
+ */
+void BM_IndexRecords(benchmark::State& state) {
+    const int numIndexes = state.range(0);
+    const int batchSize = state.range(1);
+    IndexCatalogFixture fixture(numIndexes);
+    OperationContext* opCtx = fixture.getOperationContext();
+    const std::vector<BSONObj>& docs = fixture.getDocs();
+
+    AutoGetCollection autoColl(opCtx, kNss, MODE_IX);
+    IndexCatalog* indexCatalog = autoColl.getCollection()->getIndexCatalog();
+
+    int64_t nextRecordId = 1;
+    std::vector<BsonRecord> batch;
+    for (auto keepRunning : state) {
+        WriteUnitOfWork wuow(opCtx);
+        for (int i = 0; i < kRecordsPerIteration; i += batchSize) {
+            batch.clear();
+            for (int j = i; j < std::min(i + batchSize, kRecordsPerIteration); ++j) {
+                batch.push_back({RecordId(nextRecordId++), Timestamp(), &docs[j]});
+            }
+            int64_t keysInserted;
+            uassertStatusOK(indexCatalog->indexRecords(opCtx, batch, &keysInserted));
+        }
+        wuow.commit();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kRecordsPerIteration);
+}
+
+BENCHMARK(BM_IndexRecords)
+    ->ArgNames({"indexes", "batch"})
+    ->RangeMultiplier(4)
+    ->Ranges({{1, kMaxIndexes}, {1, kRecordsPerIteration}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace mongo
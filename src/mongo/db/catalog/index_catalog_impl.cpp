@@ -66,9 +66,13 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/represent_as.h"
@@ -87,6 +91,33 @@ static const int INDEX_CATALOG_UNINIT = 654321;
 
 const BSONObj IndexCatalogImpl::_idObj = BSON("_id" << 1);
 
+namespace {
+
+// The number of threads generating index keys for batched inserts. 0 generates the keys of all
+// indexes on the inserting thread.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(indexKeyGenerationThreads, int, 4);
+
+// Smaller batches generate their keys on the inserting thread, as handing them to another thread
+// costs more than generating them.
+const size_t kMinRecordsToGenerateKeysInParallel = 16;
+
+ThreadPool* keyGenerationPool() {
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "IndexKeyGeneration";
+        options.threadNamePrefix = "IndexKeyGeneration-";
+        options.minThreads = 0;
+        options.maxThreads = static_cast<size_t>(indexKeyGenerationThreads);
+        // Intentionally leaked.
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
 // -------------
 
 IndexCatalogImpl::IndexCatalogImpl(Collection* collection, int maxNumIndexesAllowed)
@@ -1303,6 +1334,10 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    if (bsonRecords.size() > 1) {
+        return _indexRecordBatch(opCtx, bsonRecords, keysInsertedOut);
+    }
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
         Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
@@ -1313,6 +1348,94 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexCatalogImpl::_indexRecordBatch(OperationContext* opCtx,
+                                           const std::vector<BsonRecord>& bsonRecords,
+                                           int64_t* keysInsertedOut) {
+    struct IndexBatch {
+        IndexCatalogEntry* index;
+        InsertDeleteOptions options;
+        // Either 'bsonRecords' or 'filteredRecords' for partial indexes.
+        const std::vector<BsonRecord>* records;
+        std::vector<BsonRecord> filteredRecords;
+        IndexAccessMethod::KeysForRecords keys;
+        Status status = Status::OK();
+    };
+
+    std::vector<IndexBatch> batches(_entries.size());
+    size_t numBatches = 0;
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        IndexBatch& batch = batches[numBatches++];
+        batch.index = i->get();
+        prepareInsertDeleteOptions(opCtx, batch.index->descriptor(), &batch.options);
+        batch.records = &bsonRecords;
+
+        if (const MatchExpression* filter = batch.index->getFilterExpression()) {
+            for (const auto& bsonRecord : bsonRecords) {
+                if (filter->matchesBSON(*bsonRecord.docPtr))
+                    batch.filteredRecords.push_back(bsonRecord);
+            }
+            batch.records = &batch.filteredRecords;
+        }
+    }
+
+    auto generateKeys = [](IndexBatch* batch) {
+        try {
+            batch->index->accessMethod()->getKeysForRecords(
+                *batch->records, batch->options.getKeysMode, &batch->keys);
+        } catch (...) {
+            batch->status = exceptionToStatus();
+        }
+    };
+
+    if (batches.size() < 2 || bsonRecords.size() < kMinRecordsToGenerateKeysInParallel ||
+        indexKeyGenerationThreads <= 0) {
+        for (auto& batch : batches) {
+            generateKeys(&batch);
+        }
+    } else {
+        // Hand every index but the first to the pool and generate the keys of the first one here.
+        stdx::mutex mutex;
+        stdx::condition_variable done;
+        size_t pending = batches.size() - 1;
+        for (size_t i = 1; i < batches.size(); ++i) {
+            IndexBatch* batch = &batches[i];
+            auto task = [&, batch] {
+                generateKeys(batch);
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (--pending == 0)
+                    done.notify_one();
+            };
+            if (!keyGenerationPool()->schedule(task).isOK()) {
+                task();
+            }
+        }
+        generateKeys(&batches[0]);
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        done.wait(lk, [&] { return pending == 0; });
+    }
+
+    for (auto& batch : batches) {
+        // Errors from key generation surface the same way as when indexing record by record.
+        uassertStatusOK(batch.status);
+        if (batch.records->empty())
+            continue;
+
+        int64_t inserted;
+        Status status = batch.index->accessMethod()->insertKeysForRecords(
+            opCtx, *batch.records, batch.keys, batch.options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+    }
+
+    return Status::OK();
+}
+
 void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
                                      const BSONObj& obj,
                                      const RecordId& loc,
@@ -1332,6 +1455,40 @@ void IndexCatalogImpl::unindexRecord(OperationContext* opCtx,
     }
 }
 
+void IndexCatalogImpl::unindexRecords(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      bool noWarn,
+                                      int64_t* keysDeletedOut) {
+    if (keysDeletedOut) {
+        *keysDeletedOut = 0;
+    }
+
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        IndexCatalogEntry* entry = i->get();
+
+        // Same options as _unindexRecord(), including blind deletes being disabled for
+        // in-progress indexes.
+        InsertDeleteOptions options;
+        prepareInsertDeleteOptions(opCtx, entry->descriptor(), &options);
+        options.logIfError = entry->isReady(opCtx) ? !noWarn : false;
+        options.dupsAllowed = options.dupsAllowed || !entry->isReady(opCtx);
+
+        // Relax key constraints on removal, as IndexAccessMethod::remove() does.
+        IndexAccessMethod::KeysForRecords keys;
+        entry->accessMethod()->getKeysForRecords(
+            bsonRecords, IndexAccessMethod::GetKeysMode::kRelaxConstraintsUnfiltered, &keys);
+
+        int64_t removed;
+        uassertStatusOK(entry->accessMethod()->removeKeysForRecords(
+            opCtx, bsonRecords, keys, options, &removed));
+
+        if (keysDeletedOut) {
+            *keysDeletedOut += removed;
+        }
+    }
+}
+
 std::unique_ptr<IndexCatalog::IndexBuildBlockInterface> IndexCatalogImpl::createIndexBuildBlock(
     OperationContext* opCtx, const BSONObj& spec) {
     return std::make_unique<IndexBuildBlock>(opCtx, _collection, this, spec);
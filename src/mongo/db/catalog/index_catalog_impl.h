@@ -320,6 +320,11 @@ public:
                        bool noWarn,
                        int64_t* keysDeletedOut) override;
 
+    void unindexRecords(OperationContext* opCtx,
+                        const std::vector<BsonRecord>& bsonRecords,
+                        bool noWarn,
+                        int64_t* keysDeletedOut) override;
+
     inline std::string getAccessMethodName(const BSONObj& keyPattern) override {
         return _getAccessMethodName(keyPattern);
     }
@@ -366,6 +371,15 @@ private:
                          const std::vector<BsonRecord>& bsonRecords,
                          int64_t* keysInsertedOut);
 
+    /**
+     * Indexes a batch of records into every index. The keys of each index are generated for the
+     * whole batch, concurrently across indexes when the batch is large enough, and inserted in
+     * index order.
+     */
+    Status _indexRecordBatch(OperationContext* opCtx,
+                             const std::vector<BsonRecord>& bsonRecords,
+                             int64_t* keysInsertedOut);
+
     Status _unindexRecord(OperationContext* opCtx,
                           IndexCatalogEntry* index,
                           const BSONObj& obj,
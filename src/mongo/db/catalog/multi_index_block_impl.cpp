@@ -34,6 +34,8 @@
 
 #include "mongo/db/catalog/multi_index_block_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -50,8 +52,10 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -96,6 +100,10 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// The number of threads feeding the bulk builders of a foreground index build, at most one per
+// index. 0 feeds them from the thread scanning the collection.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildSortThreads, int, 8);
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -113,6 +121,137 @@ private:
     MultiIndexBlockImpl* const _indexer;
 };
 
+/**
+ * Feeds the documents of a foreground index build to the bulk builders from a thread per index,
+ * so that key generation and sorting for all the indexes run alongside the collection scan.
+ *
+ * Documents are copied into batches. While the workers insert one batch into their bulk builders,
+ * the scan fills the next one.
+ */
+class MultiIndexBlockImpl::ParallelBulkLoader {
+    MONGO_DISALLOW_COPYING(ParallelBulkLoader);
+
+public:
+    ParallelBulkLoader(MultiIndexBlockImpl* indexer, size_t numThreads) : _indexer(indexer) {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildSort";
+        options.threadNamePrefix = "IndexBuildSort-";
+        options.minThreads = options.maxThreads = numThreads;
+        _pool = stdx::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+
+    ~ParallelBulkLoader() {
+        // The workers must be done with the batch before it goes away.
+        _waitForBatch().ignore();
+        _pool->shutdown();
+        _pool->join();
+    }
+
+    /**
+     * Adds a copy of 'doc' to the current batch, handing the batch to the workers once full.
+     * Returns the first error the workers ran into so far.
+     */
+    Status add(const BSONObj& doc, const RecordId& loc) {
+        _filling.emplace_back(doc.getOwned(), loc);
+        _fillingBytes += doc.objsize();
+        if (_filling.size() < kMaxBatchDocs && _fillingBytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+        return _dispatch();
+    }
+
+    /**
+     * Hands the last batch to the workers and waits until every document has been inserted.
+     */
+    Status finish() {
+        Status status = _dispatch();
+        if (!status.isOK()) {
+            return status;
+        }
+        return _waitForBatch();
+    }
+
+private:
+    static constexpr size_t kMaxBatchDocs = 10 * 1000;
+    static constexpr size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+    Status _dispatch() {
+        Status status = _waitForBatch();
+        if (!status.isOK()) {
+            return status;
+        }
+
+        _inFlight.clear();
+        _inFlight.swap(_filling);
+        _fillingBytes = 0;
+        if (_inFlight.empty()) {
+            return Status::OK();
+        }
+
+        for (auto& index : _indexer->_indexes) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                ++_pending;
+            }
+            auto task = [this, &index] { _insertBatch(&index); };
+            if (!_pool->schedule(task).isOK()) {
+                task();
+            }
+        }
+        return Status::OK();
+    }
+
+    void _insertBatch(IndexToBuild* index) {
+        Status status = Status::OK();
+        try {
+            for (const auto& doc : _inFlight) {
+                if (index->filterExpression && !index->filterExpression->matchesBSON(doc.first)) {
+                    continue;
+                }
+                // BulkBuilder::insert() only generates and sorts keys, it does not use the
+                // OperationContext to access storage.
+                status =
+                    index->bulk->insert(_indexer->_opCtx, doc.first, doc.second, index->options);
+                if (!status.isOK()) {
+                    break;
+                }
+            }
+        } catch (...) {
+            status = exceptionToStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!status.isOK() && _status.isOK()) {
+            _status = status;
+        }
+        if (--_pending == 0) {
+            _batchDone.notify_all();
+        }
+    }
+
+    Status _waitForBatch() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _batchDone.wait(lk, [this] { return _pending == 0; });
+        return _status;
+    }
+
+    MultiIndexBlockImpl* const _indexer;
+    std::unique_ptr<ThreadPool> _pool;
+
+    // Only used by the scanning thread.
+    std::vector<std::pair<BSONObj, RecordId>> _filling;
+    size_t _fillingBytes = 0;
+
+    // Read by the workers while '_pending' is non-zero.
+    std::vector<std::pair<BSONObj, RecordId>> _inFlight;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _batchDone;
+    size_t _pending = 0;
+    Status _status = Status::OK();
+};
+
 /**
  * On rollback in init(), cleans up _indexes so that ~MultiIndexBlock doesn't try to clean
  * up _indexes manually (since the changes were already rolled back).
@@ -358,6 +497,18 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
     auto exec =
         _collection->makePlanExecutor(_opCtx, yieldPolicy, Collection::ScanDirection::kForward);
 
+    // Foreground builds that only fill bulk builders can hand the documents to other threads, as
+    // nothing is written to the indexes until doneInserting().
+    std::unique_ptr<ParallelBulkLoader> bulkLoader;
+    const int sortThreads = maxIndexBuildSortThreads.load();
+    if (!_buildInBackground && sortThreads > 0 &&
+        std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return static_cast<bool>(index.bulk);
+        })) {
+        bulkLoader = stdx::make_unique<ParallelBulkLoader>(
+            this, std::min(_indexes.size(), static_cast<size_t>(sortThreads)));
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -391,7 +542,8 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
             WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = bulkLoader ? bulkLoader->add(objToIndex.value(), loc)
+                                    : insert(objToIndex.value(), loc);
             if (_buildInBackground)
                 exec->saveState();
             if (!ret.isOK()) {
@@ -456,6 +608,14 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
         }
     }
 
+    if (bulkLoader) {
+        Status status = bulkLoader->finish();
+        if (!status.isOK()) {
+            return status;
+        }
+        bulkLoader.reset();
+    }
+
     progress->finished();
 
     Status ret = doneInserting();
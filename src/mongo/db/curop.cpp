@@ -652,6 +652,8 @@ string OpDebug::report(Client* client,
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysInserted", additiveMetrics.keysInserted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflictMicros",
+                                   additiveMetrics.prepareReadConflictMicros);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
 
     s << " numYields:" << curop.numYields();
@@ -740,6 +742,7 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_OPTIONAL("keysInserted", additiveMetrics.keysInserted);
     OPDEBUG_APPEND_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_APPEND_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
+    OPDEBUG_APPEND_OPTIONAL("prepareReadConflictMicros", additiveMetrics.prepareReadConflictMicros);
     OPDEBUG_APPEND_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
 
     b.appendNumber("numYield", curop.numYields());
@@ -819,6 +822,8 @@ void OpDebug::AdditiveMetrics::add(const AdditiveMetrics& otherMetrics) {
     keysDeleted = addOptionalLongs(keysDeleted, otherMetrics.keysDeleted);
     prepareReadConflicts =
         addOptionalLongs(prepareReadConflicts, otherMetrics.prepareReadConflicts);
+    prepareReadConflictMicros =
+        addOptionalLongs(prepareReadConflictMicros, otherMetrics.prepareReadConflictMicros);
     writeConflicts = addOptionalLongs(writeConflicts, otherMetrics.writeConflicts);
 }
 
@@ -829,6 +834,7 @@ bool OpDebug::AdditiveMetrics::equals(const AdditiveMetrics& otherMetrics) {
         nmoved == otherMetrics.nmoved && keysInserted == otherMetrics.keysInserted &&
         keysDeleted == otherMetrics.keysDeleted &&
         prepareReadConflicts == otherMetrics.prepareReadConflicts &&
+        prepareReadConflictMicros == otherMetrics.prepareReadConflictMicros &&
         writeConflicts == otherMetrics.writeConflicts;
 }
 
@@ -874,6 +880,13 @@ void OpDebug::AdditiveMetrics::incrementPrepareReadConflicts(long long n) {
     *prepareReadConflicts += n;
 }
 
+void OpDebug::AdditiveMetrics::incrementPrepareReadConflictMicros(long long n) {
+    if (!prepareReadConflictMicros) {
+        prepareReadConflictMicros = 0;
+    }
+    *prepareReadConflictMicros += n;
+}
+
 string OpDebug::AdditiveMetrics::report() {
     StringBuilder s;
 
@@ -887,6 +900,7 @@ string OpDebug::AdditiveMetrics::report() {
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysInserted", keysInserted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", keysDeleted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflicts", prepareReadConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflictMicros", prepareReadConflictMicros);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("writeConflicts", writeConflicts);
 
     return s.str();
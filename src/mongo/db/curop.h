@@ -101,6 +101,11 @@ public:
          */
         void incrementPrepareReadConflicts(long long n);
 
+        /**
+         * Increments prepareReadConflictMicros by n.
+         */
+        void incrementPrepareReadConflictMicros(long long n);
+
         /**
          * Generates a string showing all non-empty fields. For every non-empty field field1,
          * field2, ..., with corresponding values value1, value2, ..., we will output a string in
@@ -126,6 +131,8 @@ public:
         boost::optional<long long> keysDeleted;
         // Number of read conflicts caused by a prepared transaction.
         boost::optional<long long> prepareReadConflicts;
+        // Time spent waiting for prepared transactions to commit or abort after read conflicts.
+        boost::optional<long long> prepareReadConflictMicros;
         boost::optional<long long> writeConflicts;
     };
 
@@ -0,0 +1,71 @@
+/*======
+This file is part of Percona Server for MongoDB.
+
+Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
+
+    Percona Server for MongoDB is free software: you can redistribute
+    it and/or modify it under the terms of the GNU Affero General
+    Public License, version 3, as published by the Free Software
+    Foundation.
+
+    Percona Server for MongoDB is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied
+    warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+    See the GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public
+    License along with Percona Server for MongoDB.  If not, see
+    <http://www.gnu.org/licenses/>.
+======= */
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/engine_extension.h"
+
+using namespace mongo;
+
+namespace percona {
+
+class RotateMasterKeyCommand : public BasicCommand {
+public:
+    RotateMasterKeyCommand() : BasicCommand("rotateMasterKey") {}
+    std::string help() const override {
+        return "Re-encrypts the encryption keys database with the master key read from the "
+               "given key file. Use the new key file as encryptionKeyFile from now on.\n"
+               "{ rotateMasterKey: 1, keyFile: <path to new key file> }";
+    }
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::rotateMasterKey);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+    bool adminOnly() const override {
+        return true;
+    }
+    AllowedOnSecondary secondaryAllowed(ServiceContext* context) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const auto keyFile = cmdObj["keyFile"];
+        uassert(ErrorCodes::BadValue,
+                "keyFile must be the path to the new encryption key file",
+                keyFile.type() == String);
+
+        // progress is reported to the log by the storage engine
+        auto se = opCtx->getServiceContext()->getStorageEngine();
+        uassertStatusOK(se->keydbRotateMasterKey(keyFile.String()));
+        return true;
+    }
+} rotateMasterKeyCmd;
+
+}  // end of percona namespace.
@@ -28,6 +28,8 @@ struct EncryptionGlobalParams {
     bool enableEncryption = false;
     std::string encryptionCipherMode = "AES256-CBC";
     std::string encryptionKeyFile;
+    // if set, the master key is rotated to the key from this file at startup
+    std::string encryptionRotateKeyFile;
 };
 
 extern EncryptionGlobalParams encryptionGlobalParams;
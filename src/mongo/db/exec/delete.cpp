@@ -34,6 +34,9 @@
 
 #include "mongo/db/exec/delete.h"
 
+#include <algorithm>
+#include <boost/optional.hpp>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
@@ -42,8 +45,12 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/transaction_participant.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -68,6 +75,38 @@ bool shouldRestartDeleteIfNoLongerMatches(const DeleteStageParams& params) {
     return params.returnDeleted && !params.sort.isEmpty();
 };
 
+/**
+ * Returns true if the documents deleted by this stage may share a WriteUnitOfWork. A batch of
+ * deletes reserves its oplog slots up front, as a batch of inserts does, so replicated
+ * multi-deletes are batched too. Deletes which return the deleted document delete at most one.
+ */
+bool canDeleteInBatches(const DeleteStageParams& params, Collection* collection) {
+    return collection && params.isMulti && !params.returnDeleted;
+}
+
+/**
+ * Reserves an oplog slot for each of 'count' deletes from 'collection', which must be done inside
+ * the WriteUnitOfWork that deletes them. Returns no slots if the deletes are not timestamped
+ * individually: when the storage engine lacks document-level locking, when they are not written to
+ * the oplog, or when they are part of a multi-document transaction, whose optimes are generated at
+ * commit.
+ */
+std::vector<OplogSlot> reserveOplogSlots(OperationContext* opCtx,
+                                         Collection* collection,
+                                         size_t count) {
+    if (!opCtx->getServiceContext()->getStorageEngine()->supportsDocLocking()) {
+        return {};
+    }
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
+        return {};
+    }
+    if (repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, collection->ns())) {
+        return {};
+    }
+    return repl::getNextOpTimes(opCtx, count);
+}
+
 }  // namespace
 
 // static
@@ -83,7 +122,10 @@ DeleteStage::DeleteStage(OperationContext* opCtx,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _maxBatchSize(canDeleteInBatches(params, collection)
+                        ? std::max(internalDeleteMaxBatchSize.load(), 1)
+                        : 1) {
     _children.emplace_back(child);
 }
 
@@ -95,7 +137,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -104,6 +146,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     }
     invariant(_collection);  // If isEOF() returns false, we must have a collection.
 
+    if (_maxBatchSize > 1) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after a delete was executed, a WriteConflictException occurred
     // and prevented us from returning ADVANCED with the old version of the document.
     if (_idReturning != WorkingSet::INVALID_ID) {
@@ -194,9 +240,6 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         member->obj.setValue(deletedDoc.getOwned());
     }
 
-    // TODO: Do we want to buffer docs and delete them in a group rather than saving/restoring state
-    // repeatedly?
-
     WorkingSetCommon::prepareForSnapshotChange(_ws);
     try {
         child()->saveState();
@@ -263,6 +306,140 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+PlanStage::StageState DeleteStage::doBatchedWork(WorkingSetID* out) {
+    if (!_batchReady) {
+        WorkingSetID id;
+        auto status = child()->work(&id);
+
+        switch (status) {
+            case PlanStage::ADVANCED: {
+                WorkingSetMember* member = _ws->get(id);
+                invariant(member->hasRecordId());
+                invariant(member->hasObj());
+
+                // The child may advance its cursor past this document before the batch is deleted.
+                member->makeObjOwnedIfNeeded();
+                _batch.push_back(id);
+                if (_batch.size() < _maxBatchSize) {
+                    return PlanStage::NEED_TIME;
+                }
+                break;
+            }
+
+            case PlanStage::IS_EOF:
+                if (_batch.empty()) {
+                    return status;
+                }
+                break;
+
+            case PlanStage::FAILURE:
+            case PlanStage::DEAD:
+                invariant(WorkingSet::INVALID_ID != id);
+                *out = id;
+                return status;
+
+            case PlanStage::NEED_TIME:
+                return status;
+
+            case PlanStage::NEED_YIELD:
+                // The members in '_batch' survive the yield. They are checked against the latest
+                // version of their documents when the batch is deleted.
+                *out = id;
+                return status;
+
+            default:
+                MONGO_UNREACHABLE;
+        }
+
+        _batchReady = true;
+    }
+
+    return deleteBatch(out);
+}
+
+PlanStage::StageState DeleteStage::deleteBatch(WorkingSetID* out) {
+    invariant(!_batch.empty());
+
+    // Deleting in RecordId order walks the record store sequentially, and puts any RecordId our
+    // child returned twice next to its duplicate.
+    std::sort(_batch.begin(), _batch.end(), [this](WorkingSetID lhs, WorkingSetID rhs) {
+        return _ws->get(lhs)->recordId < _ws->get(rhs)->recordId;
+    });
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    size_t docsDeleted = 0;
+    try {
+        boost::optional<WriteUnitOfWork> wunit;
+        if (!_params.isExplain) {
+            wunit.emplace(getOpCtx());
+        }
+
+        std::vector<RecordId> locs;
+        const RecordId* lastRecordId = nullptr;
+        for (auto id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            if (lastRecordId && *lastRecordId == member->recordId) {
+                continue;
+            }
+            lastRecordId = &member->recordId;
+
+            // The document may have changed during a yield, or while earlier batches were deleted.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            locs.push_back(member->recordId);
+        }
+        docsDeleted = locs.size();
+
+        if (!_params.isExplain && !locs.empty()) {
+            // Reserve the optimes of the batch before any of its writes, so that each delete can
+            // be timestamped with the optime of its oplog entry.
+            auto oplogSlots = reserveOplogSlots(getOpCtx(), _collection, locs.size());
+            _collection->deleteDocuments(getOpCtx(),
+                                         _params.stmtId,
+                                         locs,
+                                         oplogSlots,
+                                         _params.opDebug,
+                                         _params.fromMigrate,
+                                         false);
+        }
+
+        if (wunit) {
+            wunit->commit();
+        }
+    } catch (const WriteConflictException&) {
+        // Nothing in the batch was deleted. Keep it around so we can retry deleting it.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    _specificStats.docsDeleted += docsDeleted;
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+    _batchReady = false;
+
+    // Restore the child outside of the WriteUnitOfWork, see doWork().
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The batch was already committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
@@ -82,6 +84,10 @@ struct DeleteStageParams {
  * document was requested to be returned, then ADVANCED is returned after deleting a document.
  * Otherwise, NEED_TIME is returned after deleting a document.
  *
+ * A multi-delete which does not write to the oplog buffers up to 'internalDeleteMaxBatchSize'
+ * documents from its child and deletes them in a single WriteUnitOfWork, returning NEED_TIME while
+ * the batch fills up.
+ *
  * Callers of work() must be holding a write lock (and, for replicated deletes, callers must have
  * had the replication coordinator approve the write).
  */
@@ -124,6 +130,21 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Does the work for a multi-delete which deletes its documents in batches. Adds the documents
+     * returned by our child to '_batch' and deletes them once the batch is full or the child is
+     * EOF.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
+    /**
+     * Deletes every document in '_batch' which still exists and matches the predicate, within a
+     * single WriteUnitOfWork and with one call to Collection::deleteDocuments(). If the
+     * WriteUnitOfWork throws a WriteConflictException, keeps the batch so that it is retried in
+     * full and returns NEED_YIELD.
+     */
+    StageState deleteBatch(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -140,6 +161,16 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The most documents deleted in one WriteUnitOfWork. Deletes are not batched if this is 1.
+    const size_t _maxBatchSize;
+
+    // Members returned by our child which have not been deleted yet, when deleting in batches.
+    std::vector<WorkingSetID> _batch;
+
+    // Whether '_batch' is complete, so that the next call to work() should delete it rather than
+    // asking our child for more documents.
+    bool _batchReady = false;
+
     // Stats
     DeleteStats _specificStats;
 };
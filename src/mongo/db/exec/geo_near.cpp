@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/geo_near.h"
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -268,6 +269,39 @@ static R2Annulus twoDDistanceBounds(const GeoNearParams& nearParams,
     return fullBounds;
 }
 
+// The number of documents we aim to return from each search annulus.
+static const double kTargetResultsPerInterval = 450;
+
+// How much the width of consecutive search annuli may grow or shrink by.
+static const double kMaxBoundsIncrementChange = 8;
+
+/**
+ * Returns the width of the next search annulus, sized so that at the density of results seen in
+ * 'lastBounds' it should hold about kTargetResultsPerInterval documents. Annuli in empty or
+ * sparse regions grow quickly, and ones in dense regions shrink, instead of doubling or halving
+ * one interval at a time.
+ *
+ * The density is taken over the planar area of the annulus, which is close enough for sizing the
+ * next interval and never affects correctness.
+ */
+static double nextBoundsIncrement(const R2Annulus& lastBounds,
+                                  const IntervalStats& lastIntervalStats,
+                                  double boundsIncrement) {
+    const double inner = std::max(0.0, lastBounds.getInner());
+    const double outer = lastBounds.getOuter();
+    const double area = M_PI * (outer * outer - inner * inner);
+
+    double increment = boundsIncrement * kMaxBoundsIncrementChange;
+    if (lastIntervalStats.numResultsReturned > 0 && area > 0) {
+        const double density = lastIntervalStats.numResultsReturned / area;
+        increment =
+            std::sqrt(outer * outer + kTargetResultsPerInterval / (M_PI * density)) - outer;
+    }
+
+    return std::min(boundsIncrement * kMaxBoundsIncrementChange,
+                    std::max(boundsIncrement / kMaxBoundsIncrementChange, increment));
+}
+
 class GeoNear2DStage::DensityEstimator {
 public:
     DensityEstimator(PlanStage::Children* children,
@@ -607,13 +641,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextBoundsIncrement(
+            _currBounds, _specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     _boundsIncrement =
@@ -1030,13 +1059,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextBoundsIncrement(
+            _currBounds, _specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -34,8 +34,10 @@
 
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -122,7 +124,8 @@ PlanStage::StageState NearStage::doWork(WorkingSetID* out) {
  * Holds a generic search result with a distance computed in some fashion.
  */
 struct NearStage::SearchResult {
-    SearchResult(WorkingSetID resultID, double distance) : resultID(resultID), distance(distance) {}
+    SearchResult(WorkingSetID resultID, double distance, size_t memUsage)
+        : resultID(resultID), distance(distance), memUsage(memUsage) {}
 
     bool operator<(const SearchResult& other) const {
         // We want increasing distance, not decreasing, so we reverse the <
@@ -131,6 +134,7 @@ struct NearStage::SearchResult {
 
     WorkingSetID resultID;
     double distance;
+    size_t memUsage;
 };
 
 // Set "toReturn" when NEED_YIELD.
@@ -210,13 +214,25 @@ PlanStage::StageState NearStage::bufferNext(WorkingSetID* toReturn, Status* erro
 
     // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
     nextMember->makeObjOwnedIfNeeded();
-    _resultBuffer.push(SearchResult(nextMemberID, memberDistance));
+    const size_t memUsage = nextMember->getMemUsage();
+    _resultBuffer.push(SearchResult(nextMemberID, memberDistance, memUsage));
+    _bufferedBytes += memUsage;
 
     // Store the member's RecordId, if available, for deduping.
     if (nextMember->hasRecordId()) {
         _seenDocuments.insert(std::make_pair(nextMember->recordId, nextMemberID));
     }
 
+    const size_t maxBytes = static_cast<size_t>(internalQueryGeoNearMaxBufferedBytes.load());
+    if (_bufferedBytes > maxBytes) {
+        _searchState = SearchState_Finished;
+        *error = Status(ErrorCodes::OperationFailed,
+                        str::stream() << "Near search buffered more than the maximum " << maxBytes
+                                      << " bytes of RAM. Specify a smaller maximum distance, or a "
+                                         "more selective query.");
+        return PlanStage::FAILURE;
+    }
+
     return PlanStage::NEED_TIME;
 }
 
@@ -240,6 +256,7 @@ PlanStage::StageState NearStage::advanceNext(WorkingSetID* toReturn) {
                 _seenDocuments.erase(member->recordId);
             }
             _resultBuffer.pop();
+            _bufferedBytes -= result.memUsage;
             _workingSet->free(result.resultID);
             return PlanStage::NEED_TIME;
         }
@@ -264,6 +281,7 @@ PlanStage::StageState NearStage::advanceNext(WorkingSetID* toReturn) {
     }
 
     // The next document in _resultBuffer is in the search interval, so we can return it.
+    _bufferedBytes -= _resultBuffer.top().memUsage;
     _resultBuffer.pop();
 
     *toReturn = resultID;
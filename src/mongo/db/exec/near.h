@@ -85,6 +85,9 @@ namespace mongo {
  * deduplicate. Every document in _resultBuffer is kept track of in _seenDocuments. When a document
  * is returned, it is removed from _seenDocuments.
  *
+ * The memory used by the buffered documents is capped at internalQueryGeoNearMaxBufferedBytes. A
+ * search which needs to buffer more than that at once fails rather than growing without bound.
+ *
  * TODO: Right now the interface allows the nextCovering() to be adaptive, but doesn't allow
  * aborting and shrinking a covered range being buffered if we guess wrong.
  */
@@ -184,6 +187,9 @@ private:
     struct SearchResult;
     std::priority_queue<SearchResult> _resultBuffer;
 
+    // Memory used by the documents in _resultBuffer.
+    size_t _bufferedBytes = 0;
+
     // Stats
     const StageType _stageType;
 
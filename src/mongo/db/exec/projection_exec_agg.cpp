@@ -35,8 +35,16 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
+namespace {
+// The maximum number of field paths whose projection result is remembered by each executor. The
+// paths seen by a given index are bounded by the query shapes run against it, so in practice the
+// memo rarely fills; if it does, it is simply emptied and repopulated.
+constexpr size_t kMaxMemoizedFields = 1024;
+}  // namespace
 
 class ProjectionExecAgg::ProjectionExecutor {
 public:
@@ -106,11 +114,24 @@ public:
     }
 
     bool applyProjectionToOneField(StringData field) const {
-        MutableDocument doc;
-        const FieldPath f{field};
-        doc.setNestedField(f, Value(1.0));
-        const Document transformedDoc = applyTransformation(doc.freeze());
-        return !transformedDoc.getNestedField(f).missing();
+        // The planner asks the same questions about the same paths for every query of a given
+        // shape, so the answers are memoized rather than projecting a dummy document each time.
+        {
+            stdx::lock_guard<stdx::mutex> lk(_fieldMemoMutex);
+            auto it = _fieldMemo.find(field.toString());
+            if (it != _fieldMemo.end()) {
+                return it->second;
+            }
+        }
+
+        const bool isIncluded = _applyProjectionToOneFieldUncached(field);
+
+        stdx::lock_guard<stdx::mutex> lk(_fieldMemoMutex);
+        if (_fieldMemo.size() >= kMaxMemoizedFields) {
+            _fieldMemo.clear();
+        }
+        _fieldMemo.emplace(field.toString(), isIncluded);
+        return isIncluded;
     }
 
     stdx::unordered_set<std::string> applyProjectionToFields(
@@ -127,12 +148,25 @@ public:
     }
 
 private:
+    bool _applyProjectionToOneFieldUncached(StringData field) const {
+        MutableDocument doc;
+        const FieldPath f{field};
+        doc.setNestedField(f, Value(1.0));
+        const Document transformedDoc = applyTransformation(doc.freeze());
+        return !transformedDoc.getNestedField(f).missing();
+    }
+
     Document applyTransformation(Document inputDoc) const {
         return _projection->applyTransformation(inputDoc);
     }
 
     std::unique_ptr<ParsedAggregationProjection> _projection;
     std::set<FieldRef> _exhaustivePaths;
+
+    // Memo of applyProjectionToOneField() results, keyed by field path. The executor is shared by
+    // all operations using the index, so access is serialized.
+    mutable stdx::mutex _fieldMemoMutex;
+    mutable stdx::unordered_map<std::string, bool> _fieldMemo;
 };
 
 // ProjectionExecAgg's constructor and destructor are defined here, at a point where the
@@ -319,5 +319,24 @@ TEST(ProjectionExecAggTests, ExclusionFieldPathsWithExplicitIdExclusionIdOnly) {
     ASSERT(exhaustivePaths.empty());
 }
 
+TEST(ProjectionExecAggTests, RepeatedFieldProjectionsReturnConsistentResults) {
+    auto parsedProject = makeProjectionWithDefaultIdExclusionAndNestedArrayRecursion(
+        fromjson("{a: {b: 1}, c: 1}"));
+
+    // Ask about each path more than once, so that later answers are served from the memo.
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(parsedProject->applyProjectionToOneField("a.b"));
+        ASSERT_TRUE(parsedProject->applyProjectionToOneField("a.b.c"));
+        ASSERT_TRUE(parsedProject->applyProjectionToOneField("c"));
+        ASSERT_FALSE(parsedProject->applyProjectionToOneField("a.d"));
+        ASSERT_FALSE(parsedProject->applyProjectionToOneField("_id"));
+
+        auto projectedFields = parsedProject->applyProjectionToFields({"a.b", "a.d", "c", "e"});
+        ASSERT_EQ(projectedFields.size(), 2u);
+        ASSERT_EQ(projectedFields.count("a.b"), 1u);
+        ASSERT_EQ(projectedFields.count("c"), 1u);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
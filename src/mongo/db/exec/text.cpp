@@ -126,6 +126,18 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
 
         textScorer->addChildren(std::move(indexScanList));
 
+        // The TEXT_MATCH stage can only drop documents if the query has negations or phrases, or
+        // has to check the positive terms again because it is case or diacritic sensitive. If it
+        // can't, the top-k documents by score are all our parent needs.
+        const auto& query = _params.query;
+        const auto& terms = query.getTermsForBounds();
+        if (_params.topK > 0 && !terms.empty() && terms.size() <= 64 &&
+            query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+            query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+            !query.getDiacriticSensitive()) {
+            textScorer->setTopK(_params.topK, {terms.begin(), terms.end()});
+        }
+
         textMatchStage = make_unique<TextMatchStage>(
             opCtx, std::move(textScorer), _params.query, _params.spec, ws);
     } else {
@@ -30,7 +30,9 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -52,6 +54,7 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::MAX_WEIGHT;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -80,6 +83,18 @@ void TextOrStage::addChildren(Children childrenToAdd) {
                      std::make_move_iterator(childrenToAdd.end()));
 }
 
+void TextOrStage::setTopK(size_t limit, std::vector<std::string> terms) {
+    invariant(limit > 0);
+    invariant(terms.size() == _children.size());
+    invariant(terms.size() <= 64);
+    invariant(_internalState == State::kInit);
+
+    _topK = limit;
+    _terms = std::move(terms);
+    _termUpperBounds.assign(_terms.size(), MAX_WEIGHT);
+    _childIsEOF.assign(_terms.size(), false);
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -141,10 +156,10 @@ PlanStage::StageState TextOrStage::doWork(WorkingSetID* out) {
             stageState = initStage(out);
             break;
         case State::kReadingTerms:
-            stageState = readFromChildren(out);
+            stageState = _topK ? readFromChildrenTopK(out) : readFromChildren(out);
             break;
         case State::kReturningResults:
-            stageState = returnResults(out);
+            stageState = _topK ? returnTopKResults(out) : returnResults(out);
             break;
         case State::kDone:
             // Should have been handled above.
@@ -317,4 +332,234 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     return NEED_TIME;
 }
 
+PlanStage::StageState TextOrStage::readFromChildrenTopK(WorkingSetID* out) {
+    if (_children.size() == 0) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+    invariant(_currentChild < _children.size());
+    invariant(!_childIsEOF[_currentChild]);
+
+    WorkingSetID id;
+    StageState childState = _children[_currentChild]->work(&id);
+
+    if (PlanStage::ADVANCED == childState) {
+        addTermTopK(id);
+        if (++_entriesSinceCheck >= std::max(_scores.size(), _topK)) {
+            // Checking is linear in the number of documents seen so far, so we wait for at least
+            // that many index entries between checks.
+            _entriesSinceCheck = 0;
+            if (topKIsDetermined()) {
+                finishReadingTopK();
+                return PlanStage::NEED_TIME;
+            }
+        }
+    } else if (PlanStage::IS_EOF == childState) {
+        _childIsEOF[_currentChild] = true;
+        _termUpperBounds[_currentChild] = 0;
+
+        if (++_numChildrenEOF == _children.size()) {
+            // Every score is exact now.
+            finishReadingTopK();
+            return PlanStage::NEED_TIME;
+        }
+    } else if (PlanStage::FAILURE == childState) {
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "TEXT_OR stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        } else {
+            *out = id;
+        }
+        return PlanStage::FAILURE;
+    } else {
+        // Propagate WSID from below, and keep reading from the same child afterwards.
+        *out = id;
+        return childState;
+    }
+
+    // Move on to the next child which still has index entries.
+    do {
+        _currentChild = (_currentChild + 1) % _children.size();
+    } while (_childIsEOF[_currentChild]);
+
+    return PlanStage::NEED_TIME;
+}
+
+void TextOrStage::addTermTopK(WorkingSetID wsid) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    IndexKeyDatum& keyDatum = wsm->keyData.back();
+
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(keyDatum.keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+    keyIt.next();  // Skip past 'term'.
+    const double documentTermScore = keyIt.next().number();
+
+    // The child scans in descending score order, so no later entry can score any higher.
+    _termUpperBounds[_currentChild] =
+        std::min(_termUpperBounds[_currentChild], documentTermScore);
+
+    TextRecordData* textRecordData = &_scores[wsm->recordId];
+
+    if (textRecordData->score < 0) {
+        // We have already rejected this document.
+        invariant(WorkingSet::INVALID_ID == textRecordData->wsid);
+        _ws->free(wsid);
+        return;
+    }
+
+    if (WorkingSet::INVALID_ID == textRecordData->wsid) {
+        // We haven't seen this RecordId before.
+        if (!Filter::passes(keyDatum.keyData, keyDatum.indexKeyPattern, _filter)) {
+            _ws->free(wsid);
+            textRecordData->score = -1;
+            return;
+        }
+
+        // Keep the member so that the document can be fetched if it makes it into the top-k. The
+        // key is checked against the document when it is fetched, in case it changed during a
+        // yield, so make sure it is owned.
+        keyDatum.keyData = keyDatum.keyData.getOwned();
+        textRecordData->wsid = wsid;
+    } else {
+        invariant(wsid != textRecordData->wsid);
+        _ws->free(wsid);
+    }
+
+    textRecordData->score += documentTermScore;
+    textRecordData->termsSeen |= uint64_t(1) << _currentChild;
+}
+
+double TextOrStage::maxScore(const TextRecordData& data) const {
+    double score = data.score;
+    for (size_t i = 0; i < _termUpperBounds.size(); ++i) {
+        if (!(data.termsSeen & (uint64_t(1) << i))) {
+            score += _termUpperBounds[i];
+        }
+    }
+    return score;
+}
+
+bool TextOrStage::topKIsDetermined() {
+    std::vector<TextRecordData*> candidates;
+    for (auto&& entry : _scores) {
+        if (entry.second.score >= 0) {
+            candidates.push_back(&entry.second);
+        }
+    }
+    if (candidates.size() < _topK) {
+        return false;
+    }
+
+    // The scores are only lower bounds until every child is EOF. Find the k-th best of them.
+    auto kth = candidates.begin() + (_topK - 1);
+    std::nth_element(
+        candidates.begin(), kth, candidates.end(), [](TextRecordData* lhs, TextRecordData* rhs) {
+            return lhs->score > rhs->score;
+        });
+    const double kthScore = (*kth)->score;
+
+    // A document none of the children have returned yet could score up to the sum of the bounds.
+    const double unseenMaxScore =
+        std::accumulate(_termUpperBounds.begin(), _termUpperBounds.end(), 0.0);
+    if (unseenMaxScore > kthScore) {
+        return false;
+    }
+
+    bool determined = true;
+    for (auto it = kth + 1; it != candidates.end(); ++it) {
+        TextRecordData* data = *it;
+        const double upperBound = maxScore(*data);
+        if (upperBound > kthScore) {
+            determined = false;
+        } else if (upperBound < kthScore) {
+            // This document can never make it into the top-k.
+            _ws->free(data->wsid);
+            data->wsid = WorkingSet::INVALID_ID;
+            data->score = -1;
+        }
+    }
+    return determined;
+}
+
+void TextOrStage::finishReadingTopK() {
+    std::vector<TextRecordData*> candidates;
+    for (auto&& entry : _scores) {
+        if (entry.second.score >= 0) {
+            candidates.push_back(&entry.second);
+        }
+    }
+
+    if (candidates.size() > _topK) {
+        std::nth_element(candidates.begin(),
+                         candidates.begin() + (_topK - 1),
+                         candidates.end(),
+                         [](TextRecordData* lhs, TextRecordData* rhs) {
+                             return lhs->score > rhs->score;
+                         });
+        for (auto it = candidates.begin() + _topK; it != candidates.end(); ++it) {
+            _ws->free((*it)->wsid);
+        }
+        candidates.resize(_topK);
+    }
+
+    for (auto data : candidates) {
+        _topKResults.push_back(data->wsid);
+    }
+
+    _scores.clear();
+    _internalState = State::kReturningResults;
+}
+
+PlanStage::StageState TextOrStage::returnTopKResults(WorkingSetID* out) {
+    if (_topKResults.empty()) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+
+    const WorkingSetID wsid = _topKResults.back();
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
+            _topKResults.pop_back();
+            _ws->free(wsid);
+            return PlanStage::NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        // Leave the member at the back of '_topKResults' so we retry fetching it.
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+    _topKResults.pop_back();
+
+    WorkingSetMember* wsm = _ws->get(wsid);
+    wsm->makeObjOwnedIfNeeded();
+
+    // The score accumulated from the index may be missing terms which were not read, so compute
+    // the score from the document.
+    wsm->addComputed(new TextScoreComputedData(computeScore(wsm->obj.value())));
+    *out = wsid;
+    return PlanStage::ADVANCED;
+}
+
+double TextOrStage::computeScore(const BSONObj& obj) const {
+    fts::TermFrequencyMap termFrequencies;
+    _ftsSpec.scoreDocument(obj, &termFrequencies);
+
+    double score = 0;
+    for (auto&& term : _terms) {
+        auto it = termFrequencies.find(term);
+        if (it != termFrequencies.end()) {
+            score += it->second;
+        }
+    }
+    return score;
+}
+
 }  // namespace mongo
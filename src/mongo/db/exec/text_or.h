@@ -31,6 +31,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -50,6 +52,11 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If setTopK() is called, only the documents with the highest scores are returned. Each child scans
+ * the index entries for one term in descending score order, so the last score read from a child
+ * bounds the score of that term in any document not yet seen by the child. The children are read
+ * in turn until these bounds show that no other document can beat the best documents found so far.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -81,6 +88,13 @@ public:
 
     void addChildren(Children childrenToAdd);
 
+    /**
+     * Makes this stage return only the 'limit' documents with the highest text scores, in no
+     * particular order. 'terms' are the query terms, in the order of the children which scan them.
+     * Must be called before the first call to work().
+     */
+    void setTopK(size_t limit, std::vector<std::string> terms);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -124,6 +138,41 @@ private:
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Worker for kReadingTerms in top-k mode. Reads from each child in turn, rather than exhausting
+     * one child before moving on to the next, and stops once the top-k documents are known.
+     */
+    StageState readFromChildrenTopK(WorkingSetID* out);
+
+    /**
+     * Helper called from readFromChildrenTopK to add the (term, score) pair in 'wsid' to the lower
+     * bound on the score of its document, and to lower the bound on the current child's term.
+     */
+    void addTermTopK(WorkingSetID wsid);
+
+    /**
+     * Returns true if no document outside of the '_topK' documents with the highest scores so far
+     * can end up with a higher score. Drops documents which can no longer make it into the top-k.
+     */
+    bool topKIsDetermined();
+
+    /**
+     * Keeps the '_topK' documents with the highest scores in '_topKResults' and frees the rest.
+     */
+    void finishReadingTopK();
+
+    /**
+     * Worker for kReturningResults in top-k mode. Fetches each of '_topKResults' and computes its
+     * score from the document.
+     */
+    StageState returnTopKResults(WorkingSetID* out);
+
+    /**
+     * Returns the text score of 'obj' for the query terms. This is the same score as the sum of
+     * the scores in its index entries for each term, added in the order of the children.
+     */
+    double computeScore(const BSONObj& obj) const;
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -142,15 +191,43 @@ private:
      *  Map each buffered record id to this data.
      */
     struct TextRecordData {
-        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
+        TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0), termsSeen(0) {}
         WorkingSetID wsid;
         double score;
+
+        // In top-k mode, bit i is set once child i has returned this document.
+        uint64_t termsSeen;
     };
 
+    /**
+     * Returns the highest score the document for 'data' can end up with in top-k mode.
+     */
+    double maxScore(const TextRecordData& data) const;
+
     typedef stdx::unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // The number of documents to return in top-k mode, or 0 to return all of them.
+    size_t _topK = 0;
+
+    // The query term scanned by each child. Only used in top-k mode.
+    std::vector<std::string> _terms;
+
+    // For each child, the highest score the child's term can have in a document it has not
+    // returned yet. This is 0 once the child is EOF.
+    std::vector<double> _termUpperBounds;
+
+    // Which children are EOF, in top-k mode.
+    std::vector<bool> _childIsEOF;
+    size_t _numChildrenEOF = 0;
+
+    // The number of index entries read since topKIsDetermined() was last called.
+    size_t _entriesSinceCheck = 0;
+
+    // The members for the top-k documents, which have not been fetched or returned yet.
+    std::vector<WorkingSetID> _topKResults;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -129,6 +129,8 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     // Append count of samples - uint32 little endian
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
+    const bool deltaOfDelta = _config->deltaOfDeltaEncoding;
+
     if (_metricsCount != 0 && _deltaCount != 0) {
         // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
         DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
@@ -141,6 +143,8 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // 1. Delta Compression
         //   - i.e., we store the difference between pairs of samples, not their absolute values
         //   - this is done in addSamples
+        //   - for kMetricChunkV2, we store the zig-zag encoded difference between pairs of deltas
+        //     instead, this is done here so interim chunks leave _deltas untouched
         // 2. Run Length Encoding of zeros
         //   - We find consecutive sets of zeros and represent them as a tuple of (0, count - 1).
         //   - Each memeber is stored as VarInt packed integer
@@ -149,9 +153,17 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // These byte arrays are added to a buffer which is then concatenated with other chunks and
         // compressed with ZLIB.
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
+            std::uint64_t prevDelta = 0;
+
             for (std::uint32_t j = 0; j < _deltaCount; j++) {
                 std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
 
+                if (deltaOfDelta) {
+                    std::uint64_t deltaOfDeltas = zigZagEncode(delta - prevDelta);
+                    prevDelta = delta;
+                    delta = deltaOfDeltas;
+                }
+
                 if (delta == 0) {
                     ++zeroesCount;
                     continue;
@@ -209,6 +221,9 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
 
     _compressedChunkBuffer.setlen(0);
 
+    _compressedChunkType = deltaOfDelta ? FTDCBSONUtil::FTDCType::kMetricChunkV2
+                                        : FTDCBSONUtil::FTDCType::kMetricChunk;
+
     _compressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_uncompressedChunkBuffer.len()));
 
     _compressedChunkBuffer.appendBuf(swDest.getValue().data(), swDest.getValue().length());
@@ -41,6 +41,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/ftdc/block_compressor.h"
 #include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 
 namespace mongo {
@@ -54,9 +55,12 @@ namespace mongo {
  * 1. For each document after the first, it computes the delta between it and the preceding document
  *    for the number fields
  * 2. It stores the deltas into an array of std::int64_t.
- * 3. It compressed each std::int64_t using VarInt integer compression. See varint.h.
- * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
- * 5. ZLIB compresses the final processed array
+ * 3. If delta-of-delta encoding is enabled (FTDCType::kMetricChunkV2), it replaces each delta with
+ *    its difference from the previous delta of the same metric, zig-zag encoded. Counters which
+ *    grow at a steady rate then produce runs of zeros rather than runs of the same delta.
+ * 4. It compressed each std::int64_t using VarInt integer compression. See varint.h.
+ * 5. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
+ * 6. ZLIB compresses the final processed array
  *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
@@ -129,6 +133,14 @@ public:
      */
     StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples();
 
+    /**
+     * Returns the type of metric chunk document the buffer last returned by addSample() or
+     * getCompressedSamples() must be stored in.
+     */
+    FTDCBSONUtil::FTDCType getCompressedChunkType() const {
+        return _compressedChunkType;
+    }
+
     /**
      * Reset the state of the compressor.
      *
@@ -145,6 +157,18 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * Map a two's complement difference onto an unsigned integer so that small negative values,
+     * like small positive ones, encode to short VarInts: 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4...
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value) {
+        return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+    }
+
+    static std::uint64_t zigZagDecode(std::uint64_t value) {
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
 private:
     /**
      * Reset the state
@@ -184,6 +208,9 @@ private:
     // Buffer for uncompressed metric chunk
     BufBuilder _uncompressedChunkBuffer;
 
+    // Type of the chunk in _compressedChunkBuffer
+    FTDCBSONUtil::FTDCType _compressedChunkType{FTDCBSONUtil::FTDCType::kMetricChunk};
+
     // Buffer to hold metrics
     std::vector<std::uint64_t> _metrics;
     std::vector<std::uint64_t> _prevmetrics;
@@ -129,8 +129,11 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            bool deltaOfDelta = FTDCConfig::kDeltaOfDeltaEncodingDefault)
+        : _compressor(&_config), _mode(mode) {
+        _config.deltaOfDeltaEncoding = deltaOfDelta;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -162,13 +165,14 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = _decompressor.uncompress(cdr.get(), _compressor.getCompressedChunkType());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()),
+                                               _compressor.getCompressedChunkType());
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -570,9 +574,9 @@ TEST_F(FTDCCompressorTest, Types) {
 
 // Test a full buffer
 TEST_F(FTDCCompressorTest, TestFull) {
-    // Test a large numbers of zeros, and incremental numbers in a full buffer
-    for (int j = 0; j < 2; j++) {
-        TestTie c;
+    // Test a large numbers of zeros, and incremental numbers in a full buffer, in both encodings
+    for (int j = 0; j < 4; j++) {
+        TestTie c(FTDCValidationMode::kStrict, j >= 2);
 
         auto st = c.addSample(BSON("name"
                                    << "joe"
@@ -586,7 +590,7 @@ TEST_F(FTDCCompressorTest, TestFull) {
             st = c.addSample(BSON("name"
                                   << "joe"
                                   << "key1"
-                                  << static_cast<long long int>(i * j)
+                                  << static_cast<long long int>(i * (j % 2))
                                   << "key2"
                                   << 45));
             ASSERT_HAS_SPACE(st);
@@ -630,9 +634,9 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     std::uniform_int_distribution<long long> genValues(1, std::numeric_limits<long long>::max());
     const size_t metrics = 1000;
 
-    // Test a large numbers of zeros, and incremental numbers in a full buffer
+    // Test a large numbers of zeros, and incremental numbers in a full buffer, in both encodings
     for (int j = 0; j < 2; j++) {
-        TestTie c;
+        TestTie c(FTDCValidationMode::kStrict, j == 1);
 
         auto st = c.addSample(generateSample(rd, genValues, metrics));
         ASSERT_HAS_SPACE(st);
@@ -651,4 +655,68 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test the delta-of-delta encoding around its edges: counters, gauges which move in both
+// directions, and deltas which overflow when subtracted from each other.
+TEST_F(FTDCCompressorTest, TestDeltaOfDelta) {
+    TestTie c(FTDCValidationMode::kStrict, true);
+
+    const long long kMax = std::numeric_limits<long long>::max();
+    const long long kMin = std::numeric_limits<long long>::min();
+
+    auto makeSample = [](long long counter, long long gauge, long long extreme) {
+        return BSON("counter" << counter << "gauge" << gauge << "extreme" << extreme
+                              << "zero"
+                              << 0);
+    };
+
+    auto st = c.addSample(makeSample(0, 0, 0));
+    ASSERT_HAS_SPACE(st);
+
+    for (long long i = 1; i < 50; i++) {
+        st = c.addSample(makeSample(i * 1000, (i % 3) * -7 + (i % 5) * 11, (i % 2) ? kMax : kMin));
+        ASSERT_HAS_SPACE(st);
+    }
+}
+
+// Delta-of-delta encoding must make chunks of steadily growing counters smaller than plain deltas.
+TEST_F(FTDCCompressorTest, TestDeltaOfDeltaIsSmallerForCounters) {
+    const size_t metrics = 200;
+
+    auto makeSample = [&](long long i) {
+        BSONObjBuilder builder;
+        for (size_t m = 0; m < metrics; ++m) {
+            builder.append("key", i * static_cast<long long>(m * 37 + 1));
+        }
+        return builder.obj();
+    };
+
+    auto compressedSize = [&](bool deltaOfDelta) {
+        FTDCConfig config;
+        config.deltaOfDeltaEncoding = deltaOfDelta;
+        FTDCCompressor compressor(&config);
+
+        for (long long i = 0; i < 100; ++i) {
+            auto st = compressor.addSample(makeSample(i), Date_t());
+            ASSERT_HAS_SPACE(st);
+        }
+
+        auto swBuf = compressor.getCompressedSamples();
+        ASSERT_OK(swBuf.getStatus());
+        ASSERT_TRUE(compressor.getCompressedChunkType() ==
+                    (deltaOfDelta ? FTDCBSONUtil::FTDCType::kMetricChunkV2
+                                  : FTDCBSONUtil::FTDCType::kMetricChunk));
+
+        FTDCDecompressor decompressor;
+        auto swDocs = decompressor.uncompress(std::get<0>(swBuf.getValue()),
+                                              compressor.getCompressedChunkType());
+        ASSERT_OK(swDocs.getStatus());
+        ASSERT_EQ(100U, swDocs.getValue().size());
+        ASSERT_BSONOBJ_EQ(makeSample(99), swDocs.getValue().back());
+
+        return std::get<0>(swBuf.getValue()).length();
+    };
+
+    ASSERT_LT(compressedSize(true), compressedSize(false));
+}
+
 }  // namespace mongo
@@ -48,7 +48,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          deltaOfDeltaEncoding(kDeltaOfDeltaEncodingDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -85,6 +86,12 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Write metric chunks with delta-of-delta encoding. When false, metric chunks are written in
+     * the original delta encoded format which older versions can read.
+     */
+    bool deltaOfDeltaEncoding;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -95,6 +102,10 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    // Off by default: readers which predate kMetricChunkV2, including this server after a
+    // downgrade, cannot decode it.
+    static const bool kDeltaOfDeltaEncodingDefault = false;
 };
 
 }  // namespace mongo
@@ -94,6 +94,12 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setDeltaOfDeltaEncoding(bool enabled) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.deltaOfDeltaEncoding = enabled;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
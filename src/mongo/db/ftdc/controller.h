@@ -100,6 +100,11 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set whether new metric chunks are written with delta-of-delta encoding.
+     */
+    void setDeltaOfDeltaEncoding(bool enabled);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
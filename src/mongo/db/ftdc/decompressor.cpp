@@ -32,6 +32,8 @@
 
 #include "mongo/db/ftdc/decompressor.h"
 
+#include <algorithm>
+
 #include "mongo/base/data_range_cursor.h"
 #include "mongo/base/data_type_validated.h"
 #include "mongo/db/ftdc/compressor.h"
@@ -43,7 +45,13 @@
 
 namespace mongo {
 
-StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf,
+                                                               FTDCBSONUtil::FTDCType type) {
+    if (type != FTDCBSONUtil::FTDCType::kMetricChunk &&
+        type != FTDCBSONUtil::FTDCType::kMetricChunkV2) {
+        return Status(ErrorCodes::BadValue, "Not a metric chunk type");
+    }
+
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -124,50 +132,55 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
     }
 
     // Read the samples
-    std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
-
-    // decompress the deltas
-    std::uint64_t zeroesCount = 0;
+    const std::size_t valuesCount = metricsCount * sampleCount;
+    std::vector<std::uint64_t> deltas(valuesCount);
 
+    // Decompress the deltas. The values of all metrics are stored back to back in the same order
+    // as 'deltas', and runs of zeros may span metrics, so this is a single pass over the array.
+    // 'deltas' starts zeroed, so a run of zeros only needs to be skipped over.
     auto cdrc = ConstDataRangeCursor(cdc);
 
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 0; j < sampleCount; j++) {
-            if (zeroesCount) {
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = 0;
-                zeroesCount--;
-                continue;
-            }
-
-            auto swDelta = cdrc.readAndAdvance<FTDCVarInt>();
+    for (std::size_t pos = 0; pos < valuesCount;) {
+        auto swDelta = cdrc.readAndAdvance<FTDCVarInt>();
 
-            if (!swDelta.isOK()) {
-                return swDelta.getStatus();
-            }
-
-            if (swDelta.getValue() == 0) {
-                auto swZero = cdrc.readAndAdvance<FTDCVarInt>();
+        if (!swDelta.isOK()) {
+            return swDelta.getStatus();
+        }
 
-                if (!swZero.isOK()) {
-                    return swDelta.getStatus();
-                }
+        if (swDelta.getValue() != 0) {
+            deltas[pos++] = swDelta.getValue();
+            continue;
+        }
 
-                zeroesCount = swZero.getValue();
-            }
+        auto swZero = cdrc.readAndAdvance<FTDCVarInt>();
 
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] = swDelta.getValue();
+        if (!swZero.isOK()) {
+            return swZero.getStatus();
         }
+
+        // The run is stored as its length minus one. A corrupt length must not skip past the end.
+        std::uint64_t zeroes = swZero.getValue();
+        pos += std::min<std::uint64_t>(zeroes, valuesCount - pos - 1) + 1;
     }
 
     // Inflate the deltas
-    for (std::uint32_t i = 0; i < metricsCount; i++) {
-        deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
-    }
+    const bool deltaOfDelta = type == FTDCBSONUtil::FTDCType::kMetricChunkV2;
 
     for (std::uint32_t i = 0; i < metricsCount; i++) {
-        for (std::uint32_t j = 1; j < sampleCount; j++) {
-            deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)] +=
-                deltas[FTDCCompressor::getArrayOffset(sampleCount, j - 1, i)];
+        std::uint64_t value = metrics[i];
+        std::uint64_t delta = 0;
+
+        for (std::uint32_t j = 0; j < sampleCount; j++) {
+            auto& sample = deltas[FTDCCompressor::getArrayOffset(sampleCount, j, i)];
+
+            if (deltaOfDelta) {
+                delta += FTDCCompressor::zigZagDecode(sample);
+            } else {
+                delta = sample;
+            }
+
+            value += delta;
+            sample = value;
         }
     }
 
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "mongo/base/data_range.h"
@@ -40,6 +41,10 @@
 
 namespace mongo {
 
+namespace FTDCBSONUtil {
+enum class FTDCType : std::int32_t;
+}  // namespace FTDCBSONUtil
+
 /**
  * Inflates a compressed chunk of metrics into a list of BSON documents
  */
@@ -50,13 +55,15 @@ public:
     FTDCDecompressor() = default;
 
     /**
-     * Inflates a compressed chunk of metrics into a vector of owned BSON documents.
+     * Inflates a compressed chunk of metrics into a vector of owned BSON documents. 'type' is the
+     * type of the metric chunk document the chunk was stored in, which determines how the samples
+     * were encoded.
      *
      * Will fail if the chunk is corrupt or too short.
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
      */
-    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
+    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf, FTDCBSONUtil::FTDCType type);
 
 private:
     BlockCompressor _compressor;
@@ -243,6 +243,28 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicBool localDeltaOfDeltaEncoding(FTDCConfig::kDeltaOfDeltaEncodingDefault);
+
+class ExportedFTDCDeltaOfDeltaEncodingParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCDeltaOfDeltaEncodingParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionDeltaOfDeltaEncoding",
+              &localDeltaOfDeltaEncoding) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setDeltaOfDeltaEncoding(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCDeltaOfDeltaEncodingParameter;
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -280,6 +302,7 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.deltaOfDeltaEncoding = localDeltaOfDeltaEncoding.load();
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
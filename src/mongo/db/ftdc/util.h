@@ -64,6 +64,18 @@ enum class FTDCType : std::int32_t {
     * See createBSONMetricChunkDocument
     */
     kMetricChunk = 1,
+
+    /**
+    * A metrics chunk laid out like kMetricChunk, except the samples of each metric are stored as
+    * zig-zag encoded deltas of deltas rather than as deltas.
+    *
+    * Type 2 is upstream's periodic metadata document and the values just above it are reserved
+    * for upstream's future types, since diagnostic.data files are read by tools and servers built
+    * from other trees. Types added here are taken from the top of the range instead.
+    *
+    * See FTDCCompressor
+    */
+    kMetricChunkV2 = 100,
 };
 
 
@@ -148,7 +160,9 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "data" : BinData(...)
  * }
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t now,
+                                      FTDCType type = FTDCType::kMetricChunk);
 
 /**
  * Get the _id field of a BSON document
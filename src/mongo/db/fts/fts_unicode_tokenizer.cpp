@@ -37,6 +37,7 @@
 #include "mongo/db/fts/stemmer.h"
 #include "mongo/db/fts/stop_words.h"
 #include "mongo/db/fts/tokenizer.h"
+#include "mongo/db/fts/unicode/byte_vector.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stringutils.h"
@@ -46,6 +47,29 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+bool isAscii(StringData str) {
+    const char* it = str.rawData();
+    const char* const end = it + str.size();
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    using unicode::ByteVector;
+    for (; end - it >= ByteVector::size; it += ByteVector::size) {
+        if (ByteVector::load(it).maskHigh()) {
+            return false;
+        }
+    }
+#endif
+    for (; it != end; ++it) {
+        if (static_cast<unsigned char>(*it) > 0x7f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
     : _language(language),
       _stemmer(language),
@@ -59,7 +83,13 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
-    _document.resetData(document);  // Validates that document is valid UTF8.
+    _isAscii = isAscii(document);
+    if (_isAscii) {
+        _asciiDocument = document;
+    } else {
+        _asciiDocument = StringData();
+        _document.resetData(document);  // Validates that document is valid UTF8.
+    }
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
     _skipDelimiters();
@@ -67,16 +97,21 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 
 bool UnicodeFTSTokenizer::moveNext() {
     while (true) {
-        if (_pos >= _document.size()) {
+        const size_t size = _isAscii ? _asciiDocument.size() : _document.size();
+        if (_pos >= size) {
             _word = "";
             return false;
         }
 
         // Traverse through non-delimiters and build the next token.
         size_t start = _pos++;
-        while (_pos < _document.size() &&
-               (!unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage))) {
-            ++_pos;
+        if (_isAscii) {
+            _pos = _asciiTokenEnd(_pos);
+        } else {
+            while (_pos < size &&
+                   (!unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage))) {
+                ++_pos;
+            }
         }
         const size_t len = _pos - start;
 
@@ -85,14 +120,24 @@ bool UnicodeFTSTokenizer::moveNext() {
 
         // Stop words are case-sensitive and diacritic sensitive, so we need them to be lower cased
         // but with diacritics not removed to check against the stop word list.
-        _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        if (_isAscii) {
+            // Lower casing ASCII may still produce other code points, e.g. for 'I' in Turkish.
+            _word = unicode::String::caseFoldAndStripDiacritics(
+                &_wordBuf,
+                _asciiDocument.substr(start, len),
+                unicode::String::kDiacriticSensitive,
+                _caseFoldMode);
+        } else {
+            _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        }
 
         if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
             continue;
         }
 
         if (_options & kGenerateCaseSensitiveTokens) {
-            _word = _document.substrToBuf(&_wordBuf, start, len);
+            _word = _isAscii ? _asciiDocument.substr(start, len)
+                             : _document.substrToBuf(&_wordBuf, start, len);
         }
 
         // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
@@ -113,11 +158,46 @@ StringData UnicodeFTSTokenizer::get() const {
 }
 
 void UnicodeFTSTokenizer::_skipDelimiters() {
+    if (_isAscii) {
+        while (_pos < _asciiDocument.size() && _isAsciiDelimiter(_asciiDocument[_pos])) {
+            ++_pos;
+        }
+        return;
+    }
+
     while (_pos < _document.size() &&
            unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage)) {
         ++_pos;
     }
 }
 
+size_t UnicodeFTSTokenizer::_asciiTokenEnd(size_t pos) const {
+    const char* const data = _asciiDocument.rawData();
+    const size_t size = _asciiDocument.size();
+
+    while (pos < size) {
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+        // Letters and digits are never delimiters, so skip over runs of them 16 bytes at a time.
+        // Any other byte is checked against the delimiter list below.
+        using unicode::ByteVector;
+        if (size - pos >= ByteVector::size) {
+            auto bytes = ByteVector::load(data + pos);
+            auto notAlnum = bytes.compareLT('0') | (bytes.compareGT('9') & bytes.compareLT('A')) |
+                (bytes.compareGT('Z') & bytes.compareLT('a')) | bytes.compareGT('z');
+            const uint32_t alnumBytes = ByteVector::countInitialZeros(notAlnum.maskAny());
+            pos += alnumBytes;
+            if (alnumBytes == ByteVector::size) {
+                continue;
+            }
+        }
+#endif
+        if (_isAsciiDelimiter(data[pos])) {
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -75,12 +75,26 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * Returns the end of the token which contains the byte at 'pos' in '_asciiDocument'.
+     */
+    size_t _asciiTokenEnd(size_t pos) const;
+
+    bool _isAsciiDelimiter(char c) const {
+        return unicode::codepointIsDelimiter(static_cast<unsigned char>(c), _delimListLanguage);
+    }
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
     const unicode::DelimiterListLanguage _delimListLanguage;
     const unicode::CaseFoldMode _caseFoldMode;
 
+    // Documents made up entirely of ASCII are tokenized in place, without being decoded into
+    // '_document' first.
+    bool _isAscii = false;
+    StringData _asciiDocument;
+
     unicode::String _document;
     size_t _pos;
     StringData _word;
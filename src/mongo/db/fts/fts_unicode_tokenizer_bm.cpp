@@ -0,0 +1,122 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "mongo/db/fts/fts_language.h"
+#include "mongo/db/fts/fts_tokenizer.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace fts {
+namespace {
+
+// Roughly 50KB of product description text, built from a sentence repeated with varying numbers.
+std::string makeAsciiText() {
+    std::string text;
+    for (int i = 0; text.size() < 50 * 1024; ++i) {
+        text += "The lightweight running shoe model " + std::to_string(i) +
+            " features a breathable mesh upper, cushioned midsole and durable rubber outsole. ";
+    }
+    return text;
+}
+
+std::string makeFrenchText() {
+    std::string text;
+    while (text.size() < 50 * 1024) {
+        text += "Cette chaussure légère possède une tige respirante, une semelle intermédiaire "
+                "amortissante et une semelle extérieure très résistante. ";
+    }
+    return text;
+}
+
+std::string makeRussianText() {
+    std::string text;
+    while (text.size() < 50 * 1024) {
+        text += "Лёгкая беговая обувь с дышащим верхом, "
+                "амортизирующей промежуточной подошвой и прочной резиновой подошвой. ";
+    }
+    return text;
+}
+
+void runTokenizer(benchmark::State& state, const char* language, const std::string& text) {
+    auto swl = FTSLanguage::make(language, TEXT_INDEX_VERSION_3);
+    invariant(swl.isOK());
+    auto tokenizer = swl.getValue()->createTokenizer();
+
+    for (auto _ : state) {
+        size_t tokens = 0;
+        tokenizer->reset(text, FTSTokenizer::kFilterStopWords);
+        while (tokenizer->moveNext()) {
+            benchmark::DoNotOptimize(tokenizer->get());
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_tokenizeEnglish(benchmark::State& state) {
+    runTokenizer(state, "english", makeAsciiText());
+}
+
+void BM_tokenizeSpanishAscii(benchmark::State& state) {
+    runTokenizer(state, "spanish", makeAsciiText());
+}
+
+void BM_tokenizeTurkishAscii(benchmark::State& state) {
+    runTokenizer(state, "turkish", makeAsciiText());
+}
+
+void BM_tokenizeFrench(benchmark::State& state) {
+    runTokenizer(state, "french", makeFrenchText());
+}
+
+void BM_tokenizeRussian(benchmark::State& state) {
+    runTokenizer(state, "russian", makeRussianText());
+}
+
+void BM_tokenizeNone(benchmark::State& state) {
+    runTokenizer(state, "none", makeAsciiText());
+}
+
+BENCHMARK(BM_tokenizeEnglish);
+BENCHMARK(BM_tokenizeSpanishAscii);
+BENCHMARK(BM_tokenizeTurkishAscii);
+BENCHMARK(BM_tokenizeFrench);
+BENCHMARK(BM_tokenizeRussian);
+BENCHMARK(BM_tokenizeNone);
+
+}  // namespace
+}  // namespace fts
+}  // namespace mongo
@@ -243,5 +243,41 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Documents made up entirely of ASCII are tokenized without decoding them first. Appending a
+// non-ASCII token forces the decoding path, which must produce the same tokens for the ASCII part.
+TEST(FtsUnicodeTokenizer, AsciiMatchesDecodedTokenization) {
+    std::string ascii;
+    for (int i = 0; i < 20; ++i) {
+        ascii += "In THE beginning_was " + std::to_string(i * 7919) +
+            " Mark's shoes^and `dogs` RUNNING-quickly... (\x01" "controls\x7f) " +
+            "Istanbul ILIK aVeryLongTokenThatSpansMoreThanSixteenBytes\tend\n";
+    }
+    const std::string decoded = ascii + " \xc3\xa9l\xc3\xa9phant";
+
+    const FTSTokenizer::Options allOptions[] = {
+        FTSTokenizer::kNone,
+        FTSTokenizer::kFilterStopWords,
+        FTSTokenizer::kGenerateCaseSensitiveTokens,
+        FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+        FTSTokenizer::kFilterStopWords | FTSTokenizer::kGenerateCaseSensitiveTokens |
+            FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+    };
+
+    for (const char* language : {"english", "french", "turkish", "none"}) {
+        for (auto options : allOptions) {
+            std::vector<std::string> asciiTerms = tokenizeString(ascii.c_str(), language, options);
+            std::vector<std::string> decodedTerms =
+                tokenizeString(decoded.c_str(), language, options);
+
+            ASSERT_FALSE(decodedTerms.empty());
+            decodedTerms.pop_back();
+            ASSERT_EQUALS(decodedTerms.size(), asciiTerms.size()) << language << " " << options;
+            for (size_t i = 0; i < asciiTerms.size(); ++i) {
+                ASSERT_EQUALS(decodedTerms[i], asciiTerms[i]) << language << " " << options;
+            }
+        }
+    }
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -47,6 +47,11 @@ bool GeometryContainer::isPoint() const {
     return nullptr != _point;
 }
 
+const PointWithCRS& GeometryContainer::getPoint() const {
+    invariant(_point);
+    return *_point;
+}
+
 bool GeometryContainer::supportsContains() const {
     return NULL != _polygon || NULL != _box || NULL != _cap || NULL != _multiPolygon ||
         (NULL != _geometryCollection && (_geometryCollection->polygons.vector().size() > 0 ||
@@ -83,6 +88,11 @@ const S2Region& GeometryContainer::getS2Region() const {
     }
 }
 
+bool GeometryContainer::isS2Area() const {
+    return (NULL != _polygon && (NULL != _polygon->s2Polygon || NULL != _polygon->bigPolygon)) ||
+        (NULL != _cap && SPHERE == _cap->crs) || NULL != _multiPolygon;
+}
+
 bool GeometryContainer::hasR2Region() const {
     return _cap || _box || _point || (_polygon && _polygon->crs == FLAT) ||
         (_multiPoint && FLAT == _multiPoint->crs);
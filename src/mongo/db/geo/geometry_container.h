@@ -67,6 +67,11 @@ public:
      */
     bool isPoint() const;
 
+    /**
+     * Returns the point this geometry holds. It is an error to call this unless isPoint() is true.
+     */
+    const PointWithCRS& getPoint() const;
+
     /**
      * Reports the CRS of the contained geometry.
      * TODO: Rework once we have collections of multiple CRSes
@@ -114,6 +119,10 @@ public:
     bool hasS2Region() const;
     const S2Region& getS2Region() const;
 
+    // Whether the S2 region is an area (a polygon, multipolygon or spherical cap) which contains
+    // every point of any S2 cell it contains.
+    bool isS2Area() const;
+
     // Region which can be used to generate a covering of the query object in euclidean space.
     bool hasR2Region() const;
     const R2Region& getR2Region() const;
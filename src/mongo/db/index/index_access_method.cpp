@@ -34,6 +34,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -100,6 +101,23 @@ Status checkKeySize(const BSONObj& key) {
     return Status::OK();
 }
 
+/**
+ * Makes the following writes carry the timestamp of the record at position 'record' in
+ * 'bsonRecords', if the record has one. The keys of a batch are not in record order, so the
+ * timestamp is only moved when it differs from '*currentTs'.
+ */
+Status setRecordTimestamp(OperationContext* opCtx,
+                          const std::vector<BsonRecord>& bsonRecords,
+                          size_t record,
+                          Timestamp* currentTs) {
+    const Timestamp& ts = bsonRecords[record].ts;
+    if (ts.isNull() || ts == *currentTs) {
+        return Status::OK();
+    }
+    *currentTs = ts;
+    return opCtx->recoveryUnit()->setTimestamp(ts);
+}
+
 }  // namespace
 
 // TODO SERVER-36386: Remove the server parameter
@@ -222,6 +240,124 @@ Status AbstractIndexAccessMethod::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+void AbstractIndexAccessMethod::getKeysForRecords(const std::vector<BsonRecord>& bsonRecords,
+                                                  GetKeysMode mode,
+                                                  KeysForRecords* out) const {
+    out->keys.clear();
+    out->multikeyRecords.clear();
+
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*bsonRecords[i].docPtr, mode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+
+        for (const auto& key : keys) {
+            out->keys.push_back({key, bsonRecords[i].id, i});
+        }
+        for (const auto& key : multikeyMetadataKeys) {
+            out->keys.push_back({key, kMultikeyMetadataKeyId, i});
+        }
+
+        if (shouldMarkIndexAsMultikey(keys, multikeyMetadataKeys, multikeyPaths)) {
+            out->multikeyRecords.emplace_back(i, std::move(multikeyPaths));
+        }
+    }
+
+    // Index keys compare like their KeyString encoding when field names are ignored and the
+    // ordering of the index is applied.
+    const Ordering& ordering = _btreeState->ordering();
+    std::sort(out->keys.begin(),
+              out->keys.end(),
+              [&ordering](const KeysForRecords::Key& lhs, const KeysForRecords::Key& rhs) {
+                  const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.loc < rhs.loc);
+              });
+}
+
+Status AbstractIndexAccessMethod::insertKeysForRecords(OperationContext* opCtx,
+                                                       const std::vector<BsonRecord>& bsonRecords,
+                                                       const KeysForRecords& keys,
+                                                       const InsertDeleteOptions& options,
+                                                       int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+    bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+
+    // Writes must carry the timestamp of the record they belong to.
+    Timestamp currentTs;
+
+    // Mark the index multikey before inserting any keys, in record order, so that the catalog
+    // change happens no later than the first write that needs it.
+    for (const auto& multikeyRecord : keys.multikeyRecords) {
+        Status status = setRecordTimestamp(opCtx, bsonRecords, multikeyRecord.first, &currentTs);
+        if (!status.isOK()) {
+            return status;
+        }
+        _btreeState->setMultikey(opCtx, multikeyRecord.second);
+    }
+
+    for (const auto& key : keys.keys) {
+        Status status = setRecordTimestamp(opCtx, bsonRecords, key.record, &currentTs);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        status = checkIndexKeySize ? checkKeySize(key.key) : Status::OK();
+        if (status.isOK()) {
+            StatusWith<SpecialFormatInserted> ret =
+                _newInterface->insert(opCtx, key.key, key.loc, options.dupsAllowed);
+            status = ret.getStatus();
+            if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+                _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+        }
+        if (isFatalError(opCtx, status, key.key)) {
+            return status;
+        }
+    }
+
+    // Leave the last record's timestamp in place, as inserting the records one by one would.
+    if (!bsonRecords.empty()) {
+        Status status =
+            setRecordTimestamp(opCtx, bsonRecords, bsonRecords.size() - 1, &currentTs);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    *numInserted = keys.keys.size();
+    return Status::OK();
+}
+
+Status AbstractIndexAccessMethod::removeKeysForRecords(OperationContext* opCtx,
+                                                       const std::vector<BsonRecord>& bsonRecords,
+                                                       const KeysForRecords& keys,
+                                                       const InsertDeleteOptions& options,
+                                                       int64_t* numDeleted) {
+    invariant(numDeleted);
+    *numDeleted = 0;
+
+    // Writes must carry the timestamp of the record they belong to.
+    Timestamp currentTs;
+    for (const auto& key : keys.keys) {
+        // Multikey metadata keys describe the index rather than any one record, and remove() does
+        // not remove them either.
+        if (key.loc == kMultikeyMetadataKeyId) {
+            continue;
+        }
+
+        Status status = setRecordTimestamp(opCtx, bsonRecords, key.record, &currentTs);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        removeOneKey(opCtx, key.key, key.loc, options.dupsAllowed);
+        ++*numDeleted;
+    }
+
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const BSONObj& key,
                                              const RecordId& loc,
@@ -33,6 +33,8 @@
 #include <atomic>
 #include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
@@ -50,6 +52,7 @@ namespace mongo {
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 bool failIndexKeyTooLongParam();
@@ -307,6 +310,56 @@ public:
                                            const BSONObjSet& multikeyMetadataKeys,
                                            const MultikeyPaths& multikeyPaths) const = 0;
 
+    /**
+     * The keys of a batch of records, as generated by getKeysForRecords().
+     */
+    struct KeysForRecords {
+        struct Key {
+            BSONObj key;
+            RecordId loc;
+            // Position in the batch of the record the key was generated for.
+            size_t record;
+        };
+
+        // Sorted in index order, ties broken by RecordId.
+        std::vector<Key> keys;
+
+        // The records which make the index multikey, with the paths that do so.
+        std::vector<std::pair<size_t, MultikeyPaths>> multikeyRecords;
+    };
+
+    /**
+     * Generates the keys of every record in 'bsonRecords' into 'out', sorted in the order of the
+     * index so that insertKeysForRecords() applies them in a single pass over the index rather
+     * than in the random order of the documents. Neither reads nor writes the index, so it is
+     * safe to call concurrently on different indexes. Throws as getKeys() does.
+     */
+    virtual void getKeysForRecords(const std::vector<BsonRecord>& bsonRecords,
+                                   GetKeysMode mode,
+                                   KeysForRecords* out) const = 0;
+
+    /**
+     * Inserts the keys generated by getKeysForRecords() for the same 'bsonRecords'. Each key is
+     * written at the timestamp of its record, if the record has one. 'numInserted' will be set to
+     * the number of keys added to the index.
+     */
+    virtual Status insertKeysForRecords(OperationContext* opCtx,
+                                        const std::vector<BsonRecord>& bsonRecords,
+                                        const KeysForRecords& keys,
+                                        const InsertDeleteOptions& options,
+                                        int64_t* numInserted) = 0;
+
+    /**
+     * Removes the keys generated by getKeysForRecords() for the same 'bsonRecords', in index order.
+     * Each key is removed at the timestamp of its record, if the record has one. 'numDeleted' will
+     * be set to the number of keys removed from the index.
+     */
+    virtual Status removeKeysForRecords(OperationContext* opCtx,
+                                        const std::vector<BsonRecord>& bsonRecords,
+                                        const KeysForRecords& keys,
+                                        const InsertDeleteOptions& options,
+                                        int64_t* numDeleted) = 0;
+
     /**
      * Returns the intersection of 'fields' and the set of multikey metadata paths stored in the
      * index. Only index types which can store metadata describing an arbitrarily large set of
@@ -477,6 +530,22 @@ public:
                                    const BSONObjSet& multikeyMetadataKeys,
                                    const MultikeyPaths& multikeyPaths) const override;
 
+    void getKeysForRecords(const std::vector<BsonRecord>& bsonRecords,
+                           GetKeysMode mode,
+                           KeysForRecords* out) const final;
+
+    Status insertKeysForRecords(OperationContext* opCtx,
+                                const std::vector<BsonRecord>& bsonRecords,
+                                const KeysForRecords& keys,
+                                const InsertDeleteOptions& options,
+                                int64_t* numInserted) final;
+
+    Status removeKeysForRecords(OperationContext* opCtx,
+                                const std::vector<BsonRecord>& bsonRecords,
+                                const KeysForRecords& keys,
+                                const InsertDeleteOptions& options,
+                                int64_t* numDeleted) final;
+
     SortedDataInterface* getSortedDataInterface_forTest() const final;
 
 protected:
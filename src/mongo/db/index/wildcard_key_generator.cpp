@@ -42,22 +42,29 @@ namespace {
 // to prevent the _id field from being indexed, since it already has its own dedicated index.
 static const BSONObj kDefaultProjection = BSON("_id"_sd << 0);
 
+// Keys and multikey path entries are built with enough headroom for the path string, the value's
+// type byte and the surrounding BSON framing, so that most keys are written without regrowing.
+constexpr int kKeyOverheadBytes = 32;
+
 // If the enclosing object is an array, then the current element's fieldname is the array index, so
 // we omit this when computing the full path. Otherwise, the full path is the pathPrefix plus the
-// element's fieldname.
-void pushPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathPrefix) {
-    if (!enclosingObjIsArray) {
-        pathPrefix->appendPart(elem.fieldNameStringData());
-    }
-}
-
-// If the enclosing object is not an array, then the final path component should be its field name.
-// Verify that this is the case and then pop it off the FieldRef.
-void popPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathToElem) {
+// element's fieldname. Returns the length of the path before the component was appended, so that
+// the caller can later truncate the path back to it.
+size_t pushPathComponent(BSONElement elem,
+                         bool enclosingObjIsArray,
+                         bool enclosingObjIsRoot,
+                         std::string* pathPrefix) {
+    const size_t prefixLen = pathPrefix->size();
     if (!enclosingObjIsArray) {
-        invariant(pathToElem->getPart(pathToElem->numParts() - 1) == elem.fieldNameStringData());
-        pathToElem->removeLastPart();
+        // Top-level fields have no separator. This cannot be inferred from an empty prefix, since
+        // an empty field name also contributes an empty path component.
+        if (!enclosingObjIsRoot) {
+            pathPrefix->push_back('.');
+        }
+        const auto fieldName = elem.fieldNameStringData();
+        pathPrefix->append(fieldName.rawData(), fieldName.size());
     }
+    return prefixLen;
 }
 }  // namespace
 
@@ -97,18 +104,32 @@ WildcardKeyGenerator::WildcardKeyGenerator(BSONObj keyPattern,
                                            const CollatorInterface* collator)
     : _collator(collator), _keyPattern(keyPattern) {
     _projExec = createProjectionExec(keyPattern, pathProjection);
+
+    // The default {_id: 0} projection only removes the top-level _id field, which the traversal can
+    // do by itself. Every other projection is applied to the document before it is traversed.
+    const auto indexRoot = keyPattern.firstElement().fieldNameStringData();
+    _isDefaultProjection =
+        pathProjection.isEmpty() && indexRoot.find(kSubtreeSuffix) == std::string::npos;
 }
 
 void WildcardKeyGenerator::generateKeys(BSONObj inputDoc,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyPaths) const {
-    FieldRef rootPath;
-    _traverseWildcard(_projExec->applyProjection(inputDoc), false, &rootPath, keys, multikeyPaths);
+    // A single path buffer is shared by the whole traversal, rather than allocating a new path for
+    // every field that is visited.
+    std::string rootPath;
+    _traverseWildcard(_isDefaultProjection ? inputDoc : _projExec->applyProjection(inputDoc),
+                      false,
+                      true,
+                      &rootPath,
+                      keys,
+                      multikeyPaths);
 }
 
 void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
                                              bool objIsArray,
-                                             FieldRef* path,
+                                             bool objIsRoot,
+                                             std::string* path,
                                              BSONObjSet* keys,
                                              BSONObjSet* multikeyPaths) const {
     for (const auto elem : obj) {
@@ -116,8 +137,12 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
         if (elem.fieldNameStringData().find('.', 0) != std::string::npos)
             continue;
 
+        // The _id field is never indexed unless the projection explicitly includes it.
+        if (objIsRoot && _isDefaultProjection && elem.fieldNameStringData() == "_id"_sd)
+            continue;
+
         // Append the element's fieldname to the path, if the enclosing object is not an array.
-        pushPathComponent(elem, objIsArray, path);
+        const size_t prefixLen = pushPathComponent(elem, objIsArray, objIsRoot, path);
 
         switch (elem.type()) {
             case BSONType::Array:
@@ -133,7 +158,7 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
                     break;
 
                 _traverseWildcard(
-                    elem.Obj(), elem.type() == BSONType::Array, path, keys, multikeyPaths);
+                    elem.Obj(), elem.type() == BSONType::Array, false, path, keys, multikeyPaths);
                 break;
 
             default:
@@ -141,12 +166,12 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
         }
 
         // Remove the element's fieldname from the path, if it was pushed onto it earlier.
-        popPathComponent(elem, objIsArray, path);
+        path->resize(prefixLen);
     }
 }
 
 bool WildcardKeyGenerator::_addKeyForNestedArray(BSONElement elem,
-                                                 const FieldRef& fullPath,
+                                                 StringData fullPath,
                                                  bool enclosingObjIsArray,
                                                  BSONObjSet* keys) const {
     // If this element is an array whose parent is also an array, index it as a value.
@@ -158,7 +183,7 @@ bool WildcardKeyGenerator::_addKeyForNestedArray(BSONElement elem,
 }
 
 bool WildcardKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
-                                               const FieldRef& fullPath,
+                                               StringData fullPath,
                                                BSONObjSet* keys) const {
     invariant(elem.isABSONObj());
     if (elem.embeddedObject().isEmpty()) {
@@ -171,11 +196,11 @@ bool WildcardKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
 }
 
 void WildcardKeyGenerator::_addKey(BSONElement elem,
-                                   const FieldRef& fullPath,
+                                   StringData fullPath,
                                    BSONObjSet* keys) const {
     // Wildcard keys are of the form { "": "path.to.field", "": <collation-aware value> }.
-    BSONObjBuilder bob;
-    bob.append("", fullPath.dottedField());
+    BSONObjBuilder bob(fullPath.size() + (elem ? elem.size() : 0) + kKeyOverheadBytes);
+    bob.append("", fullPath);
     if (elem) {
         CollationIndexKey::collationAwareIndexKeyAppend(elem, _collator, &bob);
     } else {
@@ -184,12 +209,15 @@ void WildcardKeyGenerator::_addKey(BSONElement elem,
     keys->insert(bob.obj());
 }
 
-void WildcardKeyGenerator::_addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const {
+void WildcardKeyGenerator::_addMultiKey(StringData fullPath, BSONObjSet* multikeyPaths) const {
     // Multikey paths are denoted by a key of the form { "": 1, "": "path.to.array" }. The argument
     // 'multikeyPaths' may be nullptr if the access method is being used in an operation which does
     // not require multikey path generation.
     if (multikeyPaths) {
-        multikeyPaths->insert(BSON("" << 1 << "" << fullPath.dottedField()));
+        BSONObjBuilder bob(fullPath.size() + kKeyOverheadBytes);
+        bob.append("", 1);
+        bob.append("", fullPath);
+        multikeyPaths->insert(bob.obj());
     }
 }
 
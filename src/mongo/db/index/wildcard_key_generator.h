@@ -30,8 +30,9 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/db/exec/projection_exec_agg.h"
-#include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
 namespace mongo {
@@ -76,24 +77,34 @@ public:
 
 private:
     // Traverses every path of the post-projection document, adding keys to the set as it goes.
+    // The dotted path to 'obj' is held in 'path', which is extended in place as the traversal
+    // descends and restored to its original length before returning. 'objIsRoot' is true only for
+    // the top-level document.
     void _traverseWildcard(BSONObj obj,
                            bool objIsArray,
-                           FieldRef* path,
+                           bool objIsRoot,
+                           std::string* path,
                            BSONObjSet* keys,
                            BSONObjSet* multikeyPaths) const;
 
     // Helper functions to format the entry appropriately before adding it to the key/path tracker.
-    void _addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const;
-    void _addKey(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
+    void _addMultiKey(StringData fullPath, BSONObjSet* multikeyPaths) const;
+    void _addKey(BSONElement elem, StringData fullPath, BSONObjSet* keys) const;
 
     // Helper to check whether the element is a nested array, and conditionally add it to 'keys'.
     bool _addKeyForNestedArray(BSONElement elem,
-                               const FieldRef& fullPath,
+                               StringData fullPath,
                                bool enclosingObjIsArray,
                                BSONObjSet* keys) const;
-    bool _addKeyForEmptyLeaf(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
+    bool _addKeyForEmptyLeaf(BSONElement elem, StringData fullPath, BSONObjSet* keys) const;
 
     std::unique_ptr<ProjectionExecAgg> _projExec;
+
+    // True if the index uses the default projection {_id: 0}. In this case generateKeys() skips
+    // the top-level _id field during traversal rather than materializing a projected copy of each
+    // document.
+    bool _isDefaultProjection = false;
+
     const CollatorInterface* _collator;
     const BSONObj _keyPattern;
 };
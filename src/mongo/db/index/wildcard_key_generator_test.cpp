@@ -673,6 +673,45 @@ TEST(WildcardKeyGeneratorIdTest, ExcludeIdFieldIfProjectionIsEmpty) {
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+TEST(WildcardKeyGeneratorIdTest, ExcludeOnlyTopLevelIdFieldIfProjectionIsEmpty) {
+    WildcardKeyGenerator keyGen{fromjson("{'$**': 1}"), {}, nullptr};
+
+    auto inputDoc = fromjson("{_id: 1, a: {_id: 2, b: [{_id: 3}]}, _idx: 4}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'a._id', '': 2}"),
+                                    fromjson("{'': 'a.b._id', '': 3}"),
+                                    fromjson("{'': '_idx', '': 4}")});
+
+    auto expectedMultikeyPaths = makeKeySet({fromjson("{'': 1, '': 'a.b'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
+TEST(WildcardKeyGeneratorIdTest, EmptyProjectionProducesSameKeysAsExplicitIdExclusion) {
+    WildcardKeyGenerator defaultKeyGen{fromjson("{'$**': 1}"), {}, nullptr};
+    WildcardKeyGenerator explicitKeyGen{fromjson("{'$**': 1}"), fromjson("{_id: 0}"), nullptr};
+
+    auto inputDoc = fromjson(
+        "{_id: {id1: 1}, a: [1, {b: 1, e: [4]}, [6, 7, {f: 8}], []], g: {h: {i: 9, k: {}}}, "
+        "'l.m': 10, n: {'o.p': 11, q: [[12]]}}");
+
+    auto defaultKeys = makeKeySet();
+    auto defaultMultikeyPaths = makeKeySet();
+    defaultKeyGen.generateKeys(inputDoc, &defaultKeys, &defaultMultikeyPaths);
+
+    auto explicitKeys = makeKeySet();
+    auto explicitMultikeyPaths = makeKeySet();
+    explicitKeyGen.generateKeys(inputDoc, &explicitKeys, &explicitMultikeyPaths);
+
+    ASSERT(assertKeysetsEqual(explicitKeys, defaultKeys));
+    ASSERT(assertKeysetsEqual(explicitMultikeyPaths, defaultMultikeyPaths));
+}
+
 TEST(WildcardKeyGeneratorIdTest, ExcludeIdFieldForSingleSubtreeKeyPattern) {
     WildcardKeyGenerator keyGen{fromjson("{'a.$**': 1}"), {}, nullptr};
 
@@ -952,6 +991,24 @@ TEST(WildcardKeyGeneratorDottedFieldsTest, DoNotIndexDottedFields) {
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+TEST(WildcardKeyGeneratorDottedFieldsTest, EmptyFieldNamesContributeEmptyPathComponents) {
+    WildcardKeyGenerator keyGen{fromjson("{'$**': 1}"), {}, nullptr};
+
+    auto inputDoc = fromjson("{'': {b: 1}, c: {'': 2}}");
+
+    auto expectedKeys =
+        makeKeySet({fromjson("{'': '.b', '': 1}"), fromjson("{'': 'c.', '': 2}")});
+
+    auto expectedMultikeyPaths = makeKeySet();
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
 TEST(WildcardKeyGeneratorDottedFieldsTest, DoNotIndexDottedFieldsWithSimilarSubpathInKey) {
     WildcardKeyGenerator keyGen{fromjson("{'a.b.$**': 1}"), {}, {}};
 
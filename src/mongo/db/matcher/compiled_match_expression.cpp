@@ -0,0 +1,327 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+// Documents are scanned once for all paths, keeping track of which fields of each object were
+// already seen in a 64-bit mask, since only the first of several fields with the same name counts.
+const size_t kMaxFieldsPerObject = 64;
+
+template <typename T>
+bool compareValues(MatchExpression::MatchType cmp, const T& lhs, const T& rhs) {
+    switch (cmp) {
+        case MatchExpression::LT:
+            return lhs < rhs;
+        case MatchExpression::LTE:
+            return lhs <= rhs;
+        case MatchExpression::EQ:
+            return lhs == rhs;
+        case MatchExpression::GT:
+            return lhs > rhs;
+        case MatchExpression::GTE:
+            return lhs >= rhs;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* root) {
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression(root));
+    compiled->_compile(root);
+    if (compiled->_numSlots == 0 || !compiled->_fitsInMask(compiled->_paths)) {
+        return nullptr;
+    }
+    compiled->_slots.resize(compiled->_numSlots);
+    return compiled;
+}
+
+void CompiledMatchExpression::_compile(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            _compileLogical(expr, OpCode::kJumpIfFalse, true);
+            return;
+        case MatchExpression::OR:
+            _compileLogical(expr, OpCode::kJumpIfTrue, false);
+            return;
+        case MatchExpression::NOR:
+            _compileLogical(expr, OpCode::kJumpIfTrue, false);
+            _program.push_back({OpCode::kNot});
+            return;
+        case MatchExpression::NOT:
+            _compile(expr->getChild(0));
+            _program.push_back({OpCode::kNot});
+            return;
+        case MatchExpression::ALWAYS_FALSE:
+        case MatchExpression::ALWAYS_TRUE: {
+            Instruction instruction{OpCode::kConstant};
+            instruction.value = expr->matchType() == MatchExpression::ALWAYS_TRUE;
+            _program.push_back(instruction);
+            return;
+        }
+        default:
+            break;
+    }
+
+    // Path expressions match if any element on their path matches. Without arrays on the path,
+    // that is the one element at the path, or EOO if there is none.
+    auto pathExpr = dynamic_cast<const PathMatchExpression*>(expr);
+    if (pathExpr && !pathExpr->path().empty()) {
+        _compilePath(expr);
+        return;
+    }
+
+    Instruction instruction{OpCode::kMatchDocument};
+    instruction.expr = expr;
+    _program.push_back(instruction);
+}
+
+void CompiledMatchExpression::_compileLogical(const MatchExpression* expr,
+                                              OpCode shortCircuit,
+                                              bool emptyValue) {
+    const size_t numChildren = expr->numChildren();
+    if (numChildren == 0) {
+        Instruction instruction{OpCode::kConstant};
+        instruction.value = emptyValue;
+        _program.push_back(instruction);
+        return;
+    }
+
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i < numChildren; ++i) {
+        _compile(expr->getChild(i));
+        if (i + 1 < numChildren) {
+            jumps.push_back(_program.size());
+            _program.push_back({shortCircuit});
+        }
+    }
+
+    for (auto jump : jumps) {
+        _program[jump].target = _program.size();
+    }
+}
+
+void CompiledMatchExpression::_compilePath(const MatchExpression* expr) {
+    Instruction instruction{OpCode::kMatchElement};
+    instruction.expr = expr;
+    instruction.slot = _slotForPath(expr->path());
+
+    if (ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+        auto cmpExpr = static_cast<const ComparisonMatchExpression*>(expr);
+        const BSONElement& rhs = cmpExpr->getData();
+        instruction.cmp = expr->matchType();
+
+        switch (rhs.type()) {
+            case NumberInt:
+            case NumberLong:
+                instruction.op = OpCode::kCompareInt;
+                instruction.intValue = rhs.numberLong();
+                break;
+            case NumberDouble:
+                // NaN only equals NaN, leave it to the expression.
+                if (!std::isnan(rhs.numberDouble())) {
+                    instruction.op = OpCode::kCompareDouble;
+                    instruction.doubleValue = rhs.numberDouble();
+                }
+                break;
+            case String:
+                if (!cmpExpr->getCollator()) {
+                    instruction.op = OpCode::kCompareString;
+                    instruction.stringValue = rhs.valueStringData();
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    _program.push_back(instruction);
+}
+
+std::uint32_t CompiledMatchExpression::_slotForPath(StringData path) {
+    PathNode* node = &_paths;
+    while (true) {
+        const size_t dot = path.find('.');
+        const StringData fieldName = path.substr(0, dot);
+
+        auto child = std::find_if(node->children.begin(),
+                                  node->children.end(),
+                                  [&](const PathNode& n) { return n.fieldName == fieldName; });
+        if (child == node->children.end()) {
+            node->children.emplace_back();
+            child = node->children.end() - 1;
+            child->fieldName = fieldName.toString();
+        }
+        node = &*child;
+
+        if (dot == std::string::npos) {
+            break;
+        }
+        path = path.substr(dot + 1);
+    }
+
+    if (node->slot < 0) {
+        node->slot = _numSlots++;
+    }
+    return node->slot;
+}
+
+bool CompiledMatchExpression::_fitsInMask(const PathNode& node) {
+    if (node.children.size() > kMaxFieldsPerObject) {
+        return false;
+    }
+    return std::all_of(node.children.begin(), node.children.end(), [](const PathNode& child) {
+        return _fitsInMask(child);
+    });
+}
+
+bool CompiledMatchExpression::_extract(const BSONObj& obj, const PathNode& node) const {
+    const std::uint64_t allSeen = node.children.size() == kMaxFieldsPerObject
+        ? ~std::uint64_t(0)
+        : (std::uint64_t(1) << node.children.size()) - 1;
+    std::uint64_t seen = 0;
+
+    for (auto&& elem : obj) {
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < node.children.size(); ++i) {
+            const PathNode& child = node.children[i];
+            if ((seen & (std::uint64_t(1) << i)) || child.fieldName != fieldName) {
+                continue;
+            }
+            seen |= std::uint64_t(1) << i;
+
+            if (elem.type() == Array) {
+                return false;
+            }
+            if (child.slot >= 0) {
+                _slots[child.slot] = elem;
+            }
+            // Paths through anything but an object lead nowhere, their slots stay EOO.
+            if (!child.children.empty() && elem.type() == Object &&
+                !_extract(elem.embeddedObject(), child)) {
+                return false;
+            }
+            break;
+        }
+
+        if (seen == allSeen) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    std::fill(_slots.begin(), _slots.end(), BSONElement());
+    if (!_extract(doc, _paths)) {
+        return _root->matchesBSON(doc);
+    }
+    return _run(doc);
+}
+
+bool CompiledMatchExpression::_run(const BSONObj& doc) const {
+    bool result = false;
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instruction = _program[pc++];
+        switch (instruction.op) {
+            case OpCode::kConstant:
+                result = instruction.value;
+                break;
+            case OpCode::kCompareInt: {
+                const BSONElement& elem = _slots[instruction.slot];
+                if (elem.type() == NumberInt || elem.type() == NumberLong) {
+                    result =
+                        compareValues(instruction.cmp, elem.numberLong(), instruction.intValue);
+                } else {
+                    result = instruction.expr->matchesSingleElement(elem);
+                }
+                break;
+            }
+            case OpCode::kCompareDouble: {
+                const BSONElement& elem = _slots[instruction.slot];
+                if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+                    result = compareValues(
+                        instruction.cmp, elem._numberDouble(), instruction.doubleValue);
+                } else {
+                    result = instruction.expr->matchesSingleElement(elem);
+                }
+                break;
+            }
+            case OpCode::kCompareString: {
+                const BSONElement& elem = _slots[instruction.slot];
+                if (elem.type() == String) {
+                    const int cmp = elem.valueStringData().compare(instruction.stringValue);
+                    result = compareValues(instruction.cmp, cmp, 0);
+                } else {
+                    result = instruction.expr->matchesSingleElement(elem);
+                }
+                break;
+            }
+            case OpCode::kMatchElement:
+                result = instruction.expr->matchesSingleElement(_slots[instruction.slot]);
+                break;
+            case OpCode::kMatchDocument:
+                result = instruction.expr->matchesBSON(doc);
+                break;
+            case OpCode::kNot:
+                result = !result;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!result) {
+                    pc = instruction.target;
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (result) {
+                    pc = instruction.target;
+                }
+                break;
+        }
+    }
+    return result;
+}
+
+}  // namespace mongo
@@ -0,0 +1,144 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A MatchExpression tree flattened into a program for matching BSON documents.
+ *
+ * Evaluating the tree directly walks the document once per leaf predicate, through virtual calls
+ * and path iterators. The program instead looks up every path the predicates refer to in a single
+ * pass over the document, then runs the predicates from a flat instruction array, with
+ * comparisons of ints, longs, doubles and strings done inline and short-circuiting jumps for
+ * $and, $or and $nor.
+ *
+ * Documents that have an array anywhere along one of the paths fall back to the MatchExpression,
+ * as do subtrees which are not path predicates or logical operators. The MatchExpression thus
+ * remains the definition of what matches.
+ *
+ * The MatchExpression must outlive the CompiledMatchExpression. A CompiledMatchExpression is not
+ * safe to use from several threads at once.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Returns a program for 'root', or nullptr when compiling would not help because no predicate
+     * of 'root' looks up a path.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* root);
+
+    /**
+     * Returns whether 'doc' matches, with the same result as root->matchesBSON(doc).
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    size_t numPaths() const {
+        return _numSlots;
+    }
+
+private:
+    enum class OpCode : std::uint8_t {
+        // Set the result to 'value'.
+        kConstant,
+        // Compare the element in 'slot' to 'intValue', 'doubleValue' or 'stringValue' as 'cmp'
+        // says, falling back to 'expr' if the element has another type.
+        kCompareInt,
+        kCompareDouble,
+        kCompareString,
+        // Run 'expr' on the element in 'slot'.
+        kMatchElement,
+        // Run 'expr' on the whole document.
+        kMatchDocument,
+        // Negate the result.
+        kNot,
+        // Jump to 'target' if the result is false, respectively true.
+        kJumpIfFalse,
+        kJumpIfTrue,
+    };
+
+    struct Instruction {
+        OpCode op;
+        MatchExpression::MatchType cmp = MatchExpression::EQ;
+        bool value = false;
+        std::uint32_t slot = 0;
+        std::uint32_t target = 0;
+        const MatchExpression* expr = nullptr;
+        long long intValue = 0;
+        double doubleValue = 0;
+        StringData stringValue;
+    };
+
+    // A field name in the dotted paths the predicates look up. 'slot' is set if a path ends here.
+    struct PathNode {
+        std::string fieldName;
+        int slot = -1;
+        std::vector<PathNode> children;
+    };
+
+    explicit CompiledMatchExpression(const MatchExpression* root) : _root(root) {}
+
+    void _compile(const MatchExpression* expr);
+    void _compileLogical(const MatchExpression* expr, OpCode shortCircuit, bool emptyValue);
+    void _compilePath(const MatchExpression* expr);
+    std::uint32_t _slotForPath(StringData path);
+
+    static bool _fitsInMask(const PathNode& node);
+
+    /**
+     * Fills '_slots' with the elements of 'obj' on the paths below 'node'. Returns false if an
+     * array was found on one of the paths.
+     */
+    bool _extract(const BSONObj& obj, const PathNode& node) const;
+
+    bool _run(const BSONObj& doc) const;
+
+    const MatchExpression* const _root;
+    std::vector<Instruction> _program;
+    PathNode _paths;
+    std::uint32_t _numSlots = 0;
+
+    mutable std::vector<BSONElement> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter,
+                                       const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    auto expr = MatchExpressionParser::parse(filter, std::move(expCtx));
+    ASSERT_OK(expr.getStatus());
+    return MatchExpression::optimize(std::move(expr.getValue()));
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5, b: 'x'}"),
+    fromjson("{a: 5.5, b: 'y', c: {d: 3}}"),
+    fromjson("{a: NumberLong(7), b: 'abc', c: {d: 'z', e: null}}"),
+    fromjson("{a: NaN, b: null, c: 4}"),
+    fromjson("{a: NumberDecimal('5'), b: 'x', c: {d: 2.5}}"),
+    fromjson("{a: '5', b: 2, c: {d: {e: 1}}}"),
+    fromjson("{a: [1, 5], b: 'x'}"),
+    fromjson("{a: 1, c: [{d: 3}, {d: 4}]}"),
+    fromjson("{a: 1, c: {d: [3, 4]}}"),
+    fromjson("{a: 6, a: 1, b: 'x'}"),
+    fromjson("{c: {d: 1}, c: {d: 3}}"),
+    fromjson("{a: null, b: MinKey, c: MaxKey}"),
+    fromjson("{a: {$numberLong: '9007199254740993'}, b: ''}"),
+    fromjson("{a: true, b: {x: 1}, c: 5}"),
+};
+
+void assertMatchesLikeExpression(const BSONObj& filter,
+                                 const CollatorInterface* collator = nullptr) {
+    auto expr = parse(filter, collator);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled) << filter;
+
+    for (const auto& doc : kDocs) {
+        ASSERT_EQ(expr->matchesBSON(doc), compiled->matchesBSON(doc))
+            << "filter: " << filter << " doc: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, Comparisons) {
+    for (const char* op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertMatchesLikeExpression(BSON("a" << BSON(op << 5)));
+        assertMatchesLikeExpression(BSON("a" << BSON(op << 5.5)));
+        assertMatchesLikeExpression(BSON("a" << BSON(op << 9007199254740993LL)));
+        assertMatchesLikeExpression(BSON("a" << BSON(op << std::nan(""))));
+        assertMatchesLikeExpression(BSON("b" << BSON(op << "x")));
+        assertMatchesLikeExpression(BSON("b" << BSON(op << "")));
+        assertMatchesLikeExpression(BSON("b" << BSON(op << BSONNULL)));
+        assertMatchesLikeExpression(BSON("c.d" << BSON(op << 3)));
+        assertMatchesLikeExpression(BSON("c.d.e" << BSON(op << 1)));
+        assertMatchesLikeExpression(BSON("a" << BSON(op << MINKEY)));
+        assertMatchesLikeExpression(BSON("a" << BSON(op << MAXKEY)));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, OtherLeaves) {
+    assertMatchesLikeExpression(fromjson("{a: {$exists: true}}"));
+    assertMatchesLikeExpression(fromjson("{'c.e': {$exists: false}}"));
+    assertMatchesLikeExpression(fromjson("{a: {$in: [1, 7, '5']}}"));
+    assertMatchesLikeExpression(fromjson("{b: {$type: 'string'}}"));
+    assertMatchesLikeExpression(fromjson("{b: /^a/}"));
+    assertMatchesLikeExpression(fromjson("{a: {$mod: [2, 1]}}"));
+    assertMatchesLikeExpression(fromjson("{c: {$elemMatch: {d: 3}}}"));
+    assertMatchesLikeExpression(fromjson("{b: {$size: 0}}"));
+}
+
+TEST(CompiledMatchExpressionTest, LogicalOperators) {
+    assertMatchesLikeExpression(fromjson("{a: {$gt: 1, $lt: 7}, b: 'x'}"));
+    assertMatchesLikeExpression(fromjson("{$or: [{a: 1}, {b: 'x'}, {'c.d': 3}]}"));
+    assertMatchesLikeExpression(fromjson("{$nor: [{a: 1}, {b: 'x'}]}"));
+    assertMatchesLikeExpression(fromjson("{a: {$not: {$gt: 3}}}"));
+    assertMatchesLikeExpression(fromjson("{$and: [{$or: [{a: 5}, {a: 1}]}, {$nor: [{c: 4}]}]}"));
+    assertMatchesLikeExpression(fromjson("{$or: [{a: {$lt: 2}}, {$and: [{b: 'x'}, {a: 5}]}]}"));
+    assertMatchesLikeExpression(fromjson("{$and: [{a: {$exists: true}}, {$alwaysFalse: 1}]}"));
+    assertMatchesLikeExpression(fromjson("{$or: [{$alwaysTrue: 1}, {a: 1}]}"));
+}
+
+TEST(CompiledMatchExpressionTest, DocumentPredicatesAreEvaluatedWhole) {
+    assertMatchesLikeExpression(fromjson("{a: {$gte: 1}, $expr: {$eq: ['$b', 'x']}}"));
+}
+
+TEST(CompiledMatchExpressionTest, Collation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    assertMatchesLikeExpression(fromjson("{b: 'X'}"), &collator);
+    assertMatchesLikeExpression(fromjson("{b: {$lt: 'B'}}"), &collator);
+}
+
+TEST(CompiledMatchExpressionTest, PathsAreLookedUpOnce) {
+    auto expr = parse(fromjson("{a: {$gt: 1, $lt: 7}, 'c.d': 3, $or: [{'c.d': 4}, {b: 1}]}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    ASSERT_EQ(3U, compiled->numPaths());
+}
+
+TEST(CompiledMatchExpressionTest, NothingToCompileWithoutPaths) {
+    auto expr = parse(fromjson("{}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/platform/basic.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 namespace mongo {
 
@@ -147,6 +148,47 @@ Status GeoExpression::parseFrom(const BSONObj& obj) {
     return Status::OK();
 }
 
+void GeoExpression::computeInteriorCovering(int maxCells) {
+    if (maxCells <= 0 || SPHERE != geoContainer->getNativeCRS() || !geoContainer->isS2Area()) {
+        return;
+    }
+
+    S2RegionCoverer coverer;
+    coverer.set_max_cells(maxCells);
+    coverer.GetInteriorCellUnion(geoContainer->getS2Region(), &interiorCovering);
+}
+
+bool GeoExpression::interiorContains(const S2Point& point) const {
+    return interiorCovering.num_cells() > 0 && interiorCovering.Contains(point);
+}
+
+const std::vector<S2CellId>& GeoExpression::getS2Covering(S2RegionCoverer* coverer) const {
+    for (const auto& covering : s2Coverings) {
+        if (covering.minLevel == coverer->min_level() &&
+            covering.maxLevel == coverer->max_level() &&
+            covering.levelMod == coverer->level_mod() &&
+            covering.maxCells == coverer->max_cells()) {
+            return covering.cells;
+        }
+    }
+
+    s2Coverings.push_back({coverer->min_level(),
+                           coverer->max_level(),
+                           coverer->level_mod(),
+                           coverer->max_cells(),
+                           std::vector<S2CellId>()});
+    coverer->GetCovering(geoContainer->getS2Region(), &s2Coverings.back().cells);
+    return s2Coverings.back().cells;
+}
+
+size_t GeoExpression::getApproximateCoveringsSize() const {
+    size_t size = interiorCovering.num_cells() * sizeof(S2CellId);
+    for (const auto& covering : s2Coverings) {
+        size += sizeof(covering) + covering.cells.capacity() * sizeof(S2CellId);
+    }
+    return size;
+}
+
 //
 // GeoNearExpression
 //
@@ -366,6 +408,13 @@ bool GeoMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails
 
     geometry.projectInto(_query->getGeometry().getNativeCRS());
 
+    // A point in a cell lying entirely inside the query geometry is both within and intersecting
+    // it, which is much cheaper to find out than running the exact test.
+    if (geometry.isPoint() && SPHERE == geometry.getPoint().crs &&
+        _query->interiorContains(geometry.getPoint().point)) {
+        return true;
+    }
+
     if (GeoExpression::WITHIN == _query->getPred()) {
         return _query->getGeometry().contains(geometry);
     } else {
@@ -33,10 +33,16 @@
 
 #pragma once
 
+#include <list>
+#include <vector>
 
 #include "mongo/db/geo/geometry_container.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "third_party/s2/s2cellid.h"
+#include "third_party/s2/s2cellunion.h"
+
+class S2RegionCoverer;
 
 namespace mongo {
 
@@ -66,6 +72,31 @@ public:
         return *geoContainer;
     }
 
+    /**
+     * Approximates the inside of the query geometry with at most about 'maxCells' S2 cells, for
+     * use by interiorContains(). Only spherical areas have an inside to approximate.
+     */
+    void computeInteriorCovering(int maxCells);
+
+    /**
+     * Returns true if 'point' lies in a cell entirely inside the query geometry, in which case the
+     * geometry both contains and intersects the point. A false return says nothing either way.
+     */
+    bool interiorContains(const S2Point& point) const;
+
+    /**
+     * Returns the covering of the query geometry computed by 'coverer'. Coverings are kept with
+     * the expression, so one which is reused from the GeoExpressionCache only computes its
+     * covering once per coverer configuration.
+     */
+    const std::vector<S2CellId>& getS2Covering(S2RegionCoverer* coverer) const;
+
+    /**
+     * Returns roughly how many bytes the interior covering and the coverings kept by
+     * getS2Covering() take up.
+     */
+    size_t getApproximateCoveringsSize() const;
+
 private:
     // Parse geospatial query
     // e.g.
@@ -76,6 +107,22 @@ private:
     std::string field;
     std::unique_ptr<GeometryContainer> geoContainer;
     Predicate predicate;
+
+    // Cells lying entirely inside the query geometry, empty unless computeInteriorCovering() was
+    // called.
+    S2CellUnion interiorCovering;
+
+    struct S2Covering {
+        int minLevel;
+        int maxLevel;
+        int levelMod;
+        int maxCells;
+        std::vector<S2CellId> cells;
+    };
+
+    // Coverings computed by getS2Covering(). An expression is only used by one operation at a
+    // time, so these need no locking.
+    mutable std::list<S2Covering> s2Coverings;
 };
 
 class GeoMatchExpression : public LeafMatchExpression {
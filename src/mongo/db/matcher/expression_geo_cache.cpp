@@ -0,0 +1,163 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/expression_geo_cache.h"
+
+#include <iterator>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+namespace {
+
+class GeoExpressionCacheSSM : public ServerStatusMetric {
+public:
+    GeoExpressionCacheSSM() : ServerStatusMetric("query.geoExpressionCache") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        BSONObjBuilder cacheBuilder(b.subobjStart(_leafName));
+        GeoExpressionCache::get().appendStats(&cacheBuilder);
+    }
+} geoExpressionCacheSSM;
+
+}  // namespace
+
+GeoExpressionCache& GeoExpressionCache::get() {
+    // Leaked, so that expressions released during shutdown still have a cache to go back to.
+    static GeoExpressionCache* cache = new GeoExpressionCache();
+    return *cache;
+}
+
+StatusWith<std::shared_ptr<const GeoExpression>> GeoExpressionCache::parse(
+    StringData name, const BSONObj& section) {
+    // Expressions whose key alone puts them over the entry limit are not worth looking up.
+    const size_t keySize = name.size() + 1 + section.objsize();
+    if (internalQueryGeoExpressionCacheMaxBytes.load() <= 0 ||
+        static_cast<long long>(2 * keySize + sizeof(GeoExpression)) >
+            internalQueryGeoExpressionCacheMaxEntryBytes.load()) {
+        auto expr = stdx::make_unique<GeoExpression>(name.toString());
+        auto status = expr->parseFrom(section);
+        if (!status.isOK()) {
+            return status;
+        }
+        return {std::shared_ptr<const GeoExpression>(std::move(expr))};
+    }
+
+    std::string key = name.toString();
+    key.push_back('\0');
+    key.append(section.objdata(), section.objsize());
+
+    std::unique_ptr<GeoExpression> expr;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _index.find(key);
+        if (it != _index.end()) {
+            expr = std::move(it->second->expr);
+            _bytes -= it->second->bytes;
+            _entries.erase(it->second);
+            _index.erase(it);
+        }
+    }
+
+    if (!expr) {
+        expr = stdx::make_unique<GeoExpression>(name.toString());
+        auto status = expr->parseFrom(section);
+        if (!status.isOK()) {
+            return status;
+        }
+        expr->computeInteriorCovering(internalQueryGeoInteriorCoveringMaxCells.load());
+    }
+
+    return {std::shared_ptr<const GeoExpression>(
+        expr.release(),
+        [ this, key = std::move(key) ](GeoExpression * released) { _release(key, released); })};
+}
+
+size_t GeoExpressionCache::_entryBytes(const std::string& key, const GeoExpression& expr) {
+    // The key holds the predicate's BSON, and the parsed geometry is counted as being as large.
+    return 2 * key.size() + sizeof(GeoExpression) + expr.getApproximateCoveringsSize();
+}
+
+void GeoExpressionCache::_release(const std::string& key, GeoExpression* expr) {
+    std::unique_ptr<GeoExpression> owned(expr);
+    const long long maxBytes = internalQueryGeoExpressionCacheMaxBytes.load();
+    const size_t bytes = _entryBytes(key, *owned);
+
+    // Evicted expressions are deleted outside of the mutex.
+    std::list<Entry> evicted;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Drop the expression if the cache is off or the expression is too large. Also drop it if
+    // another caller parsed the same predicate while this one was in use, keeping the cached copy.
+    if (maxBytes <= 0 ||
+        static_cast<long long>(bytes) > internalQueryGeoExpressionCacheMaxEntryBytes.load() ||
+        _index.count(key)) {
+        return;
+    }
+
+    _entries.push_front({key, std::move(owned), bytes});
+    _index[key] = _entries.begin();
+    _bytes += bytes;
+
+    while (_bytes > static_cast<size_t>(maxBytes)) {
+        _index.erase(_entries.back().key);
+        _bytes -= _entries.back().bytes;
+        ++_evictions;
+        evicted.splice(evicted.begin(), _entries, std::prev(_entries.end()));
+    }
+}
+
+size_t GeoExpressionCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+void GeoExpressionCache::clear() {
+    std::list<Entry> entries;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _index.clear();
+    _entries.swap(entries);
+    _bytes = 0;
+}
+
+void GeoExpressionCache::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->appendNumber("entries", static_cast<long long>(_entries.size()));
+    builder->appendNumber("sizeBytes", static_cast<long long>(_bytes));
+    builder->appendNumber("evictions", _evictions);
+}
+
+}  // namespace mongo
@@ -0,0 +1,124 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class GeoExpression;
+
+/**
+ * A least recently used cache of parsed $geoWithin and $geoIntersects predicates, keyed by the
+ * predicate's path and BSON. Reusing a cached GeoExpression saves parsing the query geometry, and
+ * keeps the state S2 builds up for it: the coverings used for index bounds, the interior covering
+ * used to accept points without an exact test, and the edge indexes of large polygons.
+ *
+ * That state is not thread safe, so an expression is handed to one caller at a time. It leaves the
+ * cache when parse() returns it and goes back in when the last reference to it is released. A
+ * caller asking for a predicate whose cached expression is in use gets a newly parsed one.
+ *
+ * The cache is bounded by the approximate memory its idle expressions use, which counts the
+ * parsed geometry as taking as much memory again as its BSON, plus any coverings computed for it.
+ * Expressions larger than internalQueryGeoExpressionCacheMaxEntryBytes are never kept.
+ */
+class GeoExpressionCache {
+    MONGO_DISALLOW_COPYING(GeoExpressionCache);
+
+public:
+    GeoExpressionCache() = default;
+
+    /**
+     * Returns the cache shared by the whole process.
+     */
+    static GeoExpressionCache& get();
+
+    /**
+     * Returns the parsed form of the $geoWithin or $geoIntersects predicate 'section' on the path
+     * 'name', taking it from the cache if an idle copy is there. The cache holds idle expressions
+     * up to internalQueryGeoExpressionCacheMaxBytes.
+     */
+    StatusWith<std::shared_ptr<const GeoExpression>> parse(StringData name,
+                                                           const BSONObj& section);
+
+    /**
+     * Returns the number of idle expressions in the cache.
+     */
+    size_t size() const;
+
+    /**
+     * Deletes every idle expression in the cache.
+     */
+    void clear();
+
+    /**
+     * Appends the number of idle expressions, their approximate size in bytes and the number of
+     * expressions evicted to make room for others, for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::unique_ptr<GeoExpression> expr;
+        size_t bytes;
+    };
+
+    // Returns the approximate memory used by the cache entry for 'expr'.
+    static size_t _entryBytes(const std::string& key, const GeoExpression& expr);
+
+    // Puts an expression handed out by parse() back into the cache.
+    void _release(const std::string& key, GeoExpression* expr);
+
+    mutable stdx::mutex _mutex;
+
+    // Idle expressions, most recently released first.
+    std::list<Entry> _entries;
+    stdx::unordered_map<std::string, std::list<Entry>::iterator> _index;
+
+    // The sum of the sizes of '_entries'.
+    size_t _bytes = 0;
+
+    // The number of expressions evicted to keep the cache within its size.
+    long long _evictions = 0;
+};
+
+}  // namespace mongo
@@ -38,7 +38,12 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_geo_cache.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "third_party/s2/s2latlng.h"
 
 namespace mongo {
 
@@ -184,4 +189,168 @@ TEST(ExpressionGeoTest, GeoNearNotEquivalent) {
         gne2(makeGeoNearMatchExpression(query2));
     ASSERT(!gne1->equivalent(gne2.get()));
 }
+
+/**
+ * Points accepted through the interior covering must be exactly those the exact test accepts.
+ */
+TEST(ExpressionGeoTest, InteriorCoveringAgreesWithExactTest) {
+    const std::vector<BSONObj> queries{
+        fromjson("{$geoWithin: {$geometry: {type: 'Polygon',"
+                 "coordinates: [[[0, 0], [3, 6], [6, 1], [0, 0]]]}}}"),
+        fromjson("{$geoIntersects: {$geometry: {type: 'Polygon',"
+                 "coordinates: [[[0, 0], [3, 6], [6, 1], [0, 0]]]}}}"),
+        fromjson("{$geoWithin: {$geometry: {type: 'MultiPolygon', coordinates: ["
+                 "[[[0, 0], [2, 0], [2, 2], [0, 2], [0, 0]]],"
+                 "[[[2.2, 2.2], [6, 2.2], [6, 6], [2.2, 6], [2.2, 2.2]]]]}}}"),
+        fromjson("{$geoWithin: {$centerSphere: [[3, 3], 0.04]}}")};
+
+    for (const auto& query : queries) {
+        std::unique_ptr<GeoMatchExpression> exact(makeGeoMatchExpression(query));
+
+        auto gq = stdx::make_unique<GeoExpression>();
+        ASSERT_OK(gq->parseFrom(query));
+        gq->computeInteriorCovering(64);
+        GeoMatchExpression prepared("a", gq.release(), query);
+
+        int numInterior = 0;
+        for (double lng = -1; lng <= 7; lng += 0.05) {
+            for (double lat = -1; lat <= 7; lat += 0.05) {
+                BSONObj doc = BSON("a" << BSON_ARRAY(lng << lat));
+                ASSERT_EQUALS(exact->matchesBSON(doc), prepared.matchesBSON(doc)) << query << doc;
+
+                S2Point point = S2LatLng::FromDegrees(lat, lng).ToPoint();
+                numInterior += prepared.getGeoExpression().interiorContains(point);
+            }
+        }
+        ASSERT_GREATER_THAN(numInterior, 0) << query;
+    }
+}
+
+/**
+ * Planar queries have no interior covering.
+ */
+TEST(ExpressionGeoTest, NoInteriorCoveringForFlatGeometry) {
+    GeoExpression gq;
+    ASSERT_OK(gq.parseFrom(fromjson("{$within: {$box: [[0, 0], [6, 6]]}}")));
+    gq.computeInteriorCovering(64);
+    ASSERT(!gq.interiorContains(S2LatLng::FromDegrees(3, 3).ToPoint()));
+}
+
+TEST(ExpressionGeoTest, GeoExpressionCacheReusesIdleExpressions) {
+    auto& cache = GeoExpressionCache::get();
+    cache.clear();
+
+    BSONObj query = fromjson(
+        "{$geoWithin: {$geometry: {type: 'Polygon',"
+        "coordinates: [[[0, 0], [3, 6], [6, 1], [0, 0]]]}}}");
+
+    const GeoExpression* parsed;
+    {
+        auto swExpr = cache.parse("a", query);
+        ASSERT_OK(swExpr.getStatus());
+        parsed = swExpr.getValue().get();
+        ASSERT_EQUALS(0U, cache.size());
+
+        // The cached expression is in use, so another caller gets its own.
+        auto swOther = cache.parse("a", query);
+        ASSERT_OK(swOther.getStatus());
+        ASSERT_NOT_EQUALS(parsed, swOther.getValue().get());
+    }
+    ASSERT_EQUALS(1U, cache.size());
+
+    {
+        auto swExpr = cache.parse("a", query);
+        ASSERT_OK(swExpr.getStatus());
+        parsed = swExpr.getValue().get();
+        ASSERT_EQUALS(0U, cache.size());
+    }
+
+    auto swExpr = cache.parse("a", query);
+    ASSERT_OK(swExpr.getStatus());
+    ASSERT_EQUALS(parsed, swExpr.getValue().get());
+
+    // The same geometry on another path is a different predicate.
+    auto swOtherPath = cache.parse("b", query);
+    ASSERT_OK(swOtherPath.getStatus());
+    ASSERT_NOT_EQUALS(parsed, swOtherPath.getValue().get());
+    ASSERT_EQUALS("b", swOtherPath.getValue()->getField());
+
+    ASSERT_NOT_OK(
+        cache.parse("a", fromjson("{$geoWithin: {$geometry: {type: 'Polygon'}}}")).getStatus());
+    cache.clear();
+}
+
+BSONObj geoExpressionCacheStats() {
+    BSONObjBuilder builder;
+    GeoExpressionCache::get().appendStats(&builder);
+    return builder.obj();
+}
+
+// A triangle whose BSON has the same size for every single digit 'x'.
+BSONObj triangleQuery(int x) {
+    return fromjson(str::stream() << "{$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+                                  << "[[[0, 0], [" << x << ", 6], [6, 1], [0, 0]]]}}}");
+}
+
+TEST(ExpressionGeoTest, GeoExpressionCacheEvictsLeastRecentlyUsedBeyondMaxBytes) {
+    auto& cache = GeoExpressionCache::get();
+    cache.clear();
+    const long long oldMaxBytes = internalQueryGeoExpressionCacheMaxBytes.load();
+    const int oldMaxCells = internalQueryGeoInteriorCoveringMaxCells.load();
+    ON_BLOCK_EXIT([oldMaxBytes, oldMaxCells] {
+        internalQueryGeoExpressionCacheMaxBytes.store(oldMaxBytes);
+        internalQueryGeoInteriorCoveringMaxCells.store(oldMaxCells);
+        GeoExpressionCache::get().clear();
+    });
+
+    // Without interior coverings, every triangle's entry has the same size.
+    internalQueryGeoInteriorCoveringMaxCells.store(0);
+
+    ASSERT_OK(cache.parse("a", triangleQuery(1)).getStatus());
+    const long long entryBytes = geoExpressionCacheStats()["sizeBytes"].numberLong();
+    ASSERT_GT(entryBytes, triangleQuery(1).objsize());
+
+    // Room for two of the triangles, but not for three.
+    internalQueryGeoExpressionCacheMaxBytes.store(2 * entryBytes + entryBytes / 2);
+    const long long evictions = geoExpressionCacheStats()["evictions"].numberLong();
+    ASSERT_OK(cache.parse("a", triangleQuery(2)).getStatus());
+    ASSERT_OK(cache.parse("a", triangleQuery(3)).getStatus());
+
+    BSONObj stats = geoExpressionCacheStats();
+    ASSERT_EQUALS(2, stats["entries"].numberLong());
+    ASSERT_LTE(stats["sizeBytes"].numberLong(), internalQueryGeoExpressionCacheMaxBytes.load());
+    ASSERT_EQUALS(evictions + 1, stats["evictions"].numberLong());
+
+    // The first triangle was evicted, the other two are still cached.
+    {
+        auto swFirst = cache.parse("a", triangleQuery(1));
+        ASSERT_OK(swFirst.getStatus());
+        ASSERT_EQUALS(2U, cache.size());
+        auto swThird = cache.parse("a", triangleQuery(3));
+        ASSERT_OK(swThird.getStatus());
+        ASSERT_EQUALS(1U, cache.size());
+        auto swSecond = cache.parse("a", triangleQuery(2));
+        ASSERT_OK(swSecond.getStatus());
+        ASSERT_EQUALS(0U, cache.size());
+    }
+}
+
+TEST(ExpressionGeoTest, GeoExpressionCacheSkipsExpressionsAboveMaxEntryBytes) {
+    auto& cache = GeoExpressionCache::get();
+    cache.clear();
+    const long long oldMaxEntryBytes = internalQueryGeoExpressionCacheMaxEntryBytes.load();
+    ON_BLOCK_EXIT([oldMaxEntryBytes] {
+        internalQueryGeoExpressionCacheMaxEntryBytes.store(oldMaxEntryBytes);
+        GeoExpressionCache::get().clear();
+    });
+
+    internalQueryGeoExpressionCacheMaxEntryBytes.store(triangleQuery(1).objsize());
+    ASSERT_OK(cache.parse("a", triangleQuery(1)).getStatus());
+    ASSERT_EQUALS(0U, cache.size());
+    ASSERT_EQUALS(0, geoExpressionCacheStats()["sizeBytes"].numberLong());
+
+    internalQueryGeoExpressionCacheMaxEntryBytes.store(oldMaxEntryBytes);
+    ASSERT_OK(cache.parse("a", triangleQuery(1)).getStatus());
+    ASSERT_EQUALS(1U, cache.size());
+}
 }
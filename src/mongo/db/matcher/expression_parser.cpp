@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_expr.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_geo_cache.h"
 #include "mongo/db/matcher/expression_internal_expr_eq.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_tree.h"
@@ -1101,12 +1102,11 @@ StatusWithMatchExpression parseGeo(StringData name,
                                    const BSONObj& section,
                                    MatchExpressionParser::AllowedFeatureSet allowedFeatures) {
     if (PathAcceptingKeyword::WITHIN == type || PathAcceptingKeyword::GEO_INTERSECTS == type) {
-        auto gq = stdx::make_unique<GeoExpression>(name.toString());
-        auto parseStatus = gq->parseFrom(section);
-        if (!parseStatus.isOK()) {
-            return parseStatus;
+        auto gq = GeoExpressionCache::get().parse(name, section);
+        if (!gq.isOK()) {
+            return gq.getStatus();
         }
-        return {stdx::make_unique<GeoMatchExpression>(name, gq.release(), section)};
+        return {stdx::make_unique<GeoMatchExpression>(name, std::move(gq.getValue()), section)};
     } else {
         invariant(PathAcceptingKeyword::GEO_NEAR == type);
 
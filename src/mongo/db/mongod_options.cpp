@@ -305,6 +305,14 @@ Status addMongodOptions(moe::OptionSection* options) {
             "the path to the local keyfile")
         .requires("security.enableEncryption");
 
+    encryption_options
+        .addOptionChaining(
+            "security.encryptionRotateKeyFile",
+            "encryptionRotateKeyFile",
+            moe::String,
+            "the path to a new local keyfile to re-encrypt the keys database with at startup")
+        .requires("security.encryptionKeyFile");
+
     // Replication Options
 
     replication_options.addOptionChaining(
@@ -852,6 +860,11 @@ Status storeMongodOptions(const moe::Environment& params) {
         encryptionGlobalParams.encryptionKeyFile = params["security.encryptionKeyFile"].as<std::string>();
     }
 
+    if (params.count("security.encryptionRotateKeyFile")) {
+        encryptionGlobalParams.encryptionRotateKeyFile =
+            params["security.encryptionRotateKeyFile"].as<std::string>();
+    }
+
     if (params.count("cpu")) {
         serverGlobalParams.cpu = params["cpu"].as<bool>();
     }
@@ -119,6 +119,24 @@ public:
                           StmtId stmtId,
                           bool fromMigrate,
                           const boost::optional<BSONObj>& deletedDoc) = 0;
+    /**
+     * Handles logging for a batch of deletes, made in one WriteUnitOfWork. Each DeleteStatement
+     * holds the whole deleted document; a non-null oplog slot is the optime to log the delete at.
+     *
+     * Observers that do not log deletes in batches observe each one in turn, exactly as
+     * aboutToDelete() followed by onDelete().
+     */
+    virtual void onDeletes(OperationContext* opCtx,
+                           const NamespaceString& nss,
+                           OptionalCollectionUUID uuid,
+                           std::vector<DeleteStatement>::const_iterator begin,
+                           std::vector<DeleteStatement>::const_iterator end,
+                           bool fromMigrate) {
+        for (auto it = begin; it != end; ++it) {
+            aboutToDelete(opCtx, nss, it->doc);
+            onDelete(opCtx, nss, uuid, it->stmtId, fromMigrate, boost::none);
+        }
+    }
     /**
      * Logs a no-op with "msgObj" in the o field into oplog.
      *
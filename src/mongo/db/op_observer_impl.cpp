@@ -574,6 +574,78 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
     }
 }
 
+void OpObserverImpl::onDeletes(OperationContext* opCtx,
+                               const NamespaceString& nss,
+                               OptionalCollectionUUID uuid,
+                               std::vector<DeleteStatement>::const_iterator first,
+                               std::vector<DeleteStatement>::const_iterator last,
+                               bool fromMigrate) {
+    auto txnParticipant = TransactionParticipant::get(opCtx);
+    const bool inMultiDocumentTransaction = txnParticipant && opCtx->writesAreReplicated() &&
+        txnParticipant->inMultiDocumentTransaction();
+    if (inMultiDocumentTransaction) {
+        // Transaction operations are logged at commit, one at a time.
+        OpObserver::onDeletes(opCtx, nss, uuid, first, last, fromMigrate);
+        return;
+    }
+
+    std::vector<BSONObj> documentKeys;
+    for (auto it = first; it != last; it++) {
+        documentKeys.push_back(getDocumentKey(opCtx, nss, it->doc));
+    }
+
+    const Date_t lastWriteDate = getWallClockTimeForOpLog(opCtx);
+    Session* const session = OperationContextSession::get(opCtx);
+    const std::vector<repl::OpTime> opTimeList = repl::logDeleteOps(
+        opCtx, nss, uuid, session, first, last, documentKeys, fromMigrate, lastWriteDate);
+    repl::OpTime lastOpTime;
+    if (!opTimeList.empty())
+        lastOpTime = opTimeList.back();
+
+    auto& times = OpObserver::Times::get(opCtx).reservedOpTimes;
+    using std::begin;
+    using std::end;
+    times.insert(end(times), begin(opTimeList), end(opTimeList));
+
+    std::vector<StmtId> stmtIdsWritten;
+    std::transform(first,
+                   last,
+                   std::back_inserter(stmtIdsWritten),
+                   [](const DeleteStatement& stmt) { return stmt.stmtId; });
+
+    onWriteOpCompleted(opCtx, nss, session, stmtIdsWritten, lastOpTime, lastWriteDate, boost::none);
+
+    size_t index = 0;
+    for (auto it = first; it != last; it++, index++) {
+        const BSONObj& documentKey = documentKeys[index];
+        AuthorizationManager::get(opCtx->getServiceContext())
+            ->logOp(opCtx, "d", nss, documentKey, nullptr);
+
+        if (nss != NamespaceString::kSessionTransactionsTableNamespace && !fromMigrate) {
+            auto opTime = opTimeList.empty() ? repl::OpTime() : opTimeList[index];
+            shardObserveAboutToDelete(opCtx, nss, it->doc);
+            shardObserveDeleteOp(opCtx, nss, documentKey, opTime, repl::OpTime(), false);
+        }
+    }
+
+    if (nss.coll() == "system.js") {
+        Scope::storedFuncMod(opCtx);
+    } else if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
+        DurableViewCatalog::onExternalChange(opCtx, nss);
+    } else if (nss.isServerConfigurationCollection()) {
+        for (const auto& documentKey : documentKeys) {
+            auto _id = documentKey["_id"];
+            if (_id.type() == BSONType::String &&
+                _id.String() == FeatureCompatibilityVersionParser::kParameterName)
+                uasserted(40670, "removing FeatureCompatibilityVersion document is not allowed");
+        }
+    } else if (nss == NamespaceString::kSessionTransactionsTableNamespace && !lastOpTime.isNull()) {
+        for (const auto& documentKey : documentKeys) {
+            MongoDSessionCatalog::invalidateSessions(opCtx, documentKey);
+        }
+    }
+}
+
 void OpObserverImpl::onInternalOpMessage(OperationContext* opCtx,
                                          const NamespaceString& nss,
                                          const boost::optional<UUID> uuid,
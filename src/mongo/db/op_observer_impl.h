@@ -62,6 +62,12 @@ public:
                   StmtId stmtId,
                   bool fromMigrate,
                   const boost::optional<BSONObj>& deletedDoc) final;
+    void onDeletes(OperationContext* opCtx,
+                   const NamespaceString& nss,
+                   OptionalCollectionUUID uuid,
+                   std::vector<DeleteStatement>::const_iterator begin,
+                   std::vector<DeleteStatement>::const_iterator end,
+                   bool fromMigrate) final;
     void onInternalOpMessage(OperationContext* opCtx,
                              const NamespaceString& nss,
                              const boost::optional<UUID> uuid,
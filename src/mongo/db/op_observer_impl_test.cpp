@@ -553,6 +553,40 @@ TEST_F(OpObserverTest, MultipleAboutToDeleteAndOnDelete) {
     opObserver.onDelete(opCtx.get(), nss, uuid, {}, false, {});
 }
 
+TEST_F(OpObserverTest, OnDeletesLogsEachDeleteAtItsReservedSlot) {
+    auto uuid = UUID::gen();
+    OpObserverImpl opObserver;
+    auto opCtx = cc().makeOperationContext();
+    NamespaceString nss = {"test", "coll"};
+
+    std::vector<OplogSlot> slots;
+    {
+        AutoGetDb autoDb(opCtx.get(), nss.db(), MODE_X);
+        WriteUnitOfWork wunit(opCtx.get());
+        slots = repl::getNextOpTimes(opCtx.get(), 3);
+        std::vector<DeleteStatement> deletes;
+        for (int i = 0; i < 3; ++i) {
+            deletes.emplace_back(kUninitializedStmtId, BSON("_id" << i << "x" << i), slots[i]);
+        }
+        opObserver.onDeletes(opCtx.get(), nss, uuid, deletes.cbegin(), deletes.cend(), false);
+        ASSERT_EQUALS(3U, OpObserver::Times::get(opCtx.get()).reservedOpTimes.size());
+        wunit.commit();
+    }
+
+    // The oplog is read newest entry first. Each entry holds the key of its document only.
+    repl::OplogInterfaceLocal oplogInterface(opCtx.get(), NamespaceString::kRsOplogNamespace.ns());
+    auto oplogIter = oplogInterface.makeIterator();
+    for (int i = 2; i >= 0; --i) {
+        auto oplogEntry = unittest::assertGet(oplogIter->next()).first;
+        ASSERT_EQUALS("d", oplogEntry.getStringField("op"));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), oplogEntry.getObjectField("o"));
+        ASSERT_EQUALS(slots[i].opTime.getTimestamp(), oplogEntry["ts"].timestamp());
+    }
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogIter->next().getStatus());
+
+    ASSERT_EQUALS(repl::ReplClientInfo::forClient(&cc()).getLastOp(), slots.back().opTime);
+}
+
 DEATH_TEST_F(OpObserverTest, AboutToDeleteMustPreceedOnDelete, "invariant") {
     OpObserverImpl opObserver;
     auto opCtx = cc().makeOperationContext();
@@ -104,6 +104,17 @@ public:
             o->onDelete(opCtx, nss, uuid, stmtId, fromMigrate, deletedDoc);
     }
 
+    void onDeletes(OperationContext* const opCtx,
+                   const NamespaceString& nss,
+                   OptionalCollectionUUID uuid,
+                   std::vector<DeleteStatement>::const_iterator begin,
+                   std::vector<DeleteStatement>::const_iterator end,
+                   bool fromMigrate) override {
+        ReservedTimes times{opCtx};
+        for (auto& o : _observers)
+            o->onDeletes(opCtx, nss, uuid, begin, end, fromMigrate);
+    }
+
     void onInternalOpMessage(OperationContext* const opCtx,
                              const NamespaceString& nss,
                              const boost::optional<UUID> uuid,
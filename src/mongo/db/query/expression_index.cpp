@@ -37,6 +37,7 @@
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
+#include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
 #include "third_party/s2/s2cellid.h"
@@ -110,7 +111,8 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+namespace {
+void configure2dsphereCoverer(S2RegionCoverer* coverer) {
     auto minLevel = internalQueryS2GeoCoarsestLevel.load();
     auto maxLevel = internalQueryS2GeoFinestLevel.load();
 
@@ -118,10 +120,15 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
 
+    coverer->set_min_level(minLevel);
+    coverer->set_max_level(maxLevel);
+    coverer->set_max_cells(internalQueryS2GeoMaxCells.load());
+}
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
     S2RegionCoverer coverer;
-    coverer.set_min_level(minLevel);
-    coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(internalQueryS2GeoMaxCells.load());
+    configure2dsphereCoverer(&coverer);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
@@ -135,6 +142,14 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const GeoExpression& expr,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    S2RegionCoverer coverer;
+    configure2dsphereCoverer(&coverer);
+    S2CellIdsToIntervalsWithParents(expr.getS2Covering(&coverer), indexingParams, oilOut);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
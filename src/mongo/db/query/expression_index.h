@@ -43,6 +43,8 @@ class S2Region;
 
 namespace mongo {
 
+class GeoExpression;
+
 /**
  * Functions that compute expression index mappings.
  *
@@ -79,6 +81,12 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    // Same as above for the geometry of 'expr', reusing the covering kept with the expression if
+    // it was already computed with the current covering parameters.
+    static void cover2dsphere(const GeoExpression& expr,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
@@ -109,6 +109,10 @@ MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDeleteMaxBatchSize,
+                              int,
+                              internalQueryExecYieldIterations.load() / 2);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
@@ -118,4 +122,16 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitBlockingMergeOnMongoS, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileMatchExpressions, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryTextTopK, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGeoExpressionCacheMaxBytes, long long, 32 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGeoExpressionCacheMaxEntryBytes, long long, 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGeoInteriorCoveringMaxCells, int, 32);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryGeoNearMaxBufferedBytes, long long, 100 * 1024 * 1024);
 }  // namespace mongo
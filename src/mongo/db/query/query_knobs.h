@@ -134,9 +134,34 @@ extern AtomicInt64 internalDocumentSourceGroupMaxMemoryBytes;
 
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// The most documents a multi-delete removes in one WriteUnitOfWork.
+extern AtomicInt32 internalDeleteMaxBatchSize;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
+
+// Flatten collection scan filters into a CompiledMatchExpression.
+extern AtomicBool internalQueryCompileMatchExpressions;
+
+// Let a $text query sorted by text score with a limit stop reading the index once its top results
+// are known.
+extern AtomicBool internalQueryTextTopK;
+
+// The most memory used to keep parsed $geoWithin and $geoIntersects predicates for reuse by later
+// queries with the same geometry. Zero disables the cache.
+extern AtomicInt64 internalQueryGeoExpressionCacheMaxBytes;
+
+// The most memory a single predicate may use and still be kept in the geo expression cache. Larger
+// geometries are parsed again for every query rather than pushing many smaller ones out.
+extern AtomicInt64 internalQueryGeoExpressionCacheMaxEntryBytes;
+
+// The most cells used to approximate the inside of a cached $geoWithin or $geoIntersects geometry.
+// Points in those cells match without an exact geometry test. Zero disables the approximation.
+extern AtomicInt32 internalQueryGeoInteriorCoveringMaxCells;
+
+// The most memory a near search may use to buffer documents before returning them in order.
+extern AtomicInt64 internalQueryGeoNearMaxBufferedBytes;
 }  // namespace mongo
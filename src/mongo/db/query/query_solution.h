@@ -279,6 +279,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, the parent of this node is a SORT by text score with this limit, so only the
+    // 'topK' documents with the highest text scores are needed.
+    size_t topK = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -503,14 +503,24 @@ OpTime logOp(OperationContext* opCtx,
     return slot.opTime;
 }
 
-std::vector<OpTime> logInsertOps(OperationContext* opCtx,
-                                 const NamespaceString& nss,
-                                 OptionalCollectionUUID uuid,
-                                 Session* session,
-                                 std::vector<InsertStatement>::const_iterator begin,
-                                 std::vector<InsertStatement>::const_iterator end,
-                                 bool fromMigrate,
-                                 Date_t wallClockTime) {
+namespace {
+
+/**
+ * Writes one 'opstr' oplog entry per statement in [begin, end) with a single insert into the oplog.
+ * 'getObj' returns the "o" field of the i-th entry. Statements that carry an oplog slot are logged
+ * at that slot; the others get a new one.
+ */
+template <typename StatementIt, typename GetObj>
+std::vector<OpTime> logStatements(OperationContext* opCtx,
+                                  const char* opstr,
+                                  const NamespaceString& nss,
+                                  OptionalCollectionUUID uuid,
+                                  Session* session,
+                                  StatementIt begin,
+                                  StatementIt end,
+                                  GetObj getObj,
+                                  bool fromMigrate,
+                                  Date_t wallClockTime) {
     invariant(begin != end);
 
     auto replCoord = ReplicationCoordinator::get(opCtx);
@@ -553,30 +563,30 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
     std::vector<OpTime> opTimes;
     for (size_t i = 0; i < count; i++) {
         // Make a mutable copy.
-        auto insertStatementOplogSlot = begin[i].oplogSlot;
+        auto statementOplogSlot = begin[i].oplogSlot;
         // Fetch optime now, if not already fetched.
-        if (insertStatementOplogSlot.opTime.isNull()) {
-            _getNextOpTimes(opCtx, oplog, 1, &insertStatementOplogSlot);
+        if (statementOplogSlot.opTime.isNull()) {
+            _getNextOpTimes(opCtx, oplog, 1, &statementOplogSlot);
         }
         // Only 'applyOps' oplog entries can be prepared.
         constexpr bool prepare = false;
         writers.emplace_back(_logOpWriter(opCtx,
-                                          "i",
+                                          opstr,
                                           nss,
                                           uuid,
-                                          begin[i].doc,
+                                          getObj(i),
                                           NULL,
                                           fromMigrate,
-                                          insertStatementOplogSlot.opTime,
-                                          insertStatementOplogSlot.hash,
+                                          statementOplogSlot.opTime,
+                                          statementOplogSlot.hash,
                                           wallClockTime,
                                           sessionInfo,
                                           begin[i].stmtId,
                                           oplogLink,
                                           prepare));
-        oplogLink.prevOpTime = insertStatementOplogSlot.opTime;
+        oplogLink.prevOpTime = statementOplogSlot.opTime;
         timestamps[i] = oplogLink.prevOpTime.getTimestamp();
-        opTimes.push_back(insertStatementOplogSlot.opTime);
+        opTimes.push_back(statementOplogSlot.opTime);
     }
 
     MONGO_FAIL_POINT_BLOCK(sleepBetweenInsertOpTimeGenerationAndLogOp, customWait) {
@@ -600,6 +610,50 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
     return opTimes;
 }
 
+}  // namespace
+
+std::vector<OpTime> logInsertOps(OperationContext* opCtx,
+                                 const NamespaceString& nss,
+                                 OptionalCollectionUUID uuid,
+                                 Session* session,
+                                 std::vector<InsertStatement>::const_iterator begin,
+                                 std::vector<InsertStatement>::const_iterator end,
+                                 bool fromMigrate,
+                                 Date_t wallClockTime) {
+    return logStatements(opCtx,
+                         "i",
+                         nss,
+                         uuid,
+                         session,
+                         begin,
+                         end,
+                         [&](size_t i) -> const BSONObj& { return begin[i].doc; },
+                         fromMigrate,
+                         wallClockTime);
+}
+
+std::vector<OpTime> logDeleteOps(OperationContext* opCtx,
+                                 const NamespaceString& nss,
+                                 OptionalCollectionUUID uuid,
+                                 Session* session,
+                                 std::vector<DeleteStatement>::const_iterator begin,
+                                 std::vector<DeleteStatement>::const_iterator end,
+                                 const std::vector<BSONObj>& documentKeys,
+                                 bool fromMigrate,
+                                 Date_t wallClockTime) {
+    invariant(documentKeys.size() == static_cast<size_t>(end - begin));
+    return logStatements(opCtx,
+                         "d",
+                         nss,
+                         uuid,
+                         session,
+                         begin,
+                         end,
+                         [&](size_t i) -> const BSONObj& { return documentKeys[i]; },
+                         fromMigrate,
+                         wallClockTime);
+}
+
 namespace {
 long long getNewOplogSizeBytes(OperationContext* opCtx, const ReplSettings& replSettings) {
     if (replSettings.getOplogSizeBytes() != 0) {
@@ -75,6 +75,18 @@ public:
     BSONObj doc;
 };
 
+struct DeleteStatement {
+public:
+    DeleteStatement() = default;
+    DeleteStatement(StmtId statementId, BSONObj toDelete, OplogSlot os)
+        : stmtId(statementId), oplogSlot(os), doc(toDelete) {}
+
+    StmtId stmtId = kUninitializedStmtId;
+    OplogSlot oplogSlot;
+    // The whole document being deleted, not just its key.
+    BSONObj doc;
+};
+
 namespace repl {
 class ReplSettings;
 
@@ -111,6 +123,21 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
                                  bool fromMigrate,
                                  Date_t wallClockTime);
 
+/**
+ * Log delete(s) to the local oplog, with one write to the oplog collection.
+ * 'documentKeys' holds the "o" field of each entry, in the order of [begin, end).
+ * Returns the OpTime of every delete.
+ */
+std::vector<OpTime> logDeleteOps(OperationContext* opCtx,
+                                 const NamespaceString& nss,
+                                 OptionalCollectionUUID uuid,
+                                 Session* session,
+                                 std::vector<DeleteStatement>::const_iterator begin,
+                                 std::vector<DeleteStatement>::const_iterator end,
+                                 const std::vector<BSONObj>& documentKeys,
+                                 bool fromMigrate,
+                                 Date_t wallClockTime);
+
 /**
  * @param opstr
  *  "i" insert
@@ -42,6 +42,19 @@ Status InMemoryGlobalOptions::add(moe::OptionSection* options) {
                            moe::Double,
                            "The maximum memory in gigabytes to use for InMemory storage. "
                            "See documentation for default.");
+    inMemoryOptions.addOptionChaining("storage.inMemory.engineConfig.overflowToDisk",
+                                      "inMemoryOverflowToDisk",
+                                      moe::Switch,
+                                      "Evict the least recently used data to local disk instead "
+                                      "of failing writes once inMemorySizeGB is reached. The "
+                                      "data is still discarded at restart.");
+    inMemoryOptions.addOptionChaining("storage.inMemory.engineConfig.overflowPath",
+                                      "inMemoryOverflowPath",
+                                      moe::String,
+                                      "The directory to evict data to with inMemoryOverflowToDisk. "
+                                      "Must be empty or previously used for overflow files, and "
+                                      "is emptied at startup. Defaults to a directory in the "
+                                      "dbpath.");
 
     // hidden options
     inMemoryOptions
@@ -88,6 +101,14 @@ Status InMemoryGlobalOptions::store(const moe::Environment& params,
         inMemoryGlobalOptions.statisticsLogDelaySecs =
             params["storage.inMemory.engineConfig.statisticsLogDelaySecs"].as<int>();
     }
+    if (params.count("storage.inMemory.engineConfig.overflowToDisk")) {
+        inMemoryGlobalOptions.overflowToDisk =
+            params["storage.inMemory.engineConfig.overflowToDisk"].as<bool>();
+    }
+    if (params.count("storage.inMemory.engineConfig.overflowPath")) {
+        inMemoryGlobalOptions.overflowPath =
+            params["storage.inMemory.engineConfig.overflowPath"].as<std::string>();
+    }
 
     // hidden options
     if (params.count("storage.inMemory.engineConfig.configString")) {
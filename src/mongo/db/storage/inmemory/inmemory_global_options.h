@@ -31,7 +31,7 @@ namespace moe = mongo::optionenvironment;
 
 class InMemoryGlobalOptions {
 public:
-    InMemoryGlobalOptions() : cacheSizeGB(0), statisticsLogDelaySecs(0) {}
+    InMemoryGlobalOptions() : cacheSizeGB(0), statisticsLogDelaySecs(0), overflowToDisk(false) {}
 
     Status add(moe::OptionSection* options);
     Status store(const moe::Environment& params, const std::vector<std::string>& args);
@@ -39,6 +39,12 @@ public:
     double cacheSizeGB;
     size_t statisticsLogDelaySecs;
 
+    // When set, pages that do not fit into inMemorySizeGB are evicted to files in overflowPath
+    // (by default a directory in the dbpath) instead of failing writes. These files are not
+    // durable and are discarded at restart.
+    bool overflowToDisk;
+    std::string overflowPath;
+
     std::string engineConfig;
     std::string collectionConfig;
     std::string indexConfig;
@@ -24,6 +24,10 @@ Copyright (c) 2006, 2016, Percona and/or its affiliates. All rights reserved.
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+#include <vector>
+
 #include "mongo/base/init.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/jsobj.h"
@@ -40,12 +44,103 @@ Copyright (c) 2006, 2016, Percona and/or its affiliates. All rights reserved.
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_server_status.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 namespace {
 const std::string kInMemoryEngineName = "inMemory";
+const std::string kOverflowDirName = "inMemoryOverflow";
+
+// Written into an overflow directory when it is first used. Only directories holding this marker
+// are ever emptied, so a mistyped overflow path can't wipe out an unrelated directory.
+const std::string kOverflowMarkerFileName = ".inMemoryOverflow";
+
+// How long serverStatus reuses the measured size of the overflow files before walking the
+// overflow directory again.
+const Seconds kOverflowBytesOnDiskRefreshInterval{10};
+
+/**
+ * Adds the "overflow" subsection to the "inMemory" section of db.serverStatus(). The statistics
+ * come from the WiredTiger cache section: a page read into the cache while overflowing to disk is
+ * a page that was evicted to the overflow files before.
+ */
+class InMemoryServerStatusSection : public WiredTigerServerStatusSection {
+public:
+    InMemoryServerStatusSection(WiredTigerKVEngine* engine, std::string overflowPath)
+        : WiredTigerServerStatusSection(engine), _overflowPath(std::move(overflowPath)) {}
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObj section = WiredTigerServerStatusSection::generateSection(opCtx, configElement);
+
+        BSONObjBuilder bob;
+        bob.appendElements(section);
+
+        BSONObjBuilder overflow(bob.subobjStart("overflow"));
+        overflow.appendBool("enabled", !_overflowPath.empty());
+        if (!_overflowPath.empty()) {
+            const BSONObj cache = section.getObjectField("cache");
+            const long long requested =
+                cache.getField("pages requested from the cache").safeNumberLong();
+            const long long readIn = cache.getField("pages read into cache").safeNumberLong();
+
+            overflow.append("path", _overflowPath);
+            overflow.append("cacheHitRatio",
+                            requested > 0 ? 1.0 - static_cast<double>(readIn) / requested : 1.0);
+            overflow.append("pagesReadFromDisk", readIn);
+            overflow.append("bytesReadFromDisk",
+                            cache.getField("bytes read into cache").safeNumberLong());
+            overflow.append("pagesWrittenToDisk",
+                            cache.getField("pages written from cache").safeNumberLong());
+            overflow.append("bytesWrittenToDisk",
+                            cache.getField("bytes written from cache").safeNumberLong());
+            overflow.append("bytesOnDisk", _overflowBytesOnDisk());
+        }
+        overflow.done();
+
+        return bob.obj();
+    }
+
+private:
+    /**
+     * Returns the total size of the overflow files. serverStatus is sampled every second by FTDC,
+     * so the directory is only walked again once the previous measurement has aged.
+     */
+    long long _overflowBytesOnDisk() const {
+        const auto now = Date_t::now();
+        stdx::lock_guard<stdx::mutex> lk(_bytesOnDiskMutex);
+        if (now < _bytesOnDiskMeasuredAt + kOverflowBytesOnDiskRefreshInterval) {
+            return _bytesOnDisk;
+        }
+
+        _bytesOnDisk = _measureOverflowBytesOnDisk();
+        _bytesOnDiskMeasuredAt = now;
+        return _bytesOnDisk;
+    }
+
+    long long _measureOverflowBytesOnDisk() const {
+        namespace fs = boost::filesystem;
+        long long bytes = 0;
+        boost::system::error_code ec;
+        for (fs::recursive_directory_iterator it(_overflowPath, ec), end; !ec && it != end;
+             it.increment(ec)) {
+            if (fs::is_regular_file(it->status())) {
+                bytes += fs::file_size(it->path(), ec);
+            }
+        }
+        return bytes;
+    }
+
+    const std::string _overflowPath;
+
+    mutable stdx::mutex _bytesOnDiskMutex;
+    mutable long long _bytesOnDisk = 0;
+    mutable Date_t _bytesOnDiskMeasuredAt;
+};
 
 class InMemoryFactory : public StorageEngine::Factory {
 public:
@@ -54,12 +149,22 @@ public:
                                   const StorageEngineLockFile*) const {
         syncInMemoryAndWiredTigerOptions();
 
+        // Without overflow WiredTiger runs with in_memory=true and writes nothing under dbpath.
+        // With overflow it runs as a regular unlogged, never checkpointed database in a scratch
+        // directory, so evicted pages are spilled to disk and are thrown away at restart.
+        std::string overflowPath;
+        if (inMemoryGlobalOptions.overflowToDisk) {
+            overflowPath = prepareOverflowPath(params);
+            log() << "inMemory engine will overflow to " << overflowPath;
+        }
+
+        const std::string& path = overflowPath.empty() ? params.dbpath : overflowPath;
         size_t cacheMB = WiredTigerUtil::getCacheSizeMB(wiredTigerGlobalOptions.cacheSizeGB);
         const bool durable = false;
         const bool ephemeral = true;
         const bool readOnly = false;
         WiredTigerKVEngine* kv = new WiredTigerKVEngine(getCanonicalName().toString(),
-                                                        params.dbpath,
+                                                        path,
                                                         getGlobalServiceContext()->getFastClockSource(),
                                                         wiredTigerGlobalOptions.engineConfig,
                                                         cacheMB,
@@ -70,7 +175,7 @@ public:
         kv->setRecordStoreExtraOptions(wiredTigerGlobalOptions.collectionConfig);
         kv->setSortedDataInterfaceExtraOptions(wiredTigerGlobalOptions.indexConfig);
         // Intentionally leaked.
-        new WiredTigerServerStatusSection(kv);
+        new InMemoryServerStatusSection(kv, overflowPath);
 
         KVStorageEngineOptions options;
         options.directoryPerDB = params.directoryperdb;
@@ -121,6 +226,61 @@ public:
     }
 
 private:
+    /**
+     * Returns the directory to keep the overflow files in, creating it or removing whatever a
+     * previous run left there. Only an empty directory, or one holding the overflow marker file,
+     * is accepted. Anything else is refused rather than emptied.
+     */
+    static std::string prepareOverflowPath(const StorageGlobalParams& params) {
+        namespace fs = boost::filesystem;
+        fs::path path = inMemoryGlobalOptions.overflowPath;
+        if (path.empty()) {
+            path = fs::path(params.dbpath) / kOverflowDirName;
+        }
+
+        const fs::path marker = path / kOverflowMarkerFileName;
+        try {
+            if (!fs::exists(path)) {
+                fs::create_directories(path);
+            } else {
+                uassert(ErrorCodes::InvalidOptions,
+                        str::stream() << "inMemoryOverflowPath " << path.string()
+                                      << " is not a directory",
+                        fs::is_directory(path));
+                uassert(ErrorCodes::InvalidOptions,
+                        str::stream() << "inMemoryOverflowPath " << path.string()
+                                      << " is not empty and has no "
+                                      << kOverflowMarkerFileName
+                                      << " marker file",
+                        fs::is_empty(path) || fs::is_regular_file(marker));
+
+                // Collect the entries first, removing them while iterating is not portable.
+                std::vector<fs::path> entries;
+                for (fs::directory_iterator it(path), end; it != end; ++it) {
+                    if (it->path().filename() != kOverflowMarkerFileName) {
+                        entries.push_back(it->path());
+                    }
+                }
+                for (const auto& entry : entries) {
+                    fs::remove_all(entry);
+                }
+            }
+
+            if (!fs::exists(marker)) {
+                std::ofstream markerFile(marker.string());
+                uassert(ErrorCodes::InvalidOptions,
+                        str::stream() << "Unable to create " << marker.string(),
+                        markerFile.good());
+            }
+        } catch (const fs::filesystem_error& e) {
+            uasserted(ErrorCodes::InvalidOptions,
+                      str::stream() << "Unable to prepare inMemoryOverflowPath " << path.string()
+                                    << ": " << e.what());
+        }
+
+        return path.string();
+    }
+
     static void syncInMemoryAndWiredTigerOptions() {
         // Re-create WiredTiger options to fill it with default values
         wiredTigerGlobalOptions = WiredTigerGlobalOptions();
@@ -130,8 +290,10 @@ private:
         wiredTigerGlobalOptions.statisticsLogDelaySecs =
             inMemoryGlobalOptions.statisticsLogDelaySecs;
         // Set InMemory configuration as part of engineConfig string
+        // With overflow to disk the engine is file based, see create()
         wiredTigerGlobalOptions.engineConfig =
-            "in_memory=true,"
+            inMemoryGlobalOptions.overflowToDisk ? "" : "in_memory=true,";
+        wiredTigerGlobalOptions.engineConfig +=
             "log=(enabled=false),"
             "file_manager=(close_idle_time=0),"
             "checkpoint=(wait=0,log_size=0),";
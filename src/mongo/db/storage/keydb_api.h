@@ -20,6 +20,10 @@ Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
 
 #pragma once
 
+#include <string>
+
+#include "mongo/base/status.h"
+
 namespace percona {
 
 /**
@@ -35,6 +39,15 @@ struct KeyDBAPI {
     virtual void keydbDropDatabase(const std::string& db) {
         // do nothing for engines which do not support KeyDB
     }
+
+    /**
+     * Re-encrypt KeyDB with the master key read from keyFile.
+     * @return Status code of the operation.
+     */
+    virtual mongo::Status keydbRotateMasterKey(const std::string& keyFile) {
+        return mongo::Status(mongo::ErrorCodes::IllegalOperation,
+                             "This engine doesn't support master key rotation.");
+    }
 };
 
 }  // end of percona namespace.
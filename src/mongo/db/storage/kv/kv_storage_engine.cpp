@@ -87,6 +87,10 @@ void KVStorageEngine::keydbDropDatabase(const std::string& db) {
     _engine->keydbDropDatabase(db);
 }
 
+Status KVStorageEngine::keydbRotateMasterKey(const std::string& keyFile) {
+    return _engine->keydbRotateMasterKey(keyFile);
+}
+
 KVStorageEngine::KVStorageEngine(
     KVEngine* engine,
     const KVStorageEngineOptions& options,
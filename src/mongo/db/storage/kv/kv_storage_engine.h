@@ -73,6 +73,7 @@ class KVStorageEngine final : public StorageEngine {
     // percona::EngineExtension implementaion
     Status hotBackup(OperationContext* opCtx, const std::string& path) override;
     void keydbDropDatabase(const std::string& db) override;
+    Status keydbRotateMasterKey(const std::string& keyFile) override;
 
 public:
     /**
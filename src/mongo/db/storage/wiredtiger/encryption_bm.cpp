@@ -0,0 +1,165 @@
+/*======
+This file is part of Percona Server for MongoDB.
+
+Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
+
+    Percona Server for MongoDB is free software: you can redistribute
+    it and/or modify it under the terms of the GNU Affero General
+    Public License, version 3, as published by the Free Software
+    Foundation.
+
+    Percona Server for MongoDB is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied
+    warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+    See the GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public
+    License along with Percona Server for MongoDB.  If not, see
+    <http://www.gnu.org/licenses/>.
+======= */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <wiredtiger.h>
+
+#include "mongo/db/encryption/encryption_options.h"
+#include "mongo/db/storage/wiredtiger/encryption_keydb.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/base64.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace {
+
+const int kRecordsPerIteration = 1024;
+const int kRecordSize = 4096;
+
+const char* const kCiphers[] = {"none", "AES256-CBC", "AES256-GCM"};
+
+/**
+ * A WiredTiger connection whose tables are encrypted with the Percona encryption extension using
+ * the given cipher, or not encrypted at all for "none".
+ */
+class EncryptedConnection {
+public:
+    explicit EncryptedConnection(const std::string& cipher) : _dir("encryption_bm") {
+        const bool encrypted = cipher != "none";
+        if (encrypted) {
+            auto srng = SecureRandom::create();
+            char key[32];
+            for (size_t i = 0; i < sizeof(key); i += sizeof(int64_t)) {
+                int64_t v = srng->nextInt64();
+                memcpy(key + i, &v, sizeof(v));
+            }
+            const std::string keyFile = _dir.path() + "/key";
+            std::ofstream(keyFile) << base64::encode(key, sizeof(key));
+            encryptionGlobalParams.encryptionKeyFile = keyFile;
+
+            const std::string keyDBPath = _dir.path() + "/keydb";
+            boost::filesystem::create_directory(keyDBPath);
+            _keyDB = stdx::make_unique<EncryptionKeyDB>(keyDBPath);
+            _keyDB->init();
+        }
+
+        const std::string dataPath = _dir.path() + "/data";
+        boost::filesystem::create_directory(dataPath);
+        str::stream config;
+        config << "create,cache_size=1G,";
+        if (encrypted) {
+            config << "extensions=[local=(entry=percona_encryption_extension_init,early_load=true,"
+                   << "config=(cipher=" << cipher << "))],";
+            _tableConfig = "encryption=(name=percona,keyid=\"\"),";
+        }
+        invariantWTOK(
+            wiredtiger_open(dataPath.c_str(), nullptr, std::string(config).c_str(), &_conn));
+    }
+
+    ~EncryptedConnection() {
+        invariantWTOK(_conn->close(_conn, nullptr));
+        _keyDB.reset();
+    }
+
+    WT_CONNECTION* getConnection() const {
+        return _conn;
+    }
+
+    const std::string& getTableConfig() const {
+        return _tableConfig;
+    }
+
+private:
+    unittest::TempDir _dir;
+    std::unique_ptr<EncryptionKeyDB> _keyDB;
+    WT_CONNECTION* _conn = nullptr;
+    std::string _tableConfig;
+};
+
+/**
+ * Benchmark writing pages through the encryptor. Each iteration bulk loads a fresh table with
+ * incompressible records, bulk cursors reconcile and write out leaf pages as they fill up, so every
+ * page is encrypted by the inserting thread. The argument is the index of the cipher in kCiphers.
+ *
+ * All threads executing the benchmark use the same connection but their own tables. The connection
+ * is only usable inside the benchmark loop, which the threads enter and leave together.
+ */
+void BM_EncryptedBulkLoad(benchmark::State& state) {
+    static std::unique_ptr<EncryptedConnection> conn;
+    if (state.thread_index == 0) {
+        conn = stdx::make_unique<EncryptedConnection>(kCiphers[state.range(0)]);
+    }
+
+    PseudoRandom prng(state.thread_index);
+    std::vector<char> value(kRecordSize);
+    for (size_t i = 0; i < value.size(); i += sizeof(int64_t)) {
+        int64_t v = prng.nextInt64();
+        memcpy(&value[i], &v, sizeof(v));
+    }
+
+    const std::string uri = str::stream() << "table:encryption_bm_" << state.thread_index;
+
+    for (auto keepRunning : state) {
+        const std::string tableConfig = "key_format=q,value_format=u," + conn->getTableConfig();
+        WT_CONNECTION* wtConn = conn->getConnection();
+        WT_SESSION* session;
+        invariantWTOK(wtConn->open_session(wtConn, nullptr, nullptr, &session));
+        invariantWTOK(session->create(session, uri.c_str(), tableConfig.c_str()));
+
+        WT_CURSOR* cursor;
+        invariantWTOK(session->open_cursor(session, uri.c_str(), nullptr, "bulk", &cursor));
+        for (int64_t i = 0; i < kRecordsPerIteration; ++i) {
+            WT_ITEM item;
+            item.data = value.data();
+            item.size = value.size();
+            // vary the value so no two pages have the same plaintext
+            memcpy(&value[0], &i, sizeof(i));
+            cursor->set_key(cursor, i);
+            cursor->set_value(cursor, &item);
+            invariantWTOK(cursor->insert(cursor));
+        }
+        invariantWTOK(cursor->close(cursor));
+
+        invariantWTOK(session->drop(session, uri.c_str(), "force"));
+        invariantWTOK(session->close(session, nullptr));
+    }
+
+    state.SetBytesProcessed(state.iterations() * kRecordsPerIteration * kRecordSize);
+
+    if (state.thread_index == 0) {
+        conn.reset();
+    }
+}
+
+BENCHMARK(BM_EncryptedBulkLoad)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("cipher")
+    ->DenseRange(0, 2);
+
+}  // namespace
+}  // namespace mongo
@@ -24,6 +24,7 @@ Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
 
 #include "mongo/db/encryption/encryption_options.h"
 #include "mongo/db/storage/wiredtiger/encryption_keydb.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/debug_util.h"
@@ -36,10 +37,32 @@ Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
 namespace mongo {
 
 static EncryptionKeyDB *encryptionKeyDB = nullptr;
+static AtomicUInt64 lastInstanceId;
 
 static constexpr const char * gcm_iv_key = "_gcm_iv_reserved";
+// file in keys DB directory holding the path of the key file it was last rotated to
+static constexpr const char * rotated_key_file = "rotatedMasterKeyFile";
+constexpr const char* EncryptionKeyDB::_rotation_suffix;
+constexpr const char* EncryptionKeyDB::_old_suffix;
 constexpr int EncryptionKeyDB::_key_len;
 constexpr int EncryptionKeyDB::_gcm_iv_bytes;
+constexpr int EncryptionKeyDB::_gcm_iv_block_size;
+
+// Per thread state used by get_iv_gcm and store_pseudo_bytes
+// Each encrypting thread takes GCM counter values from its own block and
+// generates CBC IVs with its own generator so that concurrent encryptors
+// don't serialize on EncryptionKeyDB::_lock.
+namespace {
+struct ThreadIVState {
+    uint64_t instance_id = 0;
+    boost::multiprecision::uint128_t gcm_iv_next{0};
+    boost::multiprecision::uint128_t gcm_iv_end{0};
+    uint64_t prng_instance_id = 0;
+    std::unique_ptr<PseudoRandom> prng;
+};
+
+thread_local ThreadIVState threadIVState;
+}  // namespace
 
 static void dump_key(unsigned char *key, const int _key_len, const char * msg) {
     const char* m = "0123456789ABCDEF";
@@ -76,7 +99,7 @@ static void dump_table(WT_SESSION* _sess, const int _key_len, const char* msg) {
 }
 
 EncryptionKeyDB::EncryptionKeyDB(const std::string& path)
-  : _path(path) {
+  : _path(path), _instance_id(lastInstanceId.addAndFetch(1)) {
     // only single instance is allowed
     invariant(encryptionKeyDB == nullptr);
     encryptionKeyDB = this;
@@ -97,67 +120,157 @@ EncryptionKeyDB::~EncryptionKeyDB() {
     encryptionKeyDB = nullptr;
 }
 
-void EncryptionKeyDB::init() {
-    _srng = SecureRandom::create();
-    _prng = std::make_unique<PseudoRandom>(_srng->nextInt64());
-    try {
-        if (!boost::filesystem::exists(encryptionGlobalParams.encryptionKeyFile)) {
-            throw std::runtime_error(std::string("specified encryption key file doesn't exist: ")
-                                                 + encryptionGlobalParams.encryptionKeyFile);
-        }
-        std::ifstream f(encryptionGlobalParams.encryptionKeyFile);
-        if (!f.is_open()) {
-            throw std::runtime_error(std::string("cannot open specified encryption key file: ")
-                                                 + encryptionGlobalParams.encryptionKeyFile);
-        }
-        std::string encoded_key;
-        f >> encoded_key;
-        auto key = base64::decode(encoded_key);
-        if (key.length() != _key_len) {
-            throw std::runtime_error(str::stream() << "encryption key length should be " << _key_len << " bytes");
-        }
-        memcpy(_masterkey, key.c_str(), _key_len);
+static void read_master_key(const std::string& keyFile, unsigned char *masterkey, int key_len) {
+    if (!boost::filesystem::exists(keyFile)) {
+        throw std::runtime_error(std::string("specified encryption key file doesn't exist: ")
+                                             + keyFile);
+    }
+    std::ifstream f(keyFile);
+    if (!f.is_open()) {
+        throw std::runtime_error(std::string("cannot open specified encryption key file: ")
+                                             + keyFile);
+    }
+    std::string encoded_key;
+    f >> encoded_key;
+    auto key = base64::decode(encoded_key);
+    if (key.length() != static_cast<size_t>(key_len)) {
+        throw std::runtime_error(str::stream() << "encryption key length should be " << key_len << " bytes");
+    }
+    memcpy(masterkey, key.c_str(), key_len);
+}
 
-        std::stringstream ss;
-        ss << "create,";
-        ss << "config_base=false,";
-        // encryptionGlobalParams.encryptionCipherMode is not used here with a reason:
-        // keys DB will always use CBC cipher because wiredtiger_open internally calls
-        // encryption extension's encrypt function which depends on the GCM encryption counter
-        // loaded later (see 'load parameters' section below)
-        ss << "extensions=[local=(entry=percona_encryption_extension_init,early_load=true,config=(cipher=AES256-CBC))],";
-        ss << "encryption=(name=percona,keyid=\"\"),";
-        // logging configured; updates durable on application or system failure
-        // https://source.wiredtiger.com/3.0.0/tune_durability.html
-        ss << "log=(enabled,file_max=5MB),transaction_sync=(enabled=true,method=fsync),";
-        std::string config = ss.str();
-        log() << "Initializing KeyDB with wiredtiger_open config: " << config;
-        int res = wiredtiger_open(_path.c_str(), nullptr, config.c_str(), &_conn);
-        if (res) {
-            throw std::runtime_error(std::string("error opening keys DB at '") + _path + "': " + wiredtiger_strerror(res));
-        }
+// opens keys DB at path and creates its tables if necessary
+// the DB is encrypted with the key returned by get_key_by_id for empty keyid
+static void open_keydb(const std::string& path, WT_CONNECTION **conn, WT_SESSION **sess) {
+    std::stringstream ss;
+    ss << "create,";
+    ss << "config_base=false,";
+    // encryptionGlobalParams.encryptionCipherMode is not used here with a reason:
+    // keys DB will always use CBC cipher because wiredtiger_open internally calls
+    // encryption extension's encrypt function which depends on the GCM encryption counter
+    // loaded later (see 'load parameters' section in EncryptionKeyDB::init)
+    ss << "extensions=[local=(entry=percona_encryption_extension_init,early_load=true,config=(cipher=AES256-CBC))],";
+    ss << "encryption=(name=percona,keyid=\"\"),";
+    // logging configured; updates durable on application or system failure
+    // https://source.wiredtiger.com/3.0.0/tune_durability.html
+    ss << "log=(enabled,file_max=5MB),transaction_sync=(enabled=true,method=fsync),";
+    std::string config = ss.str();
+    log() << "Initializing KeyDB with wiredtiger_open config: " << config;
+    int res = wiredtiger_open(path.c_str(), nullptr, config.c_str(), conn);
+    if (res) {
+        throw std::runtime_error(std::string("error opening keys DB at '") + path + "': " + wiredtiger_strerror(res));
+    }
+
+    // empty keyid means masterkey
+    res = (*conn)->open_session(*conn, nullptr, nullptr, sess);
+    if (res) {
+        throw std::runtime_error(std::string("error opening wiredTiger session: ") + wiredtiger_strerror(res));
+    }
+
+    // try to create 'key' table
+    // ignore error if table already exists
+    res = (*sess)->create(*sess, "table:key", "key_format=S,value_format=u,access_pattern_hint=random");
+    if (res) {
+        throw std::runtime_error(std::string("error creating/opening key table: ") + wiredtiger_strerror(res));
+    }
 
-        // empty keyid means masterkey
-        res = _conn->open_session(_conn, nullptr, nullptr, &_sess);
+    // try to create 'parameters' table
+    // ignore error if table already exists
+    res = (*sess)->create(*sess, "table:parameters", "key_format=S,value_format=u,access_pattern_hint=random");
+    if (res) {
+        throw std::runtime_error(std::string("error creating/opening parameters table: ") + wiredtiger_strerror(res));
+    }
+}
+
+// returns path of the key file keys DB at path was rotated to or empty string
+static std::string read_rotated_key_file(const boost::filesystem::path& path) {
+    std::ifstream f((path / rotated_key_file).string());
+    std::string keyFile;
+    if (f.is_open())
+        std::getline(f, keyFile);
+    return keyFile;
+}
+
+// copies all records of the table at uri, returns number of records copied
+static long long copy_table(WT_SESSION *from, WT_SESSION *to, const char *uri) {
+    auto cursor_deleter = [](WT_CURSOR* c) { c->close(c); };
+    WT_CURSOR *src;
+    WT_CURSOR *dst;
+    int res = from->open_cursor(from, uri, nullptr, nullptr, &src);
+    if (res) {
+        throw std::runtime_error(std::string("error opening cursor: ") + wiredtiger_strerror(res));
+    }
+    std::unique_ptr<WT_CURSOR, std::function<void(WT_CURSOR*)>> src_guard(src, cursor_deleter);
+    res = to->open_cursor(to, uri, nullptr, nullptr, &dst);
+    if (res) {
+        throw std::runtime_error(std::string("error opening cursor: ") + wiredtiger_strerror(res));
+    }
+    std::unique_ptr<WT_CURSOR, std::function<void(WT_CURSOR*)>> dst_guard(dst, cursor_deleter);
+
+    long long count = 0;
+    while ((res = src->next(src)) == 0) {
+        const char *k;
+        WT_ITEM v;
+        src->get_key(src, &k);
+        src->get_value(src, &v);
+        dst->set_key(dst, k);
+        dst->set_value(dst, &v);
+        res = dst->insert(dst);
         if (res) {
-            throw std::runtime_error(std::string("error opening wiredTiger session: ") + wiredtiger_strerror(res));
+            throw std::runtime_error(std::string("error copying ") + uri + ": " + wiredtiger_strerror(res));
         }
+        ++count;
+    }
+    if (res != WT_NOTFOUND) {
+        throw std::runtime_error(std::string("error reading ") + uri + ": " + wiredtiger_strerror(res));
+    }
+    return count;
+}
 
-        DEV dump_table(_sess, _key_len, "before create");
-        // try to create 'key' table
-        // ignore error if table already exists
-        res = _sess->create(_sess, "table:key", "key_format=S,value_format=u,access_pattern_hint=random");
-        if (res) {
-            throw std::runtime_error(std::string("error creating/opening key table: ") + wiredtiger_strerror(res));
+void EncryptionKeyDB::finish_master_key_rotation() {
+    namespace fs = boost::filesystem;
+    const fs::path path(_path);
+    const fs::path rotation_path(_path + _rotation_suffix);
+    const fs::path old_path(_path + _old_suffix);
+    // keys DB encrypted with the new master key is only renamed into place after it is
+    // complete so if it is still there it is either complete or a leftover of a failed rotation
+    if (fs::exists(rotation_path)) {
+        if (!fs::exists(path / "WiredTiger")) {
+            warning() << "Found keys DB encrypted with the new master key at " << rotation_path.string()
+                      << ", completing master key rotation. The new key file "
+                      << read_rotated_key_file(rotation_path) << " should be used from now on";
+            fs::remove_all(path);
+            fs::rename(rotation_path, path);
+        } else {
+            warning() << "Removing incomplete keys DB left by failed master key rotation at "
+                      << rotation_path.string();
+            fs::remove_all(rotation_path);
         }
-        DEV dump_table(_sess, _key_len, "after create");
+    }
+    if (fs::exists(old_path) && fs::exists(path / "WiredTiger")) {
+        fs::remove_all(old_path);
+    }
+}
 
-        // try to create 'parameters' table
-        // ignore error if table already exists
-        res = _sess->create(_sess, "table:parameters", "key_format=S,value_format=u,access_pattern_hint=random");
-        if (res) {
-            throw std::runtime_error(std::string("error creating/opening parameters table: ") + wiredtiger_strerror(res));
+void EncryptionKeyDB::init() {
+    _srng = SecureRandom::create();
+    try {
+        finish_master_key_rotation();
+        read_master_key(encryptionGlobalParams.encryptionKeyFile, _masterkey, _key_len);
+        try {
+            open_keydb(_path, &_conn, &_sess);
+        } catch (std::exception&) {
+            // most likely the key file from before master key rotation is used
+            auto rotatedKeyFile = read_rotated_key_file(_path);
+            if (rotatedKeyFile.empty())
+                throw;
+            throw std::runtime_error(str::stream()
+                << "cannot open keys DB with the master key from "
+                << encryptionGlobalParams.encryptionKeyFile
+                << ". The master key was rotated to the key from " << rotatedKeyFile
+                << ", restart with encryptionKeyFile set to that file");
         }
+        DEV dump_table(_sess, _key_len, "after open");
 
         // load parameters
         {
@@ -191,6 +304,92 @@ void EncryptionKeyDB::init() {
     log() << "Encryption keys DB is initialized successfully";
 }
 
+void EncryptionKeyDB::rotate_master_key(const std::string& keyFile) {
+    namespace fs = boost::filesystem;
+    try {
+        // _conn and _sess are replaced below so block everything using them:
+        // keys DB checkpoints and log flushes, GCM counter reservation and key lookups
+        stdx::lock_guard<stdx::mutex> lk_conn(_lock_conn);
+        if (_backups > 0) {
+            throw std::runtime_error("cannot rotate master key while hot backup is in progress");
+        }
+        stdx::lock_guard<stdx::recursive_mutex> lk(_lock);
+        stdx::lock_guard<stdx::mutex> lk_key(_lock_key);
+        invariant(_conn && _sess);
+
+        log() << "Rotating encryption master key, new key file: " << keyFile;
+        unsigned char newkey[_key_len];
+        read_master_key(keyFile, newkey, _key_len);
+
+        const std::string rotation_path = _path + _rotation_suffix;
+        fs::remove_all(rotation_path);
+        fs::create_directory(rotation_path);
+
+        // persist current IV counter so that it is copied to the new keys DB
+        _gcm_iv_reserved = _gcm_iv;
+        int res = store_gcm_iv_reserved();
+        if (res) {
+            throw std::runtime_error(std::string("error storing GCM IV counter: ") + wiredtiger_strerror(res));
+        }
+        stdx::lock_guard<stdx::mutex> lk_sess(_lock_sess);
+
+        // the existing connection's encryptor has loaded the old master key already
+        // so new connection is the only one getting the new key
+        unsigned char oldkey[_key_len];
+        memcpy(oldkey, _masterkey, _key_len);
+        memcpy(_masterkey, newkey, _key_len);
+        WT_CONNECTION *conn = nullptr;
+        WT_SESSION *sess = nullptr;
+        try {
+            open_keydb(rotation_path, &conn, &sess);
+            for (auto uri : {"table:key", "table:parameters"}) {
+                auto count = copy_table(_sess, sess, uri);
+                log() << "Master key rotation: copied " << count << " records of " << uri;
+            }
+        } catch (...) {
+            if (conn)
+                conn->close(conn, nullptr);
+            fs::remove_all(rotation_path);
+            memcpy(_masterkey, oldkey, _key_len);
+            throw;
+        }
+        res = conn->close(conn, nullptr);
+        if (res) {
+            fs::remove_all(rotation_path);
+            memcpy(_masterkey, oldkey, _key_len);
+            throw std::runtime_error(std::string("error closing new keys DB: ") + wiredtiger_strerror(res));
+        }
+        // lets init name the new key file if the old one is used after rotation
+        {
+            std::ofstream f((fs::path(rotation_path) / rotated_key_file).string());
+            f << keyFile << std::endl;
+            if (!f) {
+                fs::remove_all(rotation_path);
+                memcpy(_masterkey, oldkey, _key_len);
+                throw std::runtime_error(std::string("error writing ") + rotated_key_file);
+            }
+        }
+
+        // swap directories, see finish_master_key_rotation for crash recovery
+        _sess->close(_sess, nullptr);
+        _sess = nullptr;
+        // closing connection also closes _flush_sess
+        _conn->close(_conn, nullptr);
+        _conn = nullptr;
+        _flush_sess = nullptr;
+        fs::rename(_path, _path + _old_suffix);
+        fs::rename(rotation_path, _path);
+        fs::remove_all(_path + _old_suffix);
+
+        open_keydb(_path, &_conn, &_sess);
+    } catch (std::exception& e) {
+        error() << "Master key rotation failed: " << e.what();
+        throw;
+    }
+    log() << "Encryption master key is rotated successfully. Use " << keyFile
+          << " as encryptionKeyFile from now on";
+}
+
 int EncryptionKeyDB::get_key_by_id(const char *keyid, size_t len, unsigned char *key, void *pe) {
     LOG(4) << "get_key_by_id for keyid: '" << std::string(keyid, len) << "'";
     // return key from keyfile if len == 0
@@ -200,11 +399,15 @@ int EncryptionKeyDB::get_key_by_id(const char *keyid, size_t len, unsigned char
         return 0;
     }
 
+    // search/write of db encryption key should be atomic
+    // the lock is taken before opening cursor because master key rotation replaces _sess
+    stdx::lock_guard<stdx::mutex> lk(_lock_key);
+
     int res;
     // open cursor
     WT_CURSOR *cursor;
     {
-        stdx::lock_guard<stdx::mutex> lk(_lock_sess);
+        stdx::lock_guard<stdx::mutex> lk_sess(_lock_sess);
         res = _sess->open_cursor(_sess, "table:key", nullptr, nullptr, &cursor);
         if (res){
             error() << "get_key_by_id: error opening cursor: " << wiredtiger_strerror(res);
@@ -218,8 +421,6 @@ int EncryptionKeyDB::get_key_by_id(const char *keyid, size_t len, unsigned char
             c->close(c);
         });
 
-    // search/write of db encryption key should be atomic
-    stdx::lock_guard<stdx::mutex> lk(_lock_key);
     // read key from DB
     std::string c_str(keyid, len);
     LOG(4) << "trying to load encryption key for keyid: " << c_str;
@@ -263,11 +464,15 @@ int EncryptionKeyDB::get_key_by_id(const char *keyid, size_t len, unsigned char
 int EncryptionKeyDB::delete_key_by_id(const std::string&  keyid) {
     LOG(4) << "delete_key_by_id for keyid: '" << keyid << "'";
 
+    // serialize with get_key_by_id which may be registering encryptor for this keyid
+    // and with master key rotation which replaces _sess
+    stdx::lock_guard<stdx::mutex> lk(_lock_key);
+
     int res;
     // open cursor
     WT_CURSOR *cursor;
     {
-        stdx::lock_guard<stdx::mutex> lk(_lock_sess);
+        stdx::lock_guard<stdx::mutex> lk_sess(_lock_sess);
         res = _sess->open_cursor(_sess, "table:key", nullptr, nullptr, &cursor);
         if (res){
             error() << "delete_key_by_id: error opening cursor: " << wiredtiger_strerror(res);
@@ -301,6 +506,41 @@ int EncryptionKeyDB::delete_key_by_id(const std::string&  keyid) {
     return res;
 }
 
+int EncryptionKeyDB::log_flush() {
+    stdx::lock_guard<stdx::mutex> lk(_lock_conn);
+    if (!_flush_sess) {
+        int res = _conn->open_session(_conn, nullptr, "isolation=snapshot", &_flush_sess);
+        if (res) {
+            _flush_sess = nullptr;
+            return res;
+        }
+    }
+    return _flush_sess->log_flush(_flush_sess, "sync=on");
+}
+
+int EncryptionKeyDB::checkpoint(const char* config) {
+    stdx::lock_guard<stdx::mutex> lk(_lock_conn);
+    WT_SESSION *sess;
+    int res = _conn->open_session(_conn, nullptr, "isolation=snapshot", &sess);
+    if (res)
+        return res;
+    res = sess->checkpoint(sess, config);
+    sess->close(sess, nullptr);
+    return res;
+}
+
+WT_CONNECTION* EncryptionKeyDB::begin_backup() {
+    stdx::lock_guard<stdx::mutex> lk(_lock_conn);
+    ++_backups;
+    return _conn;
+}
+
+void EncryptionKeyDB::end_backup() {
+    stdx::lock_guard<stdx::mutex> lk(_lock_conn);
+    invariant(_backups > 0);
+    --_backups;
+}
+
 int EncryptionKeyDB::store_gcm_iv_reserved() {
     uint8_t tmp[_gcm_iv_bytes];
     auto end = export_bits(_gcm_iv_reserved, tmp, 8, false);
@@ -338,29 +578,60 @@ int EncryptionKeyDB::store_gcm_iv_reserved() {
 }
 
 int EncryptionKeyDB::reserve_gcm_iv_range() {
+    static_assert(_gcm_iv_block_size <= (1<<12), "IV block is larger than reserved range");
     _gcm_iv_reserved += (1<<12);
-    return store_gcm_iv_reserved();
+    int res = store_gcm_iv_reserved();
+    if (res) {
+        // range is not reserved until it is stored
+        _gcm_iv_reserved -= (1<<12);
+    }
+    return res;
 }
 
-int EncryptionKeyDB::get_iv_gcm(uint8_t *buf, int len) {
+int EncryptionKeyDB::reserve_gcm_iv_block(_gcm_iv_type* first, _gcm_iv_type* last) {
     stdx::lock_guard<stdx::recursive_mutex> lk(_lock);
-    ++_gcm_iv;
+    // counter values up to _gcm_iv_reserved are persisted
+    // so they are never reused after restart
+    while (_gcm_iv + _gcm_iv_block_size > _gcm_iv_reserved) {
+        int res = reserve_gcm_iv_range();
+        if (res)
+            return res;
+    }
+    *first = _gcm_iv + 1;
+    _gcm_iv += _gcm_iv_block_size;
+    *last = _gcm_iv + 1;
+    return 0;
+}
+
+int EncryptionKeyDB::get_iv_gcm(uint8_t *buf, int len) {
+    auto& state = threadIVState;
+    if (state.instance_id != _instance_id || state.gcm_iv_next == state.gcm_iv_end) {
+        int res = reserve_gcm_iv_block(&state.gcm_iv_next, &state.gcm_iv_end);
+        if (res) {
+            state.instance_id = 0;
+            return res;
+        }
+        state.instance_id = _instance_id;
+    }
     uint8_t tmp[_gcm_iv_bytes];
-    auto end = export_bits(_gcm_iv, tmp, 8, false);
+    auto end = export_bits(state.gcm_iv_next++, tmp, 8, false);
     int ls = end - tmp;
     memset(buf, 0, len);
     memcpy(buf, tmp, std::min(len, ls));
-    if (_gcm_iv > _gcm_iv_reserved) {
-        return reserve_gcm_iv_range();
-    }
     return 0;
 }
 
 void EncryptionKeyDB::store_pseudo_bytes(uint8_t *buf, int len) {
     invariant((len % 4) == 0);
-    stdx::lock_guard<stdx::recursive_mutex> lk(_lock);
+    auto& state = threadIVState;
+    if (state.prng_instance_id != _instance_id) {
+        // _srng is not used here because _lock_key may already be held by this thread
+        // if it was pulled into eviction while updating the keys table
+        state.prng = std::make_unique<PseudoRandom>(SecureRandom::create()->nextInt64());
+        state.prng_instance_id = _instance_id;
+    }
     for (int i = 0; i < len / 4; ++i) {
-        *(int32_t*)buf = _prng->nextInt32();
+        *(int32_t*)buf = state.prng->nextInt32();
         buf += 4;
     }
 }
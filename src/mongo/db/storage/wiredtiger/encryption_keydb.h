@@ -41,6 +41,14 @@ public:
     // throws exceptions if something goes wrong
     void init();
 
+    // re-encrypts keys DB with the master key read from keyFile
+    // data files are not affected because they are encrypted with per database keys
+    // keys DB is reopened with the new master key
+    // may be called while the server is running, key lookups are blocked until it is done
+    // fails if hot backup is in progress
+    // throws exceptions if something goes wrong
+    void rotate_master_key(const std::string& keyFile);
+
     // returns encryption key from keys DB
     // create key if it does not exists
     // return key from keyfile if len == 0
@@ -50,33 +58,57 @@ public:
     int delete_key_by_id(const std::string&  keyid);
 
     // get new counter value for IV in GCM mode
+    // counter values are handed out to each thread in blocks of _gcm_iv_block_size
+    // so this only locks when the calling thread's block is exhausted
     int get_iv_gcm(uint8_t *buf, int len);
 
     // len should be multiple of 4
+    // uses per thread pseudo random generator
     void store_pseudo_bytes(uint8_t *buf, int len);
 
+    // flushes keys DB log to disk
+    int log_flush();
+
+    // creates keys DB checkpoint with specified config
+    int checkpoint(const char* config);
+
     // get connection for hot backup procedure to create backup
-    WT_CONNECTION*  getConnection() const { return _conn; }
+    // the connection is not replaced by master key rotation until end_backup is called
+    WT_CONNECTION* begin_backup();
+    void end_backup();
 
 private:
     typedef boost::multiprecision::uint128_t _gcm_iv_type;
 
+    // completes or cleans up master key rotation interrupted by a crash
+    void finish_master_key_rotation();
     int store_gcm_iv_reserved();
     int reserve_gcm_iv_range();
+    // allocates next block of counter values for get_iv_gcm: [*first, *last)
+    int reserve_gcm_iv_block(_gcm_iv_type* first, _gcm_iv_type* last);
 
     static constexpr int _key_len = 32;
+    // directories used during master key rotation: _path + suffix
+    static constexpr const char* _rotation_suffix = ".rotation";
+    static constexpr const char* _old_suffix = ".old";
     const std::string _path;
     unsigned char _masterkey[_key_len];
+    stdx::mutex _lock_conn;  // _conn, _flush_sess, _backups
     WT_CONNECTION *_conn = nullptr;
-    stdx::recursive_mutex _lock;  // _prng, _gcm_iv, _gcm_iv_reserved
+    WT_SESSION *_flush_sess = nullptr;
+    int _backups = 0;
+    // distinguishes thread local state created by different instances
+    const uint64_t _instance_id;
+    stdx::recursive_mutex _lock;  // _gcm_iv, _gcm_iv_reserved
     stdx::mutex _lock_sess;  // _sess
     stdx::mutex _lock_key;  // serialize access to the encryption keys table, also protects _srng
     WT_SESSION *_sess = nullptr;
     std::unique_ptr<SecureRandom> _srng;
-    std::unique_ptr<PseudoRandom> _prng;
     _gcm_iv_type _gcm_iv{0};
     _gcm_iv_type _gcm_iv_reserved{0};
     static constexpr int _gcm_iv_bytes = (std::numeric_limits<decltype(_gcm_iv)>::digits + 7) / 8;
+    // should not exceed the range reserved by reserve_gcm_iv_range
+    static constexpr int _gcm_iv_block_size = 256;
     // encryptors per db name
     // get_key_by_id creates entry
     // delete_key_by_it lets encryptor know that DB was deleted and deletes entry
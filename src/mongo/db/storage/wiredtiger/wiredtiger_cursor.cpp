@@ -43,6 +43,7 @@ WiredTigerCursor::WiredTigerCursor(const std::string& uri,
     _ru = WiredTigerRecoveryUnit::get(opCtx);
     _session = _ru->getSession();
     _readOnce = _ru->getReadOnce();
+    _ru->noteTableAccess(tableID);
 
     if (_readOnce) {
         _cursor = _session->getReadOnceCursor(uri, allowOverwrite);
@@ -433,7 +433,7 @@ bool WiredTigerIndex::isEmpty(OperationContext* opCtx) {
     WT_CURSOR* c = curwrap.get();
     if (!c)
         return true;
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->next(c); });
     if (ret == WT_NOTFOUND)
         return true;
     invariantWTOK(ret);
@@ -501,7 +501,7 @@ bool WiredTigerIndex::isDup(OperationContext* opCtx,
     WiredTigerItem item(data.getBuffer(), data.getSize());
     setKey(c, item.Get());
 
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         return false;
     }
@@ -1000,7 +1000,7 @@ protected:
     void advanceWTCursor() {
         WT_CURSOR* c = _cursor->get();
         int ret = wiredTigerPrepareConflictRetry(
-            _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+            _opCtx, _idx.tableId(), [&] { return _forward ? c->next(c) : c->prev(c); });
         if (ret == WT_NOTFOUND) {
             _cursorAtEof = true;
             return;
@@ -1022,7 +1022,8 @@ protected:
         const WiredTigerItem keyItem(query.getBuffer(), query.getSize());
         setKey(c, keyItem.Get());
 
-        int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+        int ret = wiredTigerPrepareConflictRetry(
+            _opCtx, _idx.tableId(), [&] { return c->search_near(c, &cmp); });
         if (ret == WT_NOTFOUND) {
             _cursorAtEof = true;
             TRACE_CURSOR << "\t not found";
@@ -1277,7 +1278,7 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
     // key, search a record matching the prefix key.
     int cmp;
     auto searchStatus =
-        wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+        wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search_near(c, &cmp); });
 
     if (searchStatus == WT_NOTFOUND)
         return false;
@@ -1306,10 +1307,10 @@ bool WiredTigerIndexUnique::isDup(OperationContext* opCtx,
     int ret;
     if (cmp < 0) {
         // We got the smaller key adjacent to prefix key, check the next key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->next(c); });
+        ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->next(c); });
     } else {
         // We got the larger key adjacent to prefix key, check the previous key too.
-        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->prev(c); });
+        ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->prev(c); });
     }
 
     if (ret == 0) {
@@ -1374,7 +1375,7 @@ StatusWith<SpecialFormatInserted> WiredTigerIndexUnique::_insertTimestampUnsafe(
     // we put them all in the "list"
     // Note that we can't omit AllZeros when there are multiple ids for a value. When we remove
     // down to a single value, it will be cleaned up.
-    ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old;
@@ -1520,7 +1521,7 @@ void WiredTigerIndexUnique::_unindexTimestampUnsafe(OperationContext* opCtx,
         if (_partial) {
             // Check that the record id matches.  We may be called to unindex records that are not
             // present in the index due to the partial filter expression.
-            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+            int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
             if (ret == WT_NOTFOUND) {
                 triggerWriteConflictAtPoint(c);
                 return;
@@ -1547,7 +1548,7 @@ void WiredTigerIndexUnique::_unindexTimestampUnsafe(OperationContext* opCtx,
 
     // dups are allowed, so we have to deal with a vector of RecordIds.
 
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         triggerWriteConflictAtPoint(c);
         return;
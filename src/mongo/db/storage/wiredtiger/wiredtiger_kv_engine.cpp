@@ -172,8 +172,11 @@ const int WiredTigerKVEngine::kDefaultJournalDelayMillis = 100;
 
 class WiredTigerKVEngine::WiredTigerJournalFlusher : public BackgroundJob {
 public:
-    explicit WiredTigerJournalFlusher(WiredTigerSessionCache* sessionCache)
-        : BackgroundJob(false /* deleteSelf */), _sessionCache(sessionCache) {}
+    WiredTigerJournalFlusher(WiredTigerKVEngine* wiredTigerKVEngine,
+                             WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */),
+          _wiredTigerKVEngine(wiredTigerKVEngine),
+          _sessionCache(sessionCache) {}
 
     virtual string name() const {
         return "WTJournalFlusher";
@@ -186,6 +189,18 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
+            // Write back the sizes changed since the last round ahead of the journal flush, so
+            // that recovery from the journal also restores them rather than the ones of the last
+            // checkpoint. A failed write back keeps the sizes buffered, so the next round retries.
+            try {
+                _wiredTigerKVEngine->syncSizeInfo(false);
+            } catch (const DBException& e) {
+                if (e.code() != ErrorCodes::ShutdownInProgress) {
+                    warning() << "Failed to write back collection sizes, will retry: "
+                              << redact(e.toStatus());
+                }
+            }
+
             try {
                 const bool forceCheckpoint = false;
                 const bool stableCheckpoint = false;
@@ -211,6 +226,7 @@ public:
     }
 
 private:
+    WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
     AtomicBool _shuttingDown{false};
 };
@@ -312,9 +328,7 @@ public:
                 // Do KeysDB checkpoint
                 auto encryptionKeyDB = _sessionCache->getKVEngine()->getEncryptionKeyDB();
                 if (encryptionKeyDB) {
-                    std::unique_ptr<WiredTigerSession> sess = stdx::make_unique<WiredTigerSession>(encryptionKeyDB->getConnection());
-                    WT_SESSION* s = sess->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+                    invariantWTOK(encryptionKeyDB->checkpoint("use_timestamp=false"));
                 }
             } catch (const WriteConflictException&) {
                 // Temporary: remove this after WT-3483
@@ -486,6 +500,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         }
         _encryptionKeyDB = stdx::make_unique<EncryptionKeyDB>(keyDBPath.string());
         _encryptionKeyDB->init();
+        if (!encryptionGlobalParams.encryptionRotateKeyFile.empty()) {
+            _encryptionKeyDB->rotate_master_key(encryptionGlobalParams.encryptionRotateKeyFile);
+        }
         // add Percona encryption extension
         std::stringstream ss;
         ss << "local=(entry=percona_encryption_extension_init,early_load=true,config=(cipher=" << encryptionGlobalParams.encryptionCipherMode << "))";
@@ -575,11 +592,6 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sessionCache.reset(new WiredTigerSessionCache(this));
 
-    if (_durable && !_ephemeral) {
-        _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
-        _journalFlusher->go();
-    }
-
     if (!_readOnly && !_ephemeral) {
         if (!_recoveryTimestamp.isNull()) {
             setInitialDataTimestamp(_recoveryTimestamp);
@@ -604,6 +616,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
+    if (_durable && !_ephemeral) {
+        _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(this, _sessionCache.get());
+        _journalFlusher->go();
+    }
+
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 }
 
@@ -987,6 +1004,19 @@ Status WiredTigerKVEngine::hotBackup(OperationContext* opCtx, const std::string&
     // list of DBs to backup
     std::vector<DBTuple> dbList;
 
+    // keyDB connection must not be replaced by master key rotation while its backup cursor
+    // is open, the cursors are closed with their sessions when dbList is cleared
+    WT_CONNECTION* keydbConn = nullptr;
+    if (_encryptionKeyDB) {
+        keydbConn = _encryptionKeyDB->begin_backup();
+    }
+    ON_BLOCK_EXIT([&] {
+        dbList.clear();
+        if (keydbConn) {
+            _encryptionKeyDB->end_backup();
+        }
+    });
+
     const char* journalDir = "journal";
     fs::path destPath{path};
 
@@ -1021,7 +1051,7 @@ Status WiredTigerKVEngine::hotBackup(OperationContext* opCtx, const std::string&
         } catch (const fs::filesystem_error& ex) {
             return Status(ErrorCodes::InvalidPath, str::stream() << ex.what());
         }
-        auto session = std::make_shared<WiredTigerSession>(_encryptionKeyDB->getConnection());
+        auto session = std::make_shared<WiredTigerSession>(keydbConn);
         WT_SESSION* s = session->getSession();
         ret = s->log_flush(s, "sync=off");
         if (ret != 0) {
@@ -1386,6 +1416,19 @@ void WiredTigerKVEngine::keydbDropDatabase(const std::string& db) {
     }
 }
 
+Status WiredTigerKVEngine::keydbRotateMasterKey(const std::string& keyFile) {
+    if (!_encryptionKeyDB) {
+        return Status(ErrorCodes::IllegalOperation, "Data at rest encryption is not enabled");
+    }
+    try {
+        _encryptionKeyDB->rotate_master_key(keyFile);
+    } catch (const std::exception& e) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "Master key rotation failed: " << e.what());
+    }
+    return Status::OK();
+}
+
 std::list<WiredTigerCachedCursor> WiredTigerKVEngine::filterCursorsWithQueuedDrops(
     std::list<WiredTigerCachedCursor>* cache) {
     std::list<WiredTigerCachedCursor> toDrop;
@@ -1820,17 +1863,18 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
                 str::stream() << "Error rolling back to stable. Err: " << wiredtiger_strerror(ret)};
     }
 
+    // The journal flusher writes back sizes, so it may only restart once the size storer is back.
+    _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
+
     if (!_ephemeral) {
         if (_durable) {
-            _journalFlusher = std::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
+            _journalFlusher = std::make_unique<WiredTigerJournalFlusher>(this, _sessionCache.get());
             _journalFlusher->go();
         }
         _checkpointThread = std::make_unique<WiredTigerCheckpointThread>(this, _sessionCache.get());
         _checkpointThread->go();
     }
 
-    _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
-
     return {stableTimestamp};
 }
 
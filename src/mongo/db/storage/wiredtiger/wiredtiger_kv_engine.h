@@ -154,6 +154,8 @@ public:
 
     virtual void keydbDropDatabase(const std::string& db) override;
 
+    virtual Status keydbRotateMasterKey(const std::string& keyFile) override;
+
     virtual Status okToRename(OperationContext* opCtx,
                               StringData fromNS,
                               StringData toNS,
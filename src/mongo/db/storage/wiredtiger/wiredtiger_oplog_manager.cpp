@@ -41,6 +41,7 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -51,6 +52,8 @@ const uint64_t kMinimumTimestamp = 1;
 
 MONGO_FAIL_POINT_DEFINE(WTPausePrimaryOplogDurabilityLoop);
 
+constexpr int WiredTigerOplogManager::kVisibilityLatencyBuckets;
+
 void WiredTigerOplogManager::start(OperationContext* opCtx,
                                    const std::string& uri,
                                    WiredTigerRecordStore* oplogRecordStore,
@@ -85,6 +88,7 @@ void WiredTigerOplogManager::start(OperationContext* opCtx,
                                        oplogRecordStore,
                                        updateOldestTimestamp);
 
+    _oplogRecordStore = oplogRecordStore;
     _isRunning = true;
     _shuttingDown = false;
 }
@@ -95,6 +99,7 @@ void WiredTigerOplogManager::halt() {
         invariant(_isRunning);
         _shuttingDown = true;
         _isRunning = false;
+        _oplogRecordStore = nullptr;
     }
 
     if (_oplogJournalThread.joinable()) {
@@ -131,6 +136,7 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     _opsWaitingForVisibility++;
     invariant(_opsWaitingForVisibility > 0);
     auto exitGuard = MakeGuard([&] { _opsWaitingForVisibility--; });
+    _opsWaitingForJournalCV.notify_one();
 
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
@@ -160,10 +166,19 @@ void WiredTigerOplogManager::triggerJournalFlush() {
     stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
     if (!_opsWaitingForJournal) {
         _opsWaitingForJournal = true;
+        _journalFlushTriggeredMicros = curTimeMicros64();
+        _opsWaitingForJournalCV.notify_one();
+    } else if (_haveOplogWaiters(lk)) {
+        // The pending flush may be delayed, oplog tailers which started waiting since it was
+        // triggered should cut the delay short.
         _opsWaitingForJournalCV.notify_one();
     }
 }
 
+bool WiredTigerOplogManager::_haveOplogWaiters(WithLock) const {
+    return _opsWaitingForVisibility || (_oplogRecordStore && _oplogRecordStore->haveCappedWaiters());
+}
+
 void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                                      WiredTigerRecordStore* oplogRecordStore,
                                                      const bool updateOldestTimestamp) noexcept {
@@ -172,6 +187,7 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
     // This thread updates the oplog read timestamp, the timestamp used to read from the oplog with
     // forward cursors.  The timestamp is used to hide oplog entries that might be committed but
     // have uncommitted entries ahead of them.
+    Date_t lastFlush;
     while (true) {
         stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
         {
@@ -179,32 +195,21 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
             _opsWaitingForJournalCV.wait(lk,
                                          [&] { return _shuttingDown || _opsWaitingForJournal; });
 
-            // If we're not shutting down and nobody is actively waiting for the oplog to become
-            // durable, delay journaling a bit to reduce the sync rate.
+            // If the previous flush was recent and nobody is actively waiting for the oplog to
+            // become visible, delay journaling until a journal delay has passed since then. All
+            // commits in the meantime share a single flush, which reduces sync-related I/O on the
+            // primary when secondaries are lagged, while writes on replica sets with infrequent
+            // writes become visible right away. Oplog tailers and callers of
+            // waitForAllEarlierOplogWritesToBeVisible(), like causally consistent reads, wake this
+            // thread up to preempt the delay.
             auto journalDelay = Milliseconds(storageGlobalParams.journalCommitIntervalMs.load());
             if (journalDelay == Milliseconds(0)) {
                 journalDelay = Milliseconds(WiredTigerKVEngine::kDefaultJournalDelayMillis);
             }
-            auto now = Date_t::now();
-            auto deadline = now + journalDelay;
-            auto shouldSyncOpsWaitingForJournal = [&] {
-                return _shuttingDown || _opsWaitingForVisibility ||
-                    oplogRecordStore->haveCappedWaiters();
-            };
-
-            // Eventually it would be more optimal to merge this with the normal journal flushing
-            // and block for either oplog tailers or operations waiting for oplog visibility. For
-            // now this loop will poll once a millisecond up to the journalDelay to see if we have
-            // any waiters yet. This reduces sync-related I/O on the primary when secondaries are
-            // lagged, but will avoid significant delays in confirming majority writes on replica
-            // sets with infrequent writes.
-            // Callers of waitForAllEarlierOplogWritesToBeVisible() like causally consistent reads
-            // will preempt this delay.
-            while (now < deadline &&
-                   !_opsWaitingForJournalCV.wait_until(
-                       lk, now.toSystemTimePoint(), shouldSyncOpsWaitingForJournal)) {
-                now += Milliseconds(1);
-            }
+            _opsWaitingForJournalCV.wait_until(
+                lk, (lastFlush + journalDelay).toSystemTimePoint(), [&] {
+                    return _shuttingDown || _haveOplogWaiters(lk);
+                });
         }
 
         while (!_shuttingDown && MONGO_FAIL_POINT(WTPausePrimaryOplogDurabilityLoop)) {
@@ -219,7 +224,9 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         }
         invariant(_opsWaitingForJournal);
         _opsWaitingForJournal = false;
+        const auto flushTriggeredMicros = _journalFlushTriggeredMicros;
         lk.unlock();
+        lastFlush = Date_t::now();
 
         const uint64_t newTimestamp = fetchAllCommittedValue(sessionCache->conn());
 
@@ -232,7 +239,8 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         }
 
         // In order to avoid oplog holes after an unclean shutdown, we must ensure this proposed
-        // oplog read timestamp's documents are durable before publishing that timestamp.
+        // oplog read timestamp's documents are durable before publishing that timestamp. This
+        // joins any journal flush already in progress rather than starting another one.
         sessionCache->waitUntilDurable(/*forceCheckpoint=*/false, false);
 
         lk.lock();
@@ -243,6 +251,9 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         }
         lk.unlock();
 
+        const auto now = curTimeMicros64();
+        _recordVisibilityLatency(now > flushTriggeredMicros ? now - flushTriggeredMicros : 0);
+
         if (updateOldestTimestamp) {
             const bool force = false;
             sessionCache->getKVEngine()->setOldestTimestamp(Timestamp(newTimestamp), force);
@@ -268,6 +279,40 @@ void WiredTigerOplogManager::_setOplogReadTimestamp(WithLock, uint64_t newTimest
     LOG(2) << "setting new oplogReadTimestamp: " << newTimestamp;
 }
 
+void WiredTigerOplogManager::_recordVisibilityLatency(uint64_t micros) {
+    int bucket = 0;
+    while (bucket < kVisibilityLatencyBuckets - 1 && micros >= (1ULL << bucket)) {
+        ++bucket;
+    }
+    // The count is bumped before the bucket, and appendStats() reads the buckets before the count,
+    // so a report never shows more samples in the histogram than in the count.
+    _visibilityLatencyCount.fetchAndAdd(1);
+    _visibilityLatencyBuckets[bucket].fetchAndAdd(1);
+    _visibilityLatencyTotalMicros.fetchAndAdd(micros);
+}
+
+void WiredTigerOplogManager::appendStats(BSONObjBuilder* builder) const {
+    std::array<uint64_t, kVisibilityLatencyBuckets> buckets;
+    for (int i = 0; i < kVisibilityLatencyBuckets; ++i) {
+        buckets[i] = _visibilityLatencyBuckets[i].load();
+    }
+
+    BSONObjBuilder sub(builder->subobjStart("oplogVisibility"));
+    sub.append("count", static_cast<long long>(_visibilityLatencyCount.load()));
+    sub.append("totalLatencyMicros", static_cast<long long>(_visibilityLatencyTotalMicros.load()));
+    BSONArrayBuilder histogram(sub.subarrayStart("histogram"));
+    for (int i = 0; i < kVisibilityLatencyBuckets; ++i) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        histogram.append(BSON("micros" << static_cast<long long>(i == 0 ? 0 : 1ULL << (i - 1))
+                                       << "count"
+                                       << static_cast<long long>(buckets[i])));
+    }
+    histogram.doneFast();
+    sub.doneFast();
+}
+
 uint64_t WiredTigerOplogManager::fetchAllCommittedValue(WT_CONNECTION* conn) {
     // Fetch the latest all_committed value from the storage engine.  This value will be a
     // timestamp that has no holes (uncommitted transactions with lower timestamps) behind it.
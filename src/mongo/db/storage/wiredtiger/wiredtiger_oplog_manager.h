@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/stdx/condition_variable.h"
@@ -43,8 +45,8 @@ class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 
 
-// Manages oplog visibility, by periodically querying WiredTiger's all_committed timestamp value and
-// then using that timestamp for all transactions that read the oplog collection.
+// Manages oplog visibility, by querying WiredTiger's all_committed timestamp value whenever oplog
+// writes commit and then using that timestamp for all transactions that read the oplog collection.
 class WiredTigerOplogManager {
     MONGO_DISALLOW_COPYING(WiredTigerOplogManager);
 
@@ -74,6 +76,8 @@ public:
     void setOplogReadTimestamp(Timestamp ts);
 
     // Triggers the oplogJournal thread to update its oplog read timestamp, by flushing the journal.
+    // The flush happens right away unless the previous one was less than a journal commit interval
+    // ago, in which case it is delayed until then or until somebody waits for oplog visibility.
     void triggerJournalFlush();
 
     // Waits until all committed writes at this point to become visible (that is, no holes exist in
@@ -85,6 +89,10 @@ public:
     // all committed timestamp are committed.
     uint64_t fetchAllCommittedValue(WT_CONNECTION* conn);
 
+    // Appends statistics on the time from triggering a journal flush, that is from committing
+    // oplog writes, to publishing the oplog read timestamp which makes them visible.
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
     void _oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                  WiredTigerRecordStore* oplogRecordStore,
@@ -92,6 +100,14 @@ private:
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
+    // Returns true if there are operations or oplog tailers waiting for new oplog entries to become
+    // visible, in which case journal flushing should not be delayed.
+    bool _haveOplogWaiters(WithLock) const;
+
+    void _recordVisibilityLatency(uint64_t micros);
+
+    static constexpr int kVisibilityLatencyBuckets = 25;
+
     stdx::thread _oplogJournalThread;
     mutable stdx::mutex _oplogVisibilityStateMutex;
     mutable stdx::condition_variable
@@ -106,11 +122,20 @@ private:
     // floor in waitForAllEarlierOplogWritesToBeVisible().
     RecordId _oplogMaxAtStartup = RecordId(0);  // Guarded by oplogVisibilityStateMutex.
     bool _opsWaitingForJournal = false;         // Guarded by oplogVisibilityStateMutex.
+    // When the pending journal flush was first triggered, in microseconds.
+    std::uint64_t _journalFlushTriggeredMicros = 0;  // Guarded by oplogVisibilityStateMutex.
+    WiredTigerRecordStore* _oplogRecordStore = nullptr;  // Guarded by oplogVisibilityStateMutex.
 
     // When greater than 0, indicates that there are operations waiting for oplog visibility, and
     // journal flushing should not be delayed.
     std::int64_t _opsWaitingForVisibility = 0;  // Guarded by oplogVisibilityStateMutex.
 
     AtomicUInt64 _oplogReadTimestamp;
+
+    // Bucket i counts visibility latencies in [2^(i-1), 2^i) microseconds, the last bucket also
+    // counts everything longer.
+    std::array<AtomicUInt64, kVisibilityLatencyBuckets> _visibilityLatencyBuckets;
+    AtomicUInt64 _visibilityLatencyCount;
+    AtomicUInt64 _visibilityLatencyTotalMicros;
 };
 }  // namespace mongo
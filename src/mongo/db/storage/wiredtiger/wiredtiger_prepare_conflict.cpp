@@ -36,6 +36,8 @@
 
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -47,4 +49,16 @@ void wiredTigerPrepareConflictLog(int attempts) {
            << ". Waiting for unit of work to commit or abort.";
 }
 
+void wiredTigerPrepareConflictWait(OperationContext* opCtx,
+                                   WiredTigerSessionCache* sessionCache,
+                                   uint64_t tableId,
+                                   uint64_t lastCount) {
+    Timer timer;
+    ON_BLOCK_EXIT([&] {
+        CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflictMicros(
+            timer.micros());
+    });
+    sessionCache->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx, tableId, lastCount);
+}
+
 }  // namespace mongo
@@ -46,21 +46,35 @@ MONGO_FAIL_POINT_DECLARE(WTPrepareConflictForReads);
  */
 void wiredTigerPrepareConflictLog(int attempt);
 
+/**
+ * Waits for a prepared unit of work that wrote to the table with the given id to commit or abort,
+ * and adds the time spent waiting to the prepare read conflict metrics of the operation.
+ */
+void wiredTigerPrepareConflictWait(OperationContext* opCtx,
+                                   WiredTigerSessionCache* sessionCache,
+                                   uint64_t tableId,
+                                   uint64_t lastCount);
+
 /**
  * Runs the argument function f as many times as needed for f to return an error other than
- * WT_PREPARE_CONFLICT. Each time f returns WT_PREPARE_CONFLICT we wait until the current unit of
- * work commits or aborts, and then try f again. Imposes no upper limit on the number of times to
- * re-try f, so any required timeout behavior must be enforced within f.
+ * WT_PREPARE_CONFLICT. Each time f returns WT_PREPARE_CONFLICT we wait until a prepared unit of
+ * work that wrote to the table with id 'tableId', which f reads from, commits or aborts, and then
+ * try f again. Imposes no upper limit on the number of times to re-try f, so any required timeout
+ * behavior must be enforced within f.
  * The function f must return a WiredTiger error code.
  */
 template <typename F>
-int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
+int wiredTigerPrepareConflictRetry(OperationContext* opCtx, uint64_t tableId, F&& f) {
     invariant(opCtx);
 
-    auto recoveryUnit = WiredTigerRecoveryUnit::get(opCtx);
+    auto sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     int attempts = 0;
     while (true) {
         attempts++;
+        // Read the count before calling f, so that a prepared unit of work ending between the
+        // conflict and the wait below is not missed.
+        auto lastCount = sessionCache->getPrepareCommitOrAbortCount(tableId);
+
         // If the failpoint is enabled, don't call the function, just simulate a conflict.
         int ret =
             MONGO_FAIL_POINT(WTPrepareConflictForReads) ? WT_PREPARE_CONFLICT : WT_READ_CHECK(f());
@@ -70,8 +84,7 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
 
         CurOp::get(opCtx)->debug().additiveMetrics.incrementPrepareReadConflicts(1);
         wiredTigerPrepareConflictLog(attempts);
-        // Wait on the session cache to signal that a unit of work has been committed or aborted.
-        recoveryUnit->getSessionCache()->waitUntilPreparedUnitOfWorkCommitsOrAborts(opCtx);
+        wiredTigerPrepareConflictWait(opCtx, sessionCache, tableId, lastCount);
     }
 }
 }  // namespace mongo
@@ -48,6 +48,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
@@ -58,8 +59,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
@@ -88,8 +91,25 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Number of threads that sample the oplog in parallel to place the oplog stones at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(oplogSamplingThreads, int, 4)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "oplogSamplingThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
 }  // namespace
 
+MONGO_EXPORT_SERVER_PARAMETER(oplogMinRetentionHours, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0.0) {
+            return Status(ErrorCodes::BadValue, "oplogMinRetentionHours must be >= 0");
+        }
+        return Status::OK();
+    });
+
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictExceptionForReads);
 
@@ -172,7 +192,9 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
-    _calculateStones(opCtx, numStonesToKeep);
+    if (!_loadPersistedStones(opCtx)) {
+        _calculateStones(opCtx, numStonesToKeep);
+    }
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -193,6 +215,7 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
     // Wait until kill() is called or there are too many oplog stones.
     stdx::unique_lock<stdx::mutex> lock(_oplogReclaimMutex);
     while (!_isDead) {
+        boost::optional<Date_t> retentionDeadline;
         {
             MONGO_IDLE_THREAD_BLOCK;
             stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -208,11 +231,24 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
                 invariant(stone.lastRecord.isValid());
                 if (static_cast<std::uint64_t>(stone.lastRecord.repr()) <
                     _rs->getPinnedOplog().asULL()) {
-                    break;
+                    if (_isOutsideRetentionPeriod(stone)) {
+                        break;
+                    }
+
+                    // The oldest stone must be kept for the minimum retention period. No insert
+                    // will signal when that has elapsed, so wake up on our own.
+                    retentionDeadline = _retentionDeadline(stone);
                 }
             }
         }
-        _oplogReclaimCv.wait(lock);
+
+        if (retentionDeadline) {
+            // Recheck at least once a minute in case 'oplogMinRetentionHours' is lowered.
+            Date_t deadline = std::min(*retentionDeadline, Date_t::now() + Minutes(1));
+            _oplogReclaimCv.wait_until(lock, deadline.toSystemTimePoint());
+        } else {
+            _oplogReclaimCv.wait(lock);
+        }
     }
 }
 
@@ -220,7 +256,7 @@ boost::optional<WiredTigerRecordStore::OplogStones::Stone>
 WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    if (!hasExcessStones_inlock()) {
+    if (!hasExcessStones_inlock() || !_isOutsideRetentionPeriod(_stones.front())) {
         return {};
     }
 
@@ -311,6 +347,107 @@ void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
     _minBytesPerStone = size;
 }
 
+bool WiredTigerRecordStore::OplogStones::_isOutsideRetentionPeriod(const Stone& stone) const {
+    if (oplogMinRetentionHours.load() == 0.0) {
+        return true;
+    }
+    return _retentionDeadline(stone) <= Date_t::now();
+}
+
+Date_t WiredTigerRecordStore::OplogStones::_retentionDeadline(const Stone& stone) const {
+    // The RecordIds in the oplog are the timestamps of its entries, whose seconds come from the
+    // wall clock at the time the entries were written.
+    Date_t lastWritten =
+        Date_t::fromMillisSinceEpoch(1000LL * Timestamp(stone.lastRecord.repr()).getSecs());
+    auto retention = Milliseconds(static_cast<long long>(oplogMinRetentionHours.load() * 3600000));
+    return lastWritten + retention;
+}
+
+void WiredTigerRecordStore::OplogStones::persist() {
+    WiredTigerSizeStorer* sizeStorer = _rs->_sizeStorer;
+    if (!sizeStorer) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    BSONObjBuilder builder;
+    builder.append("minBytesPerStone", static_cast<long long>(_minBytesPerStone));
+    builder.append("numRecords", static_cast<long long>(_rs->_sizeInfo->numRecords.load()));
+    builder.append("dataSize", static_cast<long long>(_rs->_sizeInfo->dataSize.load()));
+    builder.append("currentRecords", static_cast<long long>(_currentRecords.load()));
+    builder.append("currentBytes", static_cast<long long>(_currentBytes.load()));
+    {
+        BSONArrayBuilder stonesBuilder(builder.subarrayStart("stones"));
+        for (const auto& stone : _stones) {
+            BSONObjBuilder stoneBuilder(stonesBuilder.subobjStart());
+            stoneBuilder.append("records", static_cast<long long>(stone.records));
+            stoneBuilder.append("bytes", static_cast<long long>(stone.bytes));
+            stoneBuilder.append("lastRecord", static_cast<long long>(stone.lastRecord.repr()));
+        }
+    }
+
+    sizeStorer->storeOplogStones(_rs->_uri, builder.obj());
+}
+
+bool WiredTigerRecordStore::OplogStones::_loadPersistedStones(OperationContext* opCtx) {
+    WiredTigerSizeStorer* sizeStorer = _rs->_sizeStorer;
+    if (!sizeStorer) {
+        return false;
+    }
+
+    BSONObj persisted = sizeStorer->takeOplogStones(_rs->_uri);
+    if (persisted.isEmpty()) {
+        return false;
+    }
+
+    // The stones are saved whenever the oplog is closed and removed when it is opened again, so
+    // the oplog has not been written to in between. Still, only trust them if they agree with the
+    // size storer, and if the oplog size they were computed for has not changed.
+    if (persisted["minBytesPerStone"].safeNumberLong() != _minBytesPerStone ||
+        persisted["numRecords"].safeNumberLong() != _rs->numRecords(opCtx) ||
+        persisted["dataSize"].safeNumberLong() != _rs->dataSize(opCtx) ||
+        persisted["stones"].type() != Array) {
+        log() << "Ignoring saved oplog truncation markers which do not match the oplog";
+        return false;
+    }
+
+    std::deque<OplogStones::Stone> stones;
+    for (const auto& elem : persisted["stones"].Obj()) {
+        if (elem.type() != Object) {
+            log() << "Ignoring invalid saved oplog truncation markers: " << redact(persisted);
+            return false;
+        }
+
+        BSONObj obj = elem.Obj();
+        OplogStones::Stone stone = {obj["records"].safeNumberLong(),
+                                    obj["bytes"].safeNumberLong(),
+                                    RecordId(obj["lastRecord"].safeNumberLong())};
+        if (!stone.lastRecord.isNormal() ||
+            (!stones.empty() && stone.lastRecord <= stones.back().lastRecord)) {
+            log() << "Ignoring invalid saved oplog truncation markers: " << redact(persisted);
+            return false;
+        }
+        stones.push_back(stone);
+    }
+
+    if (!stones.empty()) {
+        auto cursor = _rs->getCursor(opCtx, /*forward=*/false);
+        auto record = cursor->next();
+        if (!record || record->id < stones.back().lastRecord) {
+            log() << "Ignoring saved oplog truncation markers past the end of the oplog";
+            return false;
+        }
+    }
+
+    log() << "Reusing " << stones.size() << " oplog truncation markers saved at shutdown";
+
+    _stones = std::move(stones);
+    _currentRecords.store(persisted["currentRecords"].safeNumberLong());
+    _currentBytes.store(persisted["currentBytes"].safeNumberLong());
+    return true;
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCtx,
                                                           size_t numStonesToKeep) {
     long long numRecords = _rs->numRecords(opCtx);
@@ -410,26 +547,17 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
           << " approximately " << estRecordsPerStone << " records totaling to " << estBytesPerStone
           << " bytes";
 
-    // Inform the random cursor of the number of samples we intend to take. This allows it to
-    // account for skew in the tree shape.
-    const std::string extraConfig = str::stream() << "next_random_sample_size=" << numSamples;
-
     // Divide the oplog into 'wholeStones' logical sections, with each section containing
     // approximately 'estRecordsPerStone'. Do so by oversampling the oplog, sorting the samples in
     // order of their RecordId, and then choosing the samples expected to be near the right edge of
     // each logical section.
-    auto cursor = _rs->getRandomCursorWithOptions(opCtx, extraConfig);
     std::vector<RecordId> oplogEstimates;
-    for (int i = 0; i < numSamples; ++i) {
-        auto record = cursor->next();
-        if (!record) {
-            // This shouldn't really happen unless the size storer values are far off from reality.
-            // The collection is probably empty, but fall back to scanning the oplog just in case.
-            log() << "Failed to get enough random samples, falling back to scanning the oplog";
-            _calculateStonesByScanning(opCtx);
-            return;
-        }
-        oplogEstimates.push_back(record->id);
+    if (!_sampleOplog(opCtx, numSamples, &oplogEstimates)) {
+        // This shouldn't really happen unless the size storer values are far off from reality.
+        // The collection is probably empty, but fall back to scanning the oplog just in case.
+        log() << "Failed to get enough random samples, falling back to scanning the oplog";
+        _calculateStonesByScanning(opCtx);
+        return;
     }
     std::sort(oplogEstimates.begin(), oplogEstimates.end());
 
@@ -449,6 +577,58 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
     _currentBytes.store(_rs->dataSize(opCtx) - estBytesPerStone * wholeStones);
 }
 
+bool WiredTigerRecordStore::OplogStones::_sampleOplog(OperationContext* opCtx,
+                                                      int64_t numSamples,
+                                                      std::vector<RecordId>* samples) const {
+    // Sampling is dominated by reading random pages of the oplog from disk, so it is split across
+    // threads that each use their own session. Every thread samples the whole key range: telling
+    // its random cursor how many samples it will take makes it skip evenly through the tree from a
+    // random starting point, which also accounts for skew in the tree shape.
+    const int64_t numThreads = std::min<int64_t>(oplogSamplingThreads, numSamples);
+    WT_CONNECTION* conn = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->conn();
+    const std::string& uri = _rs->getURI();
+
+    std::vector<std::vector<RecordId>> threadSamples(numThreads);
+    std::vector<stdx::thread> threads;
+    for (int64_t t = 0; t < numThreads; ++t) {
+        const int64_t threadNumSamples = numSamples / numThreads + (t < numSamples % numThreads);
+        threads.emplace_back([conn, &uri, threadNumSamples, out = &threadSamples[t]] {
+            WiredTigerSession session(conn);
+            WT_SESSION* wtSession = session.getSession();
+
+            const std::string config = str::stream()
+                << "next_random=true,next_random_sample_size=" << threadNumSamples;
+            WT_CURSOR* cursor;
+            invariantWTOK(
+                wtSession->open_cursor(wtSession, uri.c_str(), nullptr, config.c_str(), &cursor));
+            ON_BLOCK_EXIT([cursor] { cursor->close(cursor); });
+
+            out->reserve(threadNumSamples);
+            for (int64_t i = 0; i < threadNumSamples; ++i) {
+                int ret = cursor->next(cursor);
+                if (ret == WT_NOTFOUND) {
+                    return;
+                }
+                invariantWTOK(ret);
+
+                int64_t key;
+                invariantWTOK(cursor->get_key(cursor, &key));
+                out->push_back(RecordId(key));
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    samples->reserve(numSamples);
+    for (const auto& threadSample : threadSamples) {
+        samples->insert(samples->end(), threadSample.begin(), threadSample.end());
+    }
+    return static_cast<int64_t>(samples->size()) == numSamples;
+}
+
 void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     if (hasExcessStones_inlock()) {
         _oplogReclaimCv.notify_one();
@@ -500,8 +680,8 @@ public:
     }
 
     boost::optional<Record> next() final {
-        int advanceRet =
-            wiredTigerPrepareConflictRetry(_opCtx, [&] { return _cursor->next(_cursor); });
+        int advanceRet = wiredTigerPrepareConflictRetry(
+            _opCtx, _rs->tableId(), [&] { return _cursor->next(_cursor); });
         if (advanceRet == WT_NOTFOUND)
             return {};
         invariantWTOK(advanceRet);
@@ -689,6 +869,7 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
     LOG(1) << "~WiredTigerRecordStore for: " << ns();
 
     if (_oplogStones) {
+        _oplogStones->persist();
         _oplogStones->kill();
     }
 
@@ -766,12 +947,31 @@ bool WiredTigerRecordStore::inShutdown() const {
     return _shuttingDown;
 }
 
+class WiredTigerRecordStore::SizeChange : public RecoveryUnit::Change {
+public:
+    explicit SizeChange(WiredTigerRecordStore* rs) : _rs(rs) {}
+    virtual void commit(boost::optional<Timestamp>) {
+        _rs->_applySizeChange(numRecords, dataSize);
+    }
+    virtual void rollback() {
+        // Nothing to undo, the size updates never left this unit of work.
+    }
+
+    int64_t numRecords = 0;
+    int64_t dataSize = 0;
+
+private:
+    WiredTigerRecordStore* _rs;
+};
+
 long long WiredTigerRecordStore::dataSize(OperationContext* opCtx) const {
-    return _sizeInfo->dataSize.load();
+    const SizeChange* pending = _pendingSizeChange(opCtx);
+    return _sizeInfo->dataSize.load() + (pending ? pending->dataSize : 0);
 }
 
 long long WiredTigerRecordStore::numRecords(OperationContext* opCtx) const {
-    return _sizeInfo->numRecords.load();
+    const SizeChange* pending = _pendingSizeChange(opCtx);
+    return _sizeInfo->numRecords.load() + (pending ? pending->numRecords : 0);
 }
 
 bool WiredTigerRecordStore::isCapped() const {
@@ -830,7 +1030,7 @@ bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     if (ret == WT_NOTFOUND) {
         return false;
     }
@@ -850,7 +1050,7 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     cursor.assertInActiveTxn();
     WT_CURSOR* c = cursor.get();
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old_value;
@@ -866,14 +1066,14 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     _increaseDataSize(opCtx, -old_length);
 }
 
-bool WiredTigerRecordStore::cappedAndNeedDelete() const {
+bool WiredTigerRecordStore::cappedAndNeedDelete(OperationContext* opCtx) const {
     if (!_isCapped)
         return false;
 
-    if (_sizeInfo->dataSize.load() >= _cappedMaxSize)
+    if (dataSize(opCtx) >= _cappedMaxSize)
         return true;
 
-    if ((_cappedMaxDocs != -1) && (_sizeInfo->numRecords.load() > _cappedMaxDocs))
+    if ((_cappedMaxDocs != -1) && (numRecords(opCtx) > _cappedMaxDocs))
         return true;
 
     return false;
@@ -907,7 +1107,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     // This variable isn't thread safe, but has loose semantics anyway.
     dassert(!_isOplog || _cappedMaxDocs == -1);
 
-    if (!cappedAndNeedDelete())
+    if (!cappedAndNeedDelete(opCtx))
         return 0;
 
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
@@ -919,7 +1119,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
         if (!lock.try_lock()) {
             // Someone else is deleting old records. Apply back-pressure if too far behind,
             // otherwise continue.
-            if ((_sizeInfo->dataSize.load() - _cappedMaxSize) < _cappedMaxSizeSlack)
+            if ((dataSize(opCtx) - _cappedMaxSize) < _cappedMaxSizeSlack)
                 return 0;
 
             // Don't wait forever: we're in a transaction, we could block eviction.
@@ -934,7 +1134,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
 
             // If we already waited, let someone else do cleanup unless we are significantly
             // over the limit.
-            if ((_sizeInfo->dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
+            if ((dataSize(opCtx) - _cappedMaxSize) < (2 * _cappedMaxSizeSlack))
                 return 0;
         }
     }
@@ -960,7 +1160,7 @@ void WiredTigerRecordStore::_positionAtFirstRecordId(OperationContext* opCtx,
         if (!forTruncate) {
             int cmp = 0;
             int ret = wiredTigerPrepareConflictRetry(
-                opCtx, [&] { return cursor->search_near(cursor, &cmp); });
+                opCtx, _tableId, [&] { return cursor->search_near(cursor, &cmp); });
             invariantWTOK(ret);
 
             // This is (or was) the first recordId, so it should never be the case that we have a
@@ -969,13 +1169,18 @@ void WiredTigerRecordStore::_positionAtFirstRecordId(OperationContext* opCtx,
         }
     } else {
         invariantWTOK(WT_READ_CHECK(cursor->reset(cursor)));
-        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+        int ret =
+            wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return cursor->next(cursor); });
         invariantWTOK(ret);
     }
 }
 
 int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* opCtx,
                                                             const RecordId& justInserted) {
+    // Read the sizes before switching recovery units, so they include the caller's pending writes.
+    int64_t dataSize = this->dataSize(opCtx);
+    int64_t numRecords = this->numRecords(opCtx);
+
     // we do this in a side transaction in case it aborts
     WiredTigerRecoveryUnit* realRecoveryUnit =
         checked_cast<WiredTigerRecoveryUnit*>(opCtx->releaseRecoveryUnit().release());
@@ -987,9 +1192,6 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
 
     WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
 
-    int64_t dataSize = _sizeInfo->dataSize.load();
-    int64_t numRecords = _sizeInfo->numRecords.load();
-
     int64_t sizeOverCap = (dataSize > _cappedMaxSize) ? dataSize - _cappedMaxSize : 0;
     int64_t sizeSaved = 0;
     int64_t docsOverCap = 0, docsRemoved = 0;
@@ -1009,8 +1211,8 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
         // If we know where the first record is, go to it
         if (_cappedFirstRecord != RecordId()) {
             setKey(truncateEnd, _cappedFirstRecord);
-            ret = wiredTigerPrepareConflictRetry(opCtx,
-                                                 [&] { return truncateEnd->search(truncateEnd); });
+            ret = wiredTigerPrepareConflictRetry(
+                opCtx, _tableId, [&] { return truncateEnd->search(truncateEnd); });
             if (ret == 0) {
                 positioned = true;
                 savedFirstKey = _cappedFirstRecord;
@@ -1019,7 +1221,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
 
         // Advance the cursor truncateEnd until we find a suitable end point for our truncate
         while ((sizeSaved < sizeOverCap || docsRemoved < docsOverCap) && (docsRemoved < 20000) &&
-               (positioned || (ret = wiredTigerPrepareConflictRetry(opCtx, [&] {
+               (positioned || (ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] {
                                    return truncateEnd->next(truncateEnd);
                                })) == 0)) {
             positioned = false;
@@ -1055,7 +1257,7 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded_inlock(OperationContext* op
             // if we scanned to the end of the collection or past our insert, go back one
             if (ret == WT_NOTFOUND || newestIdToDelete >= justInserted) {
                 ret = wiredTigerPrepareConflictRetry(
-                    opCtx, [&] { return truncateEnd->prev(truncateEnd); });
+                    opCtx, _tableId, [&] { return truncateEnd->prev(truncateEnd); });
             }
             invariantWTOK(ret);
 
@@ -1182,7 +1384,8 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
             WT_CURSOR* cursor = cwrap.get();
 
             // The first record in the oplog should be within the truncate range.
-            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
+            int ret = wiredTigerPrepareConflictRetry(
+                opCtx, _tableId, [&] { return cursor->next(cursor); });
             invariantWTOK(ret);
             RecordId firstRecord = getKey(cursor);
             if (firstRecord < _oplogStones->firstRecord || firstRecord > stone->lastRecord) {
@@ -1372,7 +1575,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
     setKey(c, id);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search(c); });
     invariantWTOK(ret);
 
     WT_ITEM old_value;
@@ -1447,7 +1650,7 @@ std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    int ret = wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return start->next(start); });
     // Empty collections don't have anything to truncate.
     if (ret == WT_NOTFOUND) {
         return Status::OK();
@@ -1629,7 +1832,8 @@ boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
 
     int cmp;
     setKey(c, startingPosition);
-    int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search_near(c, &cmp); });
+    int ret =
+        wiredTigerPrepareConflictRetry(opCtx, _tableId, [&] { return c->search_near(c, &cmp); });
     if (ret == 0 && cmp > 0)
         ret = c->prev(c);  // landed one higher than startingPosition
     if (ret == WT_NOTFOUND)
@@ -1664,53 +1868,49 @@ WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext
     return checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
 }
 
-class WiredTigerRecordStore::NumRecordsChange : public RecoveryUnit::Change {
-public:
-    NumRecordsChange(WiredTigerRecordStore* rs, int64_t diff) : _rs(rs), _diff(diff) {}
-    virtual void commit(boost::optional<Timestamp>) {}
-    virtual void rollback() {
-        LOG(3) << "WiredTigerRecordStore: rolling back NumRecordsChange" << -_diff;
-        _rs->_sizeInfo->numRecords.fetchAndAdd(-_diff);
-    }
+WiredTigerRecordStore::SizeChange* WiredTigerRecordStore::_getSizeChange(
+    OperationContext* opCtx) {
+    WiredTigerRecoveryUnit* ru = _getRecoveryUnit(opCtx);
+    if (RecoveryUnit::Change* change = ru->getSizeChange(this))
+        return checked_cast<SizeChange*>(change);
 
-private:
-    WiredTigerRecordStore* _rs;
-    int64_t _diff;
-};
+    auto change = new SizeChange(this);
+    ru->registerSizeChange(this, change);
+    return change;
+}
+
+const WiredTigerRecordStore::SizeChange* WiredTigerRecordStore::_pendingSizeChange(
+    OperationContext* opCtx) const {
+    if (!opCtx)
+        return nullptr;
+    return checked_cast<const SizeChange*>(_getRecoveryUnit(opCtx)->getSizeChange(this));
+}
 
 void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t diff) {
     if (!sizeRecoveryState(getGlobalServiceContext()).collectionNeedsSizeAdjustment(_uri)) {
         return;
     }
 
-    opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
-    if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
-        _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
+    _getSizeChange(opCtx)->numRecords += diff;
 }
 
-class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
-public:
-    DataSizeChange(WiredTigerRecordStore* rs, int64_t amount) : _rs(rs), _amount(amount) {}
-    virtual void commit(boost::optional<Timestamp>) {}
-    virtual void rollback() {
-        _rs->_increaseDataSize(NULL, -_amount);
-    }
-
-private:
-    WiredTigerRecordStore* _rs;
-    int64_t _amount;
-};
-
 void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t amount) {
     if (!sizeRecoveryState(getGlobalServiceContext()).collectionNeedsSizeAdjustment(_uri)) {
         return;
     }
 
-    if (opCtx)
-        opCtx->recoveryUnit()->registerChange(new DataSizeChange(this, amount));
+    _getSizeChange(opCtx)->dataSize += amount;
+}
+
+void WiredTigerRecordStore::_applySizeChange(int64_t numRecordsDiff, int64_t dataSizeDiff) {
+    if (numRecordsDiff == 0 && dataSizeDiff == 0)
+        return;
+
+    if (_sizeInfo->numRecords.fetchAndAdd(numRecordsDiff) < 0)
+        _sizeInfo->numRecords.store(std::max(numRecordsDiff, int64_t(0)));
 
-    if (_sizeInfo->dataSize.fetchAndAdd(amount) < 0)
-        _sizeInfo->dataSize.store(std::max(amount, int64_t(0)));
+    if (_sizeInfo->dataSize.fetchAndAdd(dataSizeDiff) < 0)
+        _sizeInfo->dataSize.store(std::max(dataSizeDiff, int64_t(0)));
 
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
@@ -1852,7 +2052,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         // Note that an unpositioned (or eof) WT_CURSOR returns the first/last entry in the
         // table when you call next/prev.
         int advanceRet = wiredTigerPrepareConflictRetry(
-            _opCtx, [&] { return _forward ? c->next(c) : c->prev(c); });
+            _opCtx, _rs.tableId(), [&] { return _forward ? c->next(c) : c->prev(c); });
         if (advanceRet == WT_NOTFOUND) {
             _eof = true;
             return {};
@@ -1890,7 +2090,8 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     WT_CURSOR* c = _cursor->get();
     setKey(c, id);
     // Nothing after the next line can throw WCEs.
-    int seekRet = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search(c); });
+    int seekRet =
+        wiredTigerPrepareConflictRetry(_opCtx, _rs.tableId(), [&] { return c->search(c); });
     if (seekRet == WT_NOTFOUND) {
         // hasWrongPrefix check not needed for a precise 'WT_CURSOR::search'.
         _eof = true;
@@ -1947,7 +2148,8 @@ bool WiredTigerRecordStoreCursorBase::restore() {
     setKey(c, _lastReturnedId);
 
     int cmp;
-    int ret = wiredTigerPrepareConflictRetry(_opCtx, [&] { return c->search_near(c, &cmp); });
+    int ret = wiredTigerPrepareConflictRetry(
+        _opCtx, _rs.tableId(), [&] { return c->search_near(c, &cmp); });
     RecordId id;
     if (ret == WT_NOTFOUND) {
         _eof = true;
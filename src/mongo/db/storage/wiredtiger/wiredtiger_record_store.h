@@ -278,8 +278,7 @@ protected:
 private:
     class RandomCursor;
 
-    class NumRecordsChange;
-    class DataSizeChange;
+    class SizeChange;
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* opCtx);
 
@@ -290,7 +289,7 @@ private:
 
     RecordId _nextId();
     void _setId(RecordId id);
-    bool cappedAndNeedDelete() const;
+    bool cappedAndNeedDelete(OperationContext* opCtx) const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
     /**
@@ -319,10 +318,27 @@ private:
      *      of zero and will discard all cached size metadata. This assumption is incorrect if there
      *      are pending writes to this ident as part of the recovery process, and so we must
      *      always adjust size metadata for these idents.
+     *
+     * The changes are accumulated in the unit of work of 'opCtx' and only applied to _sizeInfo
+     * when it commits, so concurrent writers do not contend on the shared counters for every
+     * record. numRecords() and dataSize() include the pending changes of the caller.
      */
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
 
+    /**
+     * Returns the change accumulating this record store's size updates in the unit of work of
+     * 'opCtx', registering one on first use. _pendingSizeChange() returns nullptr instead if the
+     * unit of work has not changed the size yet, or if 'opCtx' is null.
+     */
+    SizeChange* _getSizeChange(OperationContext* opCtx);
+    const SizeChange* _pendingSizeChange(OperationContext* opCtx) const;
+
+    /**
+     * Folds the size updates of a committed unit of work into _sizeInfo.
+     */
+    void _applySizeChange(int64_t numRecordsDiff, int64_t dataSizeDiff);
+
     /**
      * Delete records from this record store as needed while _cappedMaxSize or _cappedMaxDocs is
      * exceeded.
@@ -31,17 +31,25 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/platform/atomic_proxy.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObj;
 class OperationContext;
 class RecordId;
 
+// Minimum number of hours worth of oplog to keep, regardless of the oplog's maximum size. Zero
+// means that the oplog is truncated based on size alone.
+extern AtomicDouble oplogMinRetentionHours;
+
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
 class WiredTigerRecordStore::OplogStones {
@@ -70,6 +78,8 @@ public:
 
     void awaitHasExcessStonesOrDead();
 
+    // Returns the oldest stone if the oplog has grown beyond its maximum size and the stone's
+    // records are older than 'oplogMinRetentionHours'.
     boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
 
     void popOldestStone();
@@ -91,6 +101,11 @@ public:
     // Resize oplog size
     void adjust(int64_t maxSize);
 
+    // Saves the stones in the size storer so that the next time the oplog is opened they can be
+    // reused instead of being recomputed. Called when the oplog record store is destroyed, at
+    // which point no more records can be inserted or truncated.
+    void persist();
+
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
     RecordId firstRecord;
@@ -124,6 +139,22 @@ private:
                                     int64_t estRecordsPerStone,
                                     int64_t estBytesPerStone);
 
+    // Draws 'numSamples' random RecordIds from the oplog, splitting the work across several
+    // threads. Returns false if the oplog ran out of records to sample.
+    bool _sampleOplog(OperationContext* opCtx,
+                      int64_t numSamples,
+                      std::vector<RecordId>* samples) const;
+
+    // Restores the stones saved by persist(). Returns false if there were none, or if they no
+    // longer describe the contents of the oplog.
+    bool _loadPersistedStones(OperationContext* opCtx);
+
+    // Returns true if every record in 'stone' is older than the minimum retention period.
+    bool _isOutsideRetentionPeriod(const Stone& stone) const;
+
+    // Returns the time at which 'stone' leaves the minimum retention period.
+    Date_t _retentionDeadline(const Stone& stone) const;
+
     void _pokeReclaimThreadIfNeeded();
 
     static const uint64_t kRandomSamplesPerStone = 10;
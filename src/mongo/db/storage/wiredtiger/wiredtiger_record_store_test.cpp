@@ -868,5 +868,59 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+// Verify that the oldest stone is only offered for truncation once its records are older than
+// 'oplogMinRetentionHours', even when the oplog has grown beyond its maximum size.
+TEST(WiredTigerRecordStoreTest, OplogStones_MinRetentionHours) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(1000);
+
+    const double originalRetentionHours = oplogMinRetentionHours.load();
+    ON_BLOCK_EXIT([&] { oplogMinRetentionHours.store(originalRetentionHours); });
+
+    const unsigned now = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    const unsigned twoHoursAgo = now - 2 * 3600;
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        // A stone of records written two hours ago, followed by twelve stones of recent records.
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(twoHoursAgo, 1), 1000),
+                  RecordId(twoHoursAgo, 1));
+        for (unsigned i = 1; i <= 12; ++i) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, i), 1000),
+                      RecordId(now, i));
+        }
+        ASSERT_EQ(13U, oplogStones->numStones());
+    }
+
+    // Without a minimum retention period, only the size of the oplog matters.
+    oplogMinRetentionHours.store(0);
+    auto stone = oplogStones->peekOldestStoneIfNeeded();
+    ASSERT(stone);
+    ASSERT_EQ(RecordId(twoHoursAgo, 1), stone->lastRecord);
+
+    // Records written two hours ago must be kept for a three hour retention period.
+    oplogMinRetentionHours.store(3);
+    ASSERT_FALSE(oplogStones->peekOldestStoneIfNeeded());
+
+    // They are past a one hour retention period, unlike the recent records.
+    oplogMinRetentionHours.store(1);
+    stone = oplogStones->peekOldestStoneIfNeeded();
+    ASSERT(stone);
+    ASSERT_EQ(RecordId(twoHoursAgo, 1), stone->lastRecord);
+
+    oplogStones->popOldestStone();
+    ASSERT_EQ(12U, oplogStones->numStones());
+    ASSERT_FALSE(oplogStones->peekOldestStoneIfNeeded());
+}
+
 }  // namespace
 }  // namespace mongo
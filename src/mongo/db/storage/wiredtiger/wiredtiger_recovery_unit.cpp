@@ -92,13 +92,14 @@ void WiredTigerRecoveryUnit::_commit() {
         }
 
         if (MONGO_FAIL_POINT(WTAlwaysNotifyPrepareConflictWaiters)) {
-            notifyDone = true;
-        }
-
-        if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            // Tests use this to end simulated prepare conflicts, so wake up every waiter.
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted({});
+        } else if (notifyDone) {
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(_tablesAccessed);
         }
+        _tablesAccessed.clear();
 
+        _sizeChanges.clear();
         for (Changes::const_iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
             (*it)->commit(commitTime);
         }
@@ -118,13 +119,14 @@ void WiredTigerRecoveryUnit::_abort() {
         }
 
         if (MONGO_FAIL_POINT(WTAlwaysNotifyPrepareConflictWaiters)) {
-            notifyDone = true;
-        }
-
-        if (notifyDone) {
-            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted();
+            // Tests use this to end simulated prepare conflicts, so wake up every waiter.
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted({});
+        } else if (notifyDone) {
+            _sessionCache->notifyPreparedUnitOfWorkHasCommittedOrAborted(_tablesAccessed);
         }
+        _tablesAccessed.clear();
 
+        _sizeChanges.clear();
         for (Changes::const_reverse_iterator it = _changes.rbegin(), end = _changes.rend();
              it != end;
              ++it) {
@@ -203,6 +205,20 @@ void WiredTigerRecoveryUnit::registerChange(Change* change) {
     _changes.push_back(std::unique_ptr<Change>{change});
 }
 
+void WiredTigerRecoveryUnit::registerSizeChange(const WiredTigerRecordStore* rs, Change* change) {
+    invariant(!getSizeChange(rs));
+    registerChange(change);
+    _sizeChanges.emplace_back(rs, change);
+}
+
+RecoveryUnit::Change* WiredTigerRecoveryUnit::getSizeChange(const WiredTigerRecordStore* rs) const {
+    for (auto&& entry : _sizeChanges) {
+        if (entry.first == rs)
+            return entry.second;
+    }
+    return nullptr;
+}
+
 void WiredTigerRecoveryUnit::assertInActiveTxn() const {
     fassert(28575, _active);
 }
@@ -32,6 +32,7 @@
 
 #include <wiredtiger.h>
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <memory>
@@ -50,6 +51,7 @@
 namespace mongo {
 
 class BSONObjBuilder;
+class WiredTigerRecordStore;
 
 class WiredTigerRecoveryUnit final : public RecoveryUnit {
 public:
@@ -76,6 +78,26 @@ public:
 
     void registerChange(Change* change) override;
 
+    /**
+     * Registers 'change' like registerChange() and remembers it as the change accumulating the
+     * size updates that this unit of work makes to 'rs'. getSizeChange() returns it until the
+     * unit of work commits or aborts, and nullptr if none was registered.
+     */
+    void registerSizeChange(const WiredTigerRecordStore* rs, Change* change);
+    Change* getSizeChange(const WiredTigerRecordStore* rs) const;
+
+    /**
+     * Notes that the current unit of work opened a cursor on the table with the given id. If the
+     * unit of work is prepared, readers that run into a prepare conflict on one of these tables
+     * are woken up when it commits or aborts.
+     */
+    void noteTableAccess(uint64_t tableId) {
+        if (_inUnitOfWork &&
+            std::find(_tablesAccessed.begin(), _tablesAccessed.end(), tableId) ==
+                _tablesAccessed.end())
+            _tablesAccessed.push_back(tableId);
+    }
+
     void abandonSnapshot() override;
     void preallocateSnapshot() override;
 
@@ -198,5 +220,10 @@ private:
     bool _isOplogReader = false;
     typedef std::vector<std::unique_ptr<Change>> Changes;
     Changes _changes;
+    // The size changes among _changes, by record store. A unit of work rarely writes to more than
+    // a few record stores, so these are looked up by a linear search.
+    std::vector<std::pair<const WiredTigerRecordStore*, Change*>> _sizeChanges;
+    // The tables this unit of work opened cursors on, see noteTableAccess(). Usually only a few.
+    std::vector<uint64_t> _tablesAccessed;
 };
 }
@@ -283,6 +283,30 @@ TEST_F(WiredTigerRecoveryUnitTestFixture, WriteOnADocumentBeingPreparedTriggersW
     ru2->abortUnitOfWork();
 }
 
+TEST_F(WiredTigerRecoveryUnitTestFixture, PreparedUnitOfWorkOnlyWakesReadersOfItsTables) {
+    OperationContext* opCtx = clientAndCtx1.second.get();
+    std::unique_ptr<RecordStore> rs(harnessHelper->createRecordStore(opCtx, "a.b"));
+    auto tableId = checked_cast<WiredTigerRecordStore*>(rs.get())->tableId();
+    auto otherTableId = tableId + 1;
+
+    auto sessionCache = ru1->getSessionCache();
+    auto count = sessionCache->getPrepareCommitOrAbortCount(tableId);
+    auto otherCount = sessionCache->getPrepareCommitOrAbortCount(otherTableId);
+
+    ru1->beginUnitOfWork(opCtx);
+    ASSERT_OK(rs->insertRecord(opCtx, "data", 5, Timestamp()).getStatus());
+    ru1->setPrepareTimestamp({1, 1});
+    ru1->prepareUnitOfWork();
+    ru1->abortUnitOfWork();
+
+    ASSERT_EQ(count + 1, sessionCache->getPrepareCommitOrAbortCount(tableId));
+    ASSERT_EQ(otherCount, sessionCache->getPrepareCommitOrAbortCount(otherTableId));
+
+    // Waiting for an end that already happened returns right away.
+    sessionCache->waitUntilPreparedUnitOfWorkCommitsOrAborts(
+        clientAndCtx2.second.get(), tableId, count);
+}
+
 TEST_F(WiredTigerRecoveryUnitTestFixture,
        ChangeIsPassedEmptyLastTimestampSetOnCommitWithNoTimestamp) {
     boost::optional<Timestamp> commitTs = boost::none;
@@ -542,7 +566,7 @@ TEST_F(WiredTigerRecoveryUnitTestFixture, ReadOnceCursorsAreNotCached) {
     ru->beginUnitOfWork(opCtx);
     StatusWith<RecordId> s = rs->insertRecord(opCtx, "data", 4, Timestamp());
     ASSERT_TRUE(s.isOK());
-    ASSERT_EQUALS(1, rs->numRecords(NULL));
+    ASSERT_EQUALS(1, rs->numRecords(opCtx));
     ru->commitUnitOfWork();
 
     // Test 1: A normal read should create a new cursor and release it into the session cache.
@@ -36,6 +36,12 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <bitset>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/error_codes.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
@@ -135,13 +141,20 @@ void _openCursor(WT_SESSION* session,
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool allowOverwrite) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
+    auto range = _cursorIndex.equal_range(id);
+    if (range.first != range.second) {
+        auto newest = range.first;
+        for (auto i = std::next(range.first); i != range.second; ++i) {
+            if (i->second->_gen > newest->second->_gen)
+                newest = i;
         }
+
+        CursorCache::iterator i = newest->second;
+        WT_CURSOR* c = i->_cursor;
+        _cursorIndex.erase(newest);
+        _cursors.erase(i);
+        _cursorsOut++;
+        return c;
     }
 
     WT_CURSOR* cursor = NULL;
@@ -168,17 +181,36 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorIndex.emplace(id, _cursors.begin());
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(kWiredTigerCursorCacheSize.load());
 
     while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
         cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
+        _eraseCachedCursor(std::prev(_cursors.end()));
         invariantWTOK(cursor->close(cursor));
     }
 }
 
+void WiredTigerSession::_eraseCachedCursor(CursorCache::iterator it) {
+    auto range = _cursorIndex.equal_range(it->_id);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == it) {
+            _cursorIndex.erase(i);
+            break;
+        }
+    }
+    _cursors.erase(it);
+}
+
+void WiredTigerSession::_reindexCursors() {
+    _cursorIndex.clear();
+    for (auto i = _cursors.begin(); i != _cursors.end(); ++i) {
+        _cursorIndex.emplace(i->_id, i);
+    }
+}
+
 void WiredTigerSession::closeCursor(WT_CURSOR* cursor) {
     invariant(_session);
     invariant(cursor);
@@ -195,7 +227,7 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
         WT_CURSOR* cursor = i->_cursor;
         if (cursor && (all || uri == cursor->uri)) {
             invariantWTOK(cursor->close(cursor));
-            i = _cursors.erase(i);
+            _eraseCachedCursor(i++);
         } else
             ++i;
     }
@@ -206,6 +238,9 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty()) {
+        _reindexCursors();
+    }
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -225,11 +260,25 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+size_t numSessionPartitions() {
+    return std::max(1U, stdx::thread::hardware_concurrency());
+}
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _shuttingDown(0),
+      _numPartitions(numSessionPartitions()),
+      _partitions(stdx::make_unique<SessionPartition[]>(_numPartitions)) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _shuttingDown(0),
+      _numPartitions(numSessionPartitions()),
+      _partitions(stdx::make_unique<SessionPartition[]>(_numPartitions)) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -284,19 +333,13 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         UniqueWiredTigerSession session = getSession();
         WT_SESSION* s = session->getSession();
         auto encryptionKeyDB = _engine->getEncryptionKeyDB();
-        std::unique_ptr<WiredTigerSession> session2;
-        WT_SESSION* s2 = nullptr;
-        if (encryptionKeyDB) {
-            session2 = stdx::make_unique<WiredTigerSession>(encryptionKeyDB->getConnection());
-            s2 = session2->getSession();
-        }
         {
             stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
             JournalListener::Token token = _journalListener->getToken();
             auto config = stableCheckpoint ? "use_timestamp=true" : "use_timestamp=false";
             invariantWTOK(s->checkpoint(s, config));
-            if (s2)
-                invariantWTOK(s2->checkpoint(s2, config));
+            if (encryptionKeyDB)
+                invariantWTOK(encryptionKeyDB->checkpoint(config));
             _journalListener->onDurable(token);
         }
         LOG(4) << "created checkpoint (forced)";
@@ -326,14 +369,6 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         invariantWTOK(
             _conn->open_session(_conn, NULL, "isolation=snapshot", &_waitUntilDurableSession));
     }
-    if (!_keyDBSession) {
-        auto encryptionKeyDB = _engine->getEncryptionKeyDB();
-        if (encryptionKeyDB) {
-            auto conn = encryptionKeyDB->getConnection();
-            invariantWTOK(
-                conn->open_session(conn, nullptr, "isolation=snapshot", &_keyDBSession));
-        }
-    }
 
     // Use the journal when available, or a checkpoint otherwise.
     if (_engine && _engine->isDurable()) {
@@ -345,57 +380,175 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     }
 
     // keyDB is always durable (opened with journal enabled)
-    if (_keyDBSession) {
-        invariantWTOK(_keyDBSession->log_flush(_keyDBSession, "sync=on"));
+    auto encryptionKeyDB = _engine ? _engine->getEncryptionKeyDB() : nullptr;
+    if (encryptionKeyDB) {
+        invariantWTOK(encryptionKeyDB->log_flush());
     }
 
     _journalListener->onDurable(token);
 }
 
-void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx) {
-    invariant(opCtx);
-    stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
+std::uint64_t WiredTigerSessionCache::getPrepareCommitOrAbortCount(std::uint64_t tableId) const {
+    return _prepareWaitStripe(tableId).commitOrAbortCounter.load();
+}
 
-    auto lastCounter = _lastCommitOrAbortCounter;
-    opCtx->waitForConditionOrInterrupt(_prepareCommittedOrAbortedCond, lk, [&] {
-        return lastCounter != _lastCommitOrAbortCounter;
+void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
+                                                                       std::uint64_t tableId,
+                                                                       std::uint64_t lastCount) {
+    invariant(opCtx);
+    auto& stripe = _prepareWaitStripe(tableId);
+    stdx::unique_lock<stdx::mutex> lk(stripe.mutex);
+    opCtx->waitForConditionOrInterrupt(stripe.cond, lk, [&] {
+        return lastCount != stripe.commitOrAbortCounter.load();
     });
 }
 
-void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
-    {
-        stdx::unique_lock<stdx::mutex> lk(_prepareCommittedOrAbortedMutex);
-        _lastCommitOrAbortCounter++;
+void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted(
+    const std::vector<std::uint64_t>& tableIds) {
+    auto notify = [](PrepareWaitStripe& stripe) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+            stripe.commitOrAbortCounter.fetchAndAdd(1);
+        }
+        stripe.cond.notify_all();
+    };
+
+    if (tableIds.empty()) {
+        for (auto& stripe : _prepareWaitStripes)
+            notify(stripe);
+        return;
+    }
+
+    // Several tables may share a stripe, notify each one once.
+    std::bitset<kPrepareWaitStripes> notified;
+    for (auto tableId : tableIds) {
+        size_t index = tableId % kPrepareWaitStripes;
+        if (notified[index])
+            continue;
+        notified.set(index);
+        notify(_prepareWaitStripes[index]);
     }
-    _prepareCommittedOrAbortedCond.notify_all();
 }
 
 
-void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
+size_t WiredTigerSessionCache::_homePartition() const {
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<size_t>(cpu) % _numPartitions;
+    }
+#endif
+    // Without a way to tell which CPU we are on, spread the threads over the partitions.
+    static AtomicUInt32 nextPartition;
+    static thread_local uint32_t partition = nextPartition.fetchAndAdd(1);
+    return partition % _numPartitions;
+}
+
+WiredTigerSession* WiredTigerSessionCache::_takeCachedSession() {
+    const size_t home = _homePartition();
+    for (size_t i = 0; i < _numPartitions; ++i) {
+        SessionPartition& partition = _partitions[(home + i) % _numPartitions];
+        if (partition.numCached.loadRelaxed() <= 0)
+            continue;
+
+        for (auto& slot : partition.slots) {
+            if (!slot.loadRelaxed())
+                continue;
+            if (WiredTigerSession* session = slot.swap(nullptr)) {
+                partition.numCached.fetchAndSubtract(1);
+                return session;
+            }
+        }
+    }
+
+    if (_numOverflowSessions.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        if (!_sessions.empty()) {
+            // Get the most recently used session so that if we discard sessions, we're
+            // discarding older ones
+            WiredTigerSession* session = _sessions.back();
+            _sessions.pop_back();
+            _numOverflowSessions.store(_sessions.size());
+            return session;
+        }
+    }
+
+    return nullptr;
+}
+
+void WiredTigerSessionCache::_putCachedSession(WiredTigerSession* session, size_t partitionIdx) {
+    SessionPartition& partition = _partitions[partitionIdx];
+    for (auto& slot : partition.slots) {
+        if (slot.loadRelaxed())
+            continue;
+        if (!slot.compareAndSwap(nullptr, session)) {
+            partition.numCached.fetchAndAdd(1);
+            return;
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    _sessions.push_back(session);
+    _numOverflowSessions.store(_sessions.size());
+}
+
+template <typename Func>
+void WiredTigerSessionCache::_forEachCachedSession(Func func) {
+    for (size_t i = 0; i < _numPartitions; ++i) {
+        SessionPartition& partition = _partitions[i];
+        for (auto& slot : partition.slots) {
+            WiredTigerSession* session = slot.swap(nullptr);
+            if (!session)
+                continue;
+
+            func(session);
+
+            // Put the session back where it was, unless another one took its place meanwhile.
+            if (slot.compareAndSwap(nullptr, session)) {
+                partition.numCached.fetchAndSubtract(1);
+                _putCachedSession(session, i);
+            }
+        }
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_cacheLock);
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+        func(*i);
     }
 }
 
+void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
+    _forEachCachedSession([&](WiredTigerSession* session) { session->closeAllCursors(uri); });
+}
+
 void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
-    }
+    _forEachCachedSession(
+        [&](WiredTigerSession* session) { session->closeCursorsForQueuedDrops(_engine); });
 }
 
 void WiredTigerSessionCache::closeAll() {
     // Increment the epoch as we are now closing all sessions with this epoch.
+    _epoch.fetchAndAdd(1);
+
     SessionCache swap;
+    for (size_t i = 0; i < _numPartitions; ++i) {
+        SessionPartition& partition = _partitions[i];
+        for (auto& slot : partition.slots) {
+            if (WiredTigerSession* session = slot.swap(nullptr)) {
+                partition.numCached.fetchAndSubtract(1);
+                swap.push_back(session);
+            }
+        }
+    }
 
     {
         stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+        swap.insert(swap.end(), _sessions.begin(), _sessions.end());
+        _sessions.clear();
+        _numOverflowSessions.store(0);
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -412,18 +565,16 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+    while (WiredTigerSession* cachedSession = _takeCachedSession()) {
+        // A session released while closeAll() was running may have been cached after the epoch
+        // was incremented, so it has to be checked here.
+        if (cachedSession->_getEpoch() == _epoch.load()) {
             return UniqueWiredTigerSession(cachedSession);
         }
+        delete cachedSession;
     }
 
-    // Outside of the cache partition lock, but on release will be put back on the cache
+    // On release will be put back on the cache
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -476,12 +627,10 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     // session cache.
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
-    if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
-            returnedToCache = true;
-            _sessions.push_back(session);
-        }
+    if (session->_getEpoch() == currentEpoch) {
+        // If closeAll() runs concurrently, getSession() discards the session instead of reusing it.
+        returnedToCache = true;
+        _putCachedSession(session, _homePartition());
     } else
         invariant(session->_getEpoch() < currentEpoch);
 
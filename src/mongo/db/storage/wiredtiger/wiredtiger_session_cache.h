@@ -33,14 +33,18 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
@@ -162,6 +166,16 @@ private:
     // The cursor cache is a list of pairs that contain an ID and cursor
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Maps table IDs to the cached cursors on that table, so that getCursor() does not need to
+    // walk the whole cursor cache.
+    typedef stdx::unordered_multimap<uint64_t, CursorCache::iterator> CursorIndex;
+
+    // Removes the cursor at 'it' from both the cursor cache and the index.
+    void _eraseCachedCursor(CursorCache::iterator it);
+
+    // Rebuilds '_cursorIndex' after cursors were removed from '_cursors' directly.
+    void _reindexCursors();
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -177,6 +191,7 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorIndex _cursorIndex;        // references the entries of _cursors
     uint64_t _cursorGen;
     int _cursorsOut;
     bool _dropQueuedIdentsAtSessionEnd = true;
@@ -245,24 +260,35 @@ public:
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
     /**
-     * Waits until a prepared unit of work has ended (either been commited or aborted). This
-     * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
-     * the conflicting WiredTiger API operation. A return from this function does not guarantee that
-     * the conflicting transaction has ended, only that one prepared unit of work in the process has
-     * signaled that it has ended.
+     * Returns the number of prepared units of work that have ended so far among those that wrote
+     * to the table with the given id. To be read before the WiredTiger API operation that may run
+     * into a prepare conflict, and passed to waitUntilPreparedUnitOfWorkCommitsOrAborts().
+     */
+    std::uint64_t getPrepareCommitOrAbortCount(std::uint64_t tableId) const;
+
+    /**
+     * Waits until a prepared unit of work that wrote to the table with the given id has ended
+     * (either been commited or aborted) since getPrepareCommitOrAbortCount() returned
+     * 'lastCount'. This should be used when encountering WT_PREPARE_CONFLICT errors. The caller is
+     * required to retry the conflicting WiredTiger API operation. A return from this function does
+     * not guarantee that the conflicting transaction has ended, only that one prepared unit of
+     * work that may have caused the conflict has signaled that it has ended. Prepared units of
+     * work on unrelated tables do not wake the caller up.
      * Accepts an OperationContext that will throw an AssertionException when interrupted.
      *
      * This method is provided in WiredTigerSessionCache and not RecoveryUnit because all recovery
      * units share the same session cache, and we want a recovery unit on one thread to signal all
      * recovery units waiting for prepare conflicts across all other threads.
      */
-    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx);
+    void waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
+                                                    std::uint64_t tableId,
+                                                    std::uint64_t lastCount);
 
     /**
-     * Notifies waiters that the caller's perpared unit of work has ended (either committed or
-     * aborted).
+     * Notifies waiters that the caller's perpared unit of work, which wrote to the tables with the
+     * given ids, has ended (either committed or aborted). An empty 'tableIds' notifies all waiters.
      */
-    void notifyPreparedUnitOfWorkHasCommittedOrAborted();
+    void notifyPreparedUnitOfWorkHasCommittedOrAborted(const std::vector<std::uint64_t>& tableIds);
 
     WT_CONNECTION* conn() const {
         return _conn;
@@ -296,9 +322,26 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
+    // Released sessions are spread over one partition per CPU. A thread looks for a session in
+    // the partition of the CPU it is running on first, and only steals from the other partitions
+    // if that is empty, so that threads on different CPUs do not contend on a single lock. Each
+    // partition is a small array of slots that sessions are atomically swapped in and out of.
+    struct SessionPartition {
+        static const size_t kNumSlots = 16;
+
+        // Approximate number of occupied slots, used to skip empty partitions when stealing.
+        AtomicInt32 numCached;
+        AtomicWord<WiredTigerSession*> slots[kNumSlots];
+    };
+
+    const size_t _numPartitions;
+    std::unique_ptr<SessionPartition[]> _partitions;
+
+    // Released sessions that did not fit in their partition.
     stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
     SessionCache _sessions;
+    AtomicInt32 _numOverflowSessions;  // size of _sessions, readable without _cacheLock
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -310,10 +353,23 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
-    // Mutex and cond var for waiting on prepare commit or abort.
-    stdx::mutex _prepareCommittedOrAbortedMutex;
-    stdx::condition_variable _prepareCommittedOrAbortedCond;
-    std::uint64_t _lastCommitOrAbortCounter;
+    // Mutex, cond var and counter for waiting on prepare commit or abort, for the tables whose id
+    // maps to the stripe. Readers that hit a prepare conflict wait on the stripe of the table, so
+    // they only wake up when a prepared unit of work that wrote to a table of that stripe ends.
+    struct PrepareWaitStripe {
+        stdx::mutex mutex;
+        stdx::condition_variable cond;
+        AtomicUInt64 commitOrAbortCounter;
+    };
+    static const size_t kPrepareWaitStripes = 64;
+    PrepareWaitStripe _prepareWaitStripes[kPrepareWaitStripes];
+
+    PrepareWaitStripe& _prepareWaitStripe(std::uint64_t tableId) {
+        return _prepareWaitStripes[tableId % kPrepareWaitStripes];
+    }
+    const PrepareWaitStripe& _prepareWaitStripe(std::uint64_t tableId) const {
+        return _prepareWaitStripes[tableId % kPrepareWaitStripes];
+    }
 
     // Protects _journalListener.
     stdx::mutex _journalListenerMutex;
@@ -323,13 +379,34 @@ private:
     WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
                                                      // (uses connection close to clean up)
 
-    WT_SESSION* _keyDBSession = nullptr;  // keyDB analog of _waitUntilDurableSession
 
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the partition of the CPU the calling thread is running on.
+     */
+    size_t _homePartition() const;
+
+    /**
+     * Takes a released session out of the cache, or returns nullptr if the cache is empty.
+     */
+    WiredTigerSession* _takeCachedSession();
+
+    /**
+     * Puts a released session into the cache, starting with the given partition.
+     */
+    void _putCachedSession(WiredTigerSession* session, size_t partition);
+
+    /**
+     * Calls 'func' on every cached session while it is taken out of the cache, so that no other
+     * thread can use it at the same time.
+     */
+    template <typename Func>
+    void _forEachCachedSession(Func func);
 };
 
 /**
@@ -0,0 +1,160 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxTables = 64;
+
+// Number of times each table's cursor is taken from a session in BM_CursorReuse.
+const int kCursorRounds = 8;
+
+/**
+ * A WiredTiger connection with a number of empty tables, and a session cache on top of it.
+ */
+class SessionCacheFixture {
+public:
+    SessionCacheFixture() : _dir("wiredtiger_session_cache_bm") {
+        invariantWTOK(wiredtiger_open(_dir.path().c_str(), nullptr, "create", &_conn));
+
+        WT_SESSION* session;
+        invariantWTOK(_conn->open_session(_conn, nullptr, nullptr, &session));
+        for (int i = 0; i < kMaxTables; ++i) {
+            _uris.push_back(str::stream() << "table:session_cache_bm_" << i);
+            _tableIds.push_back(WiredTigerSession::genTableId());
+            invariantWTOK(
+                session->create(session, _uris.back().c_str(), "key_format=q,value_format=u"));
+        }
+        invariantWTOK(session->close(session, nullptr));
+
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+    }
+
+    ~SessionCacheFixture() {
+        _sessionCache.reset();
+        invariantWTOK(_conn->close(_conn, nullptr));
+    }
+
+    WiredTigerSessionCache* getSessionCache() const {
+        return _sessionCache.get();
+    }
+
+    const std::string& getUri(int table) const {
+        return _uris[table];
+    }
+
+    uint64_t getTableId(int table) const {
+        return _tableIds[table];
+    }
+
+private:
+    unittest::TempDir _dir;
+    WT_CONNECTION* _conn = nullptr;
+    std::vector<std::string> _uris;
+    std::vector<uint64_t> _tableIds;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+/**
+ * Benchmark taking a session from the session cache and releasing it again, which every operation
+ * does through its recovery unit.
+ *
+ * All threads executing the benchmark use the same session cache. It is only usable inside the
+ * benchmark loop, which the threads enter and leave together.
+ */
+void BM_SessionCheckout(benchmark::State& state) {
+    static std::unique_ptr<SessionCacheFixture> fixture;
+    if (state.thread_index == 0) {
+        fixture = stdx::make_unique<SessionCacheFixture>();
+    }
+
+    for (auto keepRunning : state) {
+        UniqueWiredTigerSession session = fixture->getSessionCache()->getSession();
+        benchmark::DoNotOptimize(session.get());
+    }
+
+    if (state.thread_index == 0) {
+        fixture.reset();
+    }
+}
+
+/**
+ * Benchmark getting cursors from a session's cursor cache and releasing them again. Each iteration
+ * takes a session and uses a cursor on each of the first N tables several times, where N is the
+ * argument. Only the first use of each table opens a cursor, the other ones find it in the cache.
+ */
+void BM_CursorReuse(benchmark::State& state) {
+    static std::unique_ptr<SessionCacheFixture> fixture;
+    if (state.thread_index == 0) {
+        fixture = stdx::make_unique<SessionCacheFixture>();
+    }
+
+    const int numTables = state.range(0);
+    for (auto keepRunning : state) {
+        UniqueWiredTigerSession session = fixture->getSessionCache()->getSession();
+        for (int round = 0; round < kCursorRounds; ++round) {
+            for (int table = 0; table < numTables; ++table) {
+                const uint64_t tableId = fixture->getTableId(table);
+                WT_CURSOR* cursor = session->getCursor(fixture->getUri(table), tableId, false);
+                session->releaseCursor(tableId, cursor);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kCursorRounds * numTables);
+
+    if (state.thread_index == 0) {
+        fixture.reset();
+    }
+}
+
+BENCHMARK(BM_SessionCheckout)->ThreadRange(1, ProcessInfo::getNumAvailableCores());
+
+BENCHMARK(BM_CursorReuse)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("tables")
+    ->RangeMultiplier(4)
+    ->Range(1, kMaxTables);
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -46,10 +47,19 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+namespace {
+// Oplog stones share the table with size information. The prefix keeps them apart from the
+// "table:" URIs used as keys for the latter.
+std::string oplogStonesKey(StringData uri) {
+    return str::stream() << "oplogStones:" << uri;
+}
+}  // namespace
+
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
                                            bool readOnly)
@@ -122,6 +132,8 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
     auto result = std::make_shared<SizeInfo>();
     result->numRecords.store(data["numRecords"].safeNumberLong());
     result->dataSize.store(data["dataSize"].safeNumberLong());
+    result->_flushedNumRecords = result->numRecords.load();
+    result->_flushedDataSize = result->dataSize.load();
     return result;
 }
 
@@ -151,6 +163,15 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         WT_SESSION* session = _session.getSession();
         WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
 
+        // The values written by this transaction, remembered in the SizeInfos once it commits.
+        struct Written {
+            SizeInfo* sizeInfo;
+            int64_t numRecords;
+            int64_t dataSize;
+        };
+        std::vector<Written> written;
+        written.reserve(buffer.size());
+
         for (auto it = buffer.begin(); it != buffer.end(); ++it) {
 
             // Ordering is important here: when the store method checks if the SizeInfo
@@ -158,8 +179,18 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             // still be written back. So, the required order is to clear the dirty flag first.
             SizeInfo& sizeInfo = *it->second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            const int64_t numRecords = sizeInfo.numRecords.load();
+            const int64_t dataSize = sizeInfo.dataSize.load();
+
+            // Writers that insert and remove at the same pace often leave a collection where it
+            // was, in which case the table already holds the current values.
+            if (numRecords == sizeInfo._flushedNumRecords &&
+                dataSize == sizeInfo._flushedDataSize)
+                continue;
+
+            written.push_back({&sizeInfo, numRecords, dataSize});
+            BSONObj data = BSON("numRecords" << static_cast<long long>(numRecords) << "dataSize"
+                                             << static_cast<long long>(dataSize));
 
             auto& uri = it->first;
             LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
@@ -171,10 +202,57 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         }
         txnOpen.done();
         invariantWTOK(session->commit_transaction(session, nullptr));
+        for (auto&& entry : written) {
+            entry.sizeInfo->_flushedNumRecords = entry.numRecords;
+            entry.sizeInfo->_flushedDataSize = entry.dataSize;
+        }
         buffer.clear();
     }
 
     auto micros = t.micros();
     LOG(2) << "WiredTigerSizeStorer flush took " << micros << " µs";
 }
+
+void WiredTigerSizeStorer::storeOplogStones(StringData uri, const BSONObj& stones) {
+    if (_readOnly)
+        return;
+
+    const std::string key = oplogStonesKey(uri);
+
+    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
+    // Intentionally ignoring return value.
+    ON_BLOCK_EXIT(_cursor->reset, _cursor);
+
+    LOG(2) << "WiredTigerSizeStorer::storeOplogStones " << uri << " -> " << redact(stones);
+    WiredTigerItem keyItem(key.c_str(), key.size());
+    WiredTigerItem value(stones.objdata(), stones.objsize());
+    _cursor->set_key(_cursor, keyItem.Get());
+    _cursor->set_value(_cursor, value.Get());
+    invariantWTOK(_cursor->insert(_cursor));
+}
+
+BSONObj WiredTigerSizeStorer::takeOplogStones(StringData uri) {
+    const std::string key = oplogStonesKey(uri);
+
+    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
+    // Intentionally ignoring return value.
+    ON_BLOCK_EXIT(_cursor->reset, _cursor);
+
+    WiredTigerItem keyItem(key.c_str(), key.size());
+    _cursor->set_key(_cursor, keyItem.Get());
+    int ret = _cursor->search(_cursor);
+    if (ret == WT_NOTFOUND)
+        return BSONObj();
+    invariantWTOK(ret);
+
+    WT_ITEM value;
+    invariantWTOK(_cursor->get_value(_cursor, &value));
+    BSONObj stones = BSONObj(reinterpret_cast<const char*>(value.data)).getOwned();
+
+    LOG(2) << "WiredTigerSizeStorer::takeOplogStones " << uri << " -> " << redact(stones);
+    if (!_readOnly) {
+        invariantWTOK(_cursor->remove(_cursor));
+    }
+    return stones;
+}
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
@@ -50,8 +51,10 @@ namespace mongo {
  * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields.
  * This buffering is neccessary to allow concurrent updates of size information without causing
  * write conflicts. The dirty size information is periodically stored written back to the table,
- * including on clean shutdown and/or catalog reload. Crashes or replica-set fail-overs may result
- * in size updates to be lost, so size information is only approximate. Reads use the buffer for
+ * including ahead of every journal flush, on clean shutdown and/or catalog reload. With journaling
+ * enabled, a crash thus loses at most the size updates of the last journal commit interval.
+ * Replica-set fail-overs may still result in size updates to be lost, so size information is only
+ * approximate. Reads use the buffer for
  * pending stores, or otherwise read directly from the WiredTiger table using a dedicated session
  * and cursor.
  */
@@ -74,6 +77,9 @@ public:
     private:
         friend WiredTigerSizeStorer;
         AtomicBool _dirty;
+        // The values last written to the table, or -1 if unknown. Guarded by _cursorMutex.
+        int64_t _flushedNumRecords = -1;
+        int64_t _flushedDataSize = -1;
     };
 
     WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -90,10 +96,23 @@ public:
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table in a single transaction. Entries whose values
+     * are back to what was last written are skipped.
      */
     void flush(bool syncToDisk);
 
+    /**
+     * Saves a description of the oplog stones of the record store with the given URI, replacing
+     * any previously saved one. Unlike size information, this is written to the table right away.
+     */
+    void storeOplogStones(StringData uri, const BSONObj& stones);
+
+    /**
+     * Returns the oplog stones saved for the given URI and removes them from the table, so that
+     * they are used at most once. Returns an empty object if none were saved.
+     */
+    BSONObj takeOplogStones(StringData uri);
+
 private:
     const WiredTigerSession _session;
     const bool _readOnly;
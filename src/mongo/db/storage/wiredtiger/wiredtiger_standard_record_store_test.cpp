@@ -138,6 +138,13 @@ public:
     virtual std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
                                                               int64_t cappedMaxSize,
                                                               int64_t cappedMaxDocs) {
+        return newCappedRecordStore(ns, cappedMaxSize, cappedMaxDocs, nullptr);
+    }
+
+    std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
+                                                      int64_t cappedMaxSize,
+                                                      int64_t cappedMaxDocs,
+                                                      WiredTigerSizeStorer* sizeStorer) {
         WiredTigerRecoveryUnit* ru =
             dynamic_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -168,7 +175,7 @@ public:
         params.cappedMaxSize = cappedMaxSize;
         params.cappedMaxDocs = cappedMaxDocs;
         params.cappedCallback = nullptr;
-        params.sizeStorer = nullptr;
+        params.sizeStorer = sizeStorer;
 
         auto ret = stdx::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
         ret->postConstructorInit(&opCtx);
@@ -296,6 +303,119 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+// Size changes stay with the unit of work that made them until it commits: they are visible to its
+// own operation, but not to others, and are simply dropped if it aborts.
+TEST(WiredTigerRecordStoreTest, SizeChangesAppliedOnCommit) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ServiceContext::UniqueOperationContext otherOpCtx(harnessHelper->newOperationContext());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 3; i++) {
+            ASSERT_OK(rs->insertRecord(opCtx.get(), "abc", 4, Timestamp()).getStatus());
+        }
+        ASSERT_EQUALS(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS(12, rs->dataSize(opCtx.get()));
+        ASSERT_EQUALS(0, rs->numRecords(otherOpCtx.get()));
+        ASSERT_EQUALS(0, rs->dataSize(otherOpCtx.get()));
+        uow.commit();
+    }
+
+    ASSERT_EQUALS(3, rs->numRecords(otherOpCtx.get()));
+    ASSERT_EQUALS(12, rs->dataSize(otherOpCtx.get()));
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), "abcdefg", 8, Timestamp()).getStatus());
+        ASSERT_EQUALS(4, rs->numRecords(opCtx.get()));
+        ASSERT_EQUALS(20, rs->dataSize(opCtx.get()));
+    }
+
+    ASSERT_EQUALS(3, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(12, rs->dataSize(opCtx.get()));
+}
+
+// Insert enough records into an oplog to create a few stones, then reopen it. The stones saved in
+// the size storer when the oplog is closed should be reused instead of being recomputed, unless
+// they no longer match the contents of the oplog.
+TEST(WiredTigerRecordStoreTest, OplogStonesPersistedAcrossReopen) {
+    WiredTigerHarnessHelper harnessHelper;
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper.conn(), "table:sizeStorer", enableWtLogging);
+
+    const std::string ns = "local.oplog.stones";
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB, so each stone is at least 1KB.
+    unique_ptr<RecordStore> rs = harnessHelper.newCappedRecordStore(ns, cappedMaxSize, -1, &ss);
+    WiredTigerRecordStore* wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    const std::string uri = wtrs->getURI();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        for (unsigned i = 1; i <= 11; ++i) {
+            BSONObj obj = BSON("ts" << Timestamp(1, i) << "pad" << std::string(480, 'x'));
+            WriteUnitOfWork wuow(opCtx.get());
+            ASSERT_OK(wtrs->oplogDiskLocRegister(opCtx.get(), Timestamp(1, i), false));
+            ASSERT_OK(rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), Timestamp(1, i))
+                          .getStatus());
+            wuow.commit();
+        }
+    }
+
+    const size_t numStones = wtrs->oplogStones()->numStones();
+    const int64_t currentRecords = wtrs->oplogStones()->currentRecords();
+    ASSERT_GT(numStones, 0U);
+    ASSERT_GT(currentRecords, 0);
+
+    rs.reset();
+
+    BSONObj saved = ss.takeOplogStones(uri);
+    ASSERT_EQ(11, saved["numRecords"].numberLong());
+    ASSERT_EQ(static_cast<int>(numStones), saved["stones"].Obj().nFields());
+    ASSERT_EQ(currentRecords, saved["currentRecords"].numberLong());
+    ASSERT(ss.takeOplogStones(uri).isEmpty());
+
+    // Scanning the oplog could not come up with this many records in the current stone, so it
+    // shows whether the saved stones were used.
+    const long long kMarkedCurrentRecords = 1000;
+    BSONObjBuilder marked;
+    for (auto&& elem : saved) {
+        if (elem.fieldNameStringData() != "currentRecords") {
+            marked.append(elem);
+        }
+    }
+    marked.append("currentRecords", kMarkedCurrentRecords);
+    BSONObj markedObj = marked.obj();
+
+    ss.storeOplogStones(uri, markedObj);
+    rs = harnessHelper.newCappedRecordStore(ns, cappedMaxSize, -1, &ss);
+    wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    ASSERT_EQ(numStones, wtrs->oplogStones()->numStones());
+    ASSERT_EQ(kMarkedCurrentRecords, wtrs->oplogStones()->currentRecords());
+    ASSERT(ss.takeOplogStones(uri).isEmpty());
+    rs.reset();
+
+    // Saved stones that disagree with the size storer are ignored.
+    BSONObjBuilder stale;
+    for (auto&& elem : markedObj) {
+        if (elem.fieldNameStringData() != "numRecords") {
+            stale.append(elem);
+        }
+    }
+    stale.append("numRecords", 12LL);
+
+    ss.storeOplogStones(uri, stale.obj());
+    rs = harnessHelper.newCappedRecordStore(ns, cappedMaxSize, -1, &ss);
+    wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    ASSERT_EQ(numStones, wtrs->oplogStones()->numStones());
+    ASSERT_EQ(currentRecords, wtrs->oplogStones()->currentRecords());
+    rs.reset();
+
+    ss.flush(true);
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
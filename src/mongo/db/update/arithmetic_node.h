@@ -52,6 +52,14 @@ public:
 
     void setCollator(const CollatorInterface* collator) final {}
 
+    ArithmeticOp getOp() const {
+        return _op;
+    }
+
+    BSONElement getValue() const {
+        return _val;
+    }
+
 protected:
     ModifyResult updateExistingElement(mutablebson::Element* element,
                                        std::shared_ptr<FieldRef> elementPath) const final;
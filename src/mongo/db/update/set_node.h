@@ -50,6 +50,10 @@ public:
 
     void setCollator(const CollatorInterface* collator) final {}
 
+    BSONElement getValue() const {
+        return _val;
+    }
+
 protected:
     ModifyResult updateExistingElement(mutablebson::Element* element,
                                        std::shared_ptr<FieldRef> elementPath) const final;
@@ -40,10 +40,12 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/update/arithmetic_node.h"
 #include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/modifier_table.h"
 #include "mongo/db/update/object_replace_node.h"
 #include "mongo/db/update/path_support.h"
+#include "mongo/db/update/set_node.h"
 #include "mongo/db/update/storage_validation.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
@@ -146,6 +148,25 @@ bool parseUpdateExpression(
     return positional;
 }
 
+/**
+ * Types whose values always have the same size, so replacing one with another of these types
+ * keeps the layout of the document.
+ */
+bool isFixedWidthType(BSONType type) {
+    switch (type) {
+        case NumberDouble:
+        case NumberInt:
+        case NumberLong:
+        case NumberDecimal:
+        case Bool:
+        case Date:
+        case jstOID:
+            return true;
+        default:
+            return false;
+    }
+}
+
 }  // namespace
 
 UpdateDriver::UpdateDriver(const boost::intrusive_ptr<ExpressionContext>& expCtx)
@@ -187,9 +208,47 @@ void UpdateDriver::parse(
 
     auto root = stdx::make_unique<UpdateObjectNode>();
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
+
+    FieldRef path;
+    if (!collectInPlaceModifiers(*root, &path)) {
+        _inPlaceModifiers.clear();
+    }
     _root = std::move(root);
 }
 
+bool UpdateDriver::collectInPlaceModifiers(const UpdateObjectNode& node, FieldRef* path) {
+    if (node.hasPositionalChild()) {
+        return false;
+    }
+
+    for (const auto& child : node.getChildren()) {
+        const UpdateNode* childNode = child.second.get();
+        path->appendPart(child.first);
+
+        bool collected = false;
+        if (childNode->type == UpdateNode::Type::Object) {
+            collected =
+                collectInPlaceModifiers(static_cast<const UpdateObjectNode&>(*childNode), path);
+        } else if (childNode->context == UpdateNode::Context::kAll) {
+            if (auto setNode = dynamic_cast<const SetNode*>(childNode)) {
+                _inPlaceModifiers.push_back({*path, false, setNode->getValue()});
+                collected = true;
+            } else if (auto arithmeticNode = dynamic_cast<const ArithmeticNode*>(childNode)) {
+                if (arithmeticNode->getOp() == ArithmeticNode::ArithmeticOp::kAdd) {
+                    _inPlaceModifiers.push_back({*path, true, arithmeticNode->getValue()});
+                    collected = true;
+                }
+            }
+        }
+
+        path->removeLastPart();
+        if (!collected) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
                                                      const BSONObj& query,
                                                      const FieldRefSet& immutablePaths,
@@ -290,6 +349,134 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateInPlace(const BSONObj& doc,
+                                 const FieldRefSet& immutablePaths,
+                                 mutablebson::DamageVector* damages,
+                                 const char** source,
+                                 BSONObj* logOpRec,
+                                 bool* docWasModified) {
+    if (_inPlaceModifiers.empty() || _insert || _fromOplogApplication) {
+        return false;
+    }
+
+    // A modifier that changes the document: where its element is in 'doc' and where the new
+    // element is in '_inPlaceValues'.
+    struct Change {
+        const FieldRef* path;
+        int targetOffset;
+        int sourceOffset;
+        bool typeChanged;
+    };
+    std::vector<Change> changes;
+
+    // Check every modifier before reporting anything, so that an update which does not qualify
+    // leaves no trace and update() can start from scratch.
+    _inPlaceValues.reset();
+    BSONObjBuilder newValues(_inPlaceValues);
+    for (const auto& modifier : _inPlaceModifiers) {
+        for (auto immutablePath = immutablePaths.begin(); immutablePath != immutablePaths.end();
+             ++immutablePath) {
+            if (modifier.path.commonPrefixSize(**immutablePath) ==
+                std::min(modifier.path.numParts(), (*immutablePath)->numParts())) {
+                return false;
+            }
+        }
+        if (_indexedFields && _indexedFields->mightBeIndexed(modifier.path)) {
+            return false;
+        }
+
+        // Creating fields, or traversing arrays, changes the layout of the document.
+        BSONObj parent = doc;
+        BSONElement target;
+        for (size_t i = 0; i < modifier.path.numParts(); ++i) {
+            target = parent.getField(modifier.path.getPart(i));
+            if (i + 1 < modifier.path.numParts()) {
+                if (target.type() != BSONType::Object) {
+                    return false;
+                }
+                parent = target.embeddedObject();
+            }
+        }
+        if (!target.ok() || !isFixedWidthType(target.type())) {
+            return false;
+        }
+
+        // The same no-op rules as SetNode and ArithmeticNode.
+        const int sourceOffset = _inPlaceValues.len();
+        if (modifier.isIncrement) {
+            if (!target.isNumber()) {
+                return false;
+            }
+            SafeNum originalValue(target);
+            SafeNum valueToSet(modifier.value);
+            valueToSet += originalValue;
+            if (valueToSet.isIdentical(originalValue)) {
+                continue;
+            }
+            if (!valueToSet.isValid()) {
+                return false;
+            }
+            valueToSet.toBSON(target.fieldNameStringData(), &newValues);
+        } else {
+            if (target.binaryEqualValues(modifier.value)) {
+                continue;
+            }
+            if (!isFixedWidthType(modifier.value.type())) {
+                return false;
+            }
+            newValues.appendAs(modifier.value, target.fieldNameStringData());
+        }
+
+        const BSONElement newValue(_inPlaceValues.buf() + sourceOffset);
+        if (newValue.size() != target.size()) {
+            return false;
+        }
+        changes.push_back({&modifier.path,
+                           static_cast<int>(target.rawdata() - doc.objdata()),
+                           sourceOffset,
+                           newValue.type() != target.type()});
+    }
+    newValues.doneFast();
+
+    _affectIndices = false;
+    *source = _inPlaceValues.buf();
+    damages->clear();
+    for (const auto& change : changes) {
+        const BSONElement newValue(*source + change.sourceOffset);
+        if (change.typeChanged) {
+            damages->push_back({static_cast<mutablebson::DamageEvent::OffsetSizeType>(
+                                    change.sourceOffset),
+                                static_cast<mutablebson::DamageEvent::OffsetSizeType>(
+                                    change.targetOffset),
+                                1});
+        }
+        const int valueOffset = newValue.fieldNameSize() + 1;
+        damages->push_back(
+            {static_cast<mutablebson::DamageEvent::OffsetSizeType>(change.sourceOffset +
+                                                                   valueOffset),
+             static_cast<mutablebson::DamageEvent::OffsetSizeType>(change.targetOffset +
+                                                                   valueOffset),
+             static_cast<size_t>(newValue.valuesize())});
+    }
+    if (docWasModified) {
+        *docWasModified = !changes.empty();
+    }
+
+    if (_logOp && logOpRec) {
+        _logDoc.reset();
+        LogBuilder logBuilder(_logDoc.root());
+        for (const auto& change : changes) {
+            uassertStatusOK(logBuilder.addToSetsWithNewFieldName(
+                change.path->dottedField(), BSONElement(*source + change.sourceOffset)));
+        }
+        // See update() for why the update semantics are recorded.
+        invariant(logBuilder.setUpdateSemantics(UpdateSemantics::kUpdateNode));
+        *logOpRec = _logDoc.getObject();
+    }
+
+    return true;
+}
+
 bool UpdateDriver::isDocReplacement() const {
     return _replacementMode;
 }
@@ -103,6 +103,23 @@ public:
                   BSONObj* logOpRec = nullptr,
                   bool* docWasModified = nullptr);
 
+    /**
+     * Applies the update to 'doc' as damages, without building a mutable document. This only
+     * works when every modifier is a $set or $inc of an existing fixed width field that is not
+     * indexed, not immutable, not under an array and keeps its size. Positional updates, upserts
+     * and oplog application never qualify.
+     *
+     * On success fills 'damages' with offsets into '*source', which stays valid until the next call
+     * on this driver, fills 'logOpRec' and 'docWasModified' exactly as update() would, and returns
+     * true. Otherwise returns false without side effects, and the caller must use update().
+     */
+    bool updateInPlace(const BSONObj& doc,
+                       const FieldRefSet& immutablePaths,
+                       mutablebson::DamageVector* damages,
+                       const char** source,
+                       BSONObj* logOpRec = nullptr,
+                       bool* docWasModified = nullptr);
+
     //
     // Accessors
     //
@@ -146,6 +163,12 @@ private:
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    /**
+     * Appends the modifiers under 'node' to '_inPlaceModifiers' in the order 'node' applies them.
+     * Returns false if any of them cannot be applied by updateInPlace().
+     */
+    bool collectInPlaceModifiers(const UpdateObjectNode& node, FieldRef* path);
+
     //
     // immutable properties after parsing
     //
@@ -157,6 +180,18 @@ private:
     // The root of the UpdateNode tree.
     std::unique_ptr<UpdateNode> _root;
 
+    // A $set or $inc that updateInPlace() can apply. 'value' points into the update expression,
+    // like the value held by the UpdateNode it came from.
+    struct InPlaceModifier {
+        FieldRef path;
+        bool isIncrement;
+        BSONElement value;
+    };
+
+    // Every modifier of the update in application order, or empty if any of them does not qualify
+    // for updateInPlace().
+    std::vector<InPlaceModifier> _inPlaceModifiers;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
@@ -190,6 +225,9 @@ private:
 
     // The document used to build the oplog entry for the update.
     mutablebson::Document _logDoc;
+
+    // The new values written by updateInPlace(), which its damages point into.
+    BufBuilder _inPlaceValues;
 };
 
 }  // namespace mongo
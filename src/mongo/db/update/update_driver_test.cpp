@@ -528,5 +528,102 @@ TEST_F(CreateFromQuery, NotFullShardKeyRepl) {
         driverRepl().populateDocumentWithQueryFields(opCtx(), query, immutablePaths, doc()));
 }
 
+//
+// Tests of applying updates straight to the stored document with updateInPlace()
+//
+
+/**
+ * Applies 'update' to 'doc' with both update() and updateInPlace(). If 'expectInPlace' is set,
+ * checks that updateInPlace() accepts the update and produces the same document, oplog entry and
+ * modified flag as update(). Otherwise checks that updateInPlace() declines it.
+ */
+void assertInPlaceMatchesUpdate(const BSONObj& doc,
+                                const BSONObj& update,
+                                bool expectInPlace,
+                                const UpdateIndexData* indexData = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+    FieldRef idPath("_id");
+    FieldRefSet immutablePaths;
+    immutablePaths.insert(&idPath, nullptr);
+
+    UpdateDriver driver(expCtx);
+    driver.setLogOp(true);
+    driver.refreshIndexKeys(indexData);
+    driver.parse(update, arrayFilters);
+
+    mutablebson::DamageVector damages;
+    const char* source = nullptr;
+    BSONObj inPlaceLogObj;
+    bool inPlaceModified = false;
+    const bool inPlace = driver.updateInPlace(
+        doc, immutablePaths, &damages, &source, &inPlaceLogObj, &inPlaceModified);
+    ASSERT_EQ(expectInPlace, inPlace) << "doc: " << doc << " update: " << update;
+    if (!inPlace) {
+        return;
+    }
+
+    std::string damaged(doc.objdata(), doc.objsize());
+    for (const auto& damage : damages) {
+        std::memcpy(&damaged[damage.targetOffset], source + damage.sourceOffset, damage.size);
+    }
+
+    mutablebson::Document mutableDoc(doc, mutablebson::Document::kInPlaceEnabled);
+    BSONObj logObj;
+    bool modified = false;
+    ASSERT_OK(driver.update(StringData(), &mutableDoc, true, immutablePaths, &logObj, &modified));
+
+    ASSERT(mutableDoc.getObject().binaryEqual(BSONObj(damaged.data())))
+        << mutableDoc.getObject() << " != " << BSONObj(damaged.data());
+    ASSERT(logObj.binaryEqual(inPlaceLogObj)) << logObj << " != " << inPlaceLogObj;
+    ASSERT_EQ(modified, inPlaceModified);
+}
+
+TEST(UpdateInPlace, FixedWidthSetAndInc) {
+    const BSONObj doc = fromjson(
+        "{_id: 1, a: 1, b: 2.5, c: {d: NumberLong(3), e: true}, f: 'str', g: NumberDecimal('1')}");
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: 1}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: -1, b: 1.5, 'c.d': 4}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {g: NumberDecimal('2.5')}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {a: 7, 'c.e': false}, $inc: {b: 1}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {b: NumberLong(8)}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {'c.d': new Date(5)}}"), true);
+}
+
+TEST(UpdateInPlace, NoOps) {
+    const BSONObj doc = fromjson("{_id: 1, a: 1, b: 2.5}");
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: 0}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {a: 1, b: 2.5}}"), true);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {a: 1}, $inc: {b: 1}}"), true);
+}
+
+TEST(UpdateInPlace, DeclinesLayoutChanges) {
+    const BSONObj doc = fromjson("{_id: 1, a: 2147483647, b: 2.5, c: [1, 2], d: {e: 'x'}, f: 1}");
+    // Growing, creating or changing the width of a field.
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {z: 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {'d.z': 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {b: 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {'d.e': 'y'}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {f: 1, z: 1}}"), false);
+    // Arrays, positional updates and other modifiers.
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {'c.0': 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {'c.$[]': 1}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$mul: {b: 2}}"), false);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$setOnInsert: {f: 2}}"), false);
+    // Errors are left to update().
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {'d.e': 1}}"), false);
+    // Immutable paths.
+    assertInPlaceMatchesUpdate(doc, fromjson("{$set: {_id: 2}}"), false);
+}
+
+TEST(UpdateInPlace, DeclinesIndexedFields) {
+    UpdateIndexData indexData;
+    indexData.addPath(FieldRef("c.d"));
+    const BSONObj doc = fromjson("{_id: 1, a: 1, c: {d: 1}}");
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: 1}}"), true, &indexData);
+    assertInPlaceMatchesUpdate(doc, fromjson("{$inc: {a: 1, 'c.d': 1}}"), false, &indexData);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -99,6 +99,17 @@ public:
 
     void setChild(std::string field, std::unique_ptr<UpdateNode> child) final;
 
+    /**
+     * The children in the order apply() visits them, not including any positional child.
+     */
+    const std::map<std::string, clonable_ptr<UpdateNode>>& getChildren() const {
+        return _children;
+    }
+
+    bool hasPositionalChild() const {
+        return static_cast<bool>(_positionalChild);
+    }
+
 private:
     std::map<std::string, clonable_ptr<UpdateNode>> _children;
     clonable_ptr<UpdateNode> _positionalChild;
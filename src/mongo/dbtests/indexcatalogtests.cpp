@@ -38,6 +38,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/dbtests/dbtests.h"
 
@@ -187,12 +188,115 @@ private:
     Database* _db;
 };
 
+/**
+ * Test that IndexCatalog::indexRecords() indexes a batch of records into every index, including
+ * partial and multikey indexes.
+ */
+class IndexRecordBatch {
+public:
+    IndexRecordBatch() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&opCtx, _ns);
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db = ctx.db();
+        _coll = _db->createCollection(&opCtx, _ns);
+        _catalog = _coll->getIndexCatalog();
+        wuow.commit();
+    }
+
+    ~IndexRecordBatch() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&opCtx, _ns);
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db->dropCollection(&opCtx, _ns).transitional_ignore();
+        wuow.commit();
+    }
+
+    void run() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        dbtests::WriteContextForTests ctx(&opCtx, _ns);
+
+        ASSERT_OK(dbtests::createIndex(&opCtx, _ns, BSON("x" << 1)));
+        ASSERT_OK(dbtests::createIndex(&opCtx, _ns, BSON("y" << -1)));
+        ASSERT_OK(dbtests::createIndexFromSpec(
+            &opCtx,
+            _ns,
+            BSON("name"
+                 << "z_1"
+                 << "ns"
+                 << _ns
+                 << "key"
+                 << BSON("z" << 1)
+                 << "v"
+                 << static_cast<int>(kIndexVersion)
+                 << "partialFilterExpression"
+                 << BSON("z" << BSON("$gte" << 10)))));
+
+        // Large enough for the keys to be generated on several threads.
+        const int numDocs = 64;
+        std::vector<BSONObj> docs;
+        for (int i = 0; i < numDocs; ++i) {
+            docs.push_back(BSON("_id" << i << "x" << BSON_ARRAY(i << i + numDocs) << "y"
+                                      << (i * 7) % numDocs
+                                      << "z"
+                                      << i));
+        }
+        std::vector<BsonRecord> records;
+        for (int i = 0; i < numDocs; ++i) {
+            records.push_back({RecordId(i + 1), Timestamp(), &docs[i]});
+        }
+
+        int64_t keysInserted;
+        {
+            WriteUnitOfWork wuow(&opCtx);
+            ASSERT_OK(_catalog->indexRecords(&opCtx, records, &keysInserted));
+            wuow.commit();
+        }
+
+        // _id, two keys per document for x, y, and the documents matching the filter for z.
+        ASSERT_EQUALS(numDocs + 2 * numDocs + numDocs + (numDocs - 10), keysInserted);
+        ASSERT_EQUALS(2 * numDocs, countEntries(&opCtx, "x_1"));
+        ASSERT_EQUALS(numDocs, countEntries(&opCtx, "y_-1"));
+        ASSERT_EQUALS(numDocs - 10, countEntries(&opCtx, "z_1"));
+
+        const IndexDescriptor* desc = _catalog->findIndexByName(&opCtx, "x_1");
+        ASSERT(_catalog->getEntry(desc)->isMultikey(&opCtx));
+        desc = _catalog->findIndexByName(&opCtx, "y_-1");
+        ASSERT_FALSE(_catalog->getEntry(desc)->isMultikey(&opCtx));
+    }
+
+private:
+    long long countEntries(OperationContext* opCtx, StringData indexName) {
+        const IndexDescriptor* desc = _catalog->findIndexByName(opCtx, indexName);
+        ASSERT(desc);
+        auto cursor = _catalog->getIndex(desc)->newCursor(opCtx);
+
+        long long numEntries = 0;
+        for (auto kv = cursor->seek(kMinBSONKey, true); kv; kv = cursor->next()) {
+            numEntries++;
+        }
+        return numEntries;
+    }
+
+    IndexCatalog* _catalog;
+    Collection* _coll;
+    Database* _db;
+};
+
 class IndexCatalogTests : public Suite {
 public:
     IndexCatalogTests() : Suite("indexcatalogtests") {}
     void setupTests() {
         add<IndexIteratorTests>();
         add<RefreshEntry>();
+        add<IndexRecordBatch>();
     }
 };
 
@@ -210,6 +210,142 @@ public:
     }
 };
 
+/** A foreground build of several indexes indexes every document into each of them. */
+class InsertBuildMultipleIndexes : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        // More than one batch of documents for the bulk builders.
+        const int numDocs = 25 * 1000;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < numDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << i % 100 << "b"
+                                               << BSON_ARRAY(i << -i)
+                                               << "c"
+                                               << i)),
+                    nullOpDebug,
+                    true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlockImpl indexer(&_opCtx, coll);
+        indexer.allowInterruption();
+
+        std::vector<BSONObj> specs;
+        specs.push_back(BSON("name"
+                             << "a_1"
+                             << "ns"
+                             << coll->ns().ns()
+                             << "key"
+                             << BSON("a" << 1)
+                             << "v"
+                             << static_cast<int>(kIndexVersion)));
+        specs.push_back(BSON("name"
+                             << "b_-1"
+                             << "ns"
+                             << coll->ns().ns()
+                             << "key"
+                             << BSON("b" << -1)
+                             << "v"
+                             << static_cast<int>(kIndexVersion)));
+        specs.push_back(BSON("name"
+                             << "c_1"
+                             << "ns"
+                             << coll->ns().ns()
+                             << "key"
+                             << BSON("c" << 1)
+                             << "v"
+                             << static_cast<int>(kIndexVersion)
+                             << "partialFilterExpression"
+                             << BSON("c" << BSON("$lt" << 1000))));
+
+        ASSERT_OK(indexer.init(specs).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        ASSERT_EQUALS(numDocs, countEntries(coll, "a_1"));
+        ASSERT_EQUALS(2 * numDocs - 1, countEntries(coll, "b_-1"));
+        ASSERT_EQUALS(1000, countEntries(coll, "c_1"));
+    }
+
+private:
+    long long countEntries(Collection* coll, StringData indexName) {
+        IndexCatalog* catalog = coll->getIndexCatalog();
+        IndexDescriptor* desc = catalog->findIndexByName(&_opCtx, indexName);
+        ASSERT(desc);
+        auto cursor = catalog->getIndex(desc)->newCursor(&_opCtx);
+
+        long long numEntries = 0;
+        for (auto kv = cursor->seek(kMinBSONKey, true); kv; kv = cursor->next()) {
+            numEntries++;
+        }
+        return numEntries;
+    }
+};
+
+/** Key generation errors fail a foreground build of several indexes. */
+class InsertBuildMultipleIndexesKeyError : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = db->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            ASSERT_OK(coll->insertDocument(
+                &_opCtx,
+                InsertStatement(BSON("_id" << 1 << "a" << BSON_ARRAY(1 << 2) << "b"
+                                           << BSON_ARRAY(1 << 2))),
+                nullOpDebug,
+                true));
+            wunit.commit();
+        }
+
+        MultiIndexBlockImpl indexer(&_opCtx, coll);
+        indexer.allowInterruption();
+
+        std::vector<BSONObj> specs;
+        specs.push_back(BSON("name"
+                             << "a_1"
+                             << "ns"
+                             << coll->ns().ns()
+                             << "key"
+                             << BSON("a" << 1)
+                             << "v"
+                             << static_cast<int>(kIndexVersion)));
+        specs.push_back(BSON("name"
+                             << "a_1_b_1"
+                             << "ns"
+                             << coll->ns().ns()
+                             << "key"
+                             << BSON("a" << 1 << "b" << 1)
+                             << "v"
+                             << static_cast<int>(kIndexVersion)));
+
+        ASSERT_OK(indexer.init(specs).getStatus());
+        const Status status = indexer.insertAllDocumentsInCollection();
+        ASSERT_EQUALS(status.code(), ErrorCodes::CannotIndexParallelArrays);
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -770,6 +906,8 @@ public:
         }
         add<InsertBuildEnforceUnique<true>>();
         add<InsertBuildEnforceUnique<false>>();
+        add<InsertBuildMultipleIndexes>();
+        add<InsertBuildMultipleIndexesKeyError>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
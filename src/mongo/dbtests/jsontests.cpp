@@ -608,6 +608,23 @@ public:
     }
 };
 
+class LongStringsWithEscapes {
+public:
+    void run() {
+        // Escapes at every position of strings longer than one vector block.
+        for (size_t pos = 0; pos < 40; ++pos) {
+            std::string value(40, 'x');
+            value[pos] = '"';
+            std::string expected(value.substr(0, pos) + "\\\"" + value.substr(pos + 1));
+
+            BSONObjBuilder b;
+            b.append(std::string(pos, 'f') + "\n", value);
+            ASSERT_EQUALS("{ \"" + std::string(pos, 'f') + "\\n\" : \"" + expected + "\" }",
+                          b.done().jsonString(Strict));
+        }
+    }
+};
+
 }  // namespace JsonStringTests
 
 namespace FromJsonTests {
@@ -2689,6 +2706,49 @@ class MaxKey : public Base {
     }
 };
 
+class LongStringsWithEscapes {
+public:
+    void run() {
+        // Escapes, quotes of the other kind and multibyte characters at every position of strings
+        // longer than one vector block.
+        for (size_t pos = 0; pos < 40; ++pos) {
+            const std::string prefix(pos, 'x');
+            const std::string suffix(40 - pos, 'y');
+            ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\"" + suffix),
+                              fromjson("{a: \"" + prefix + "\\\"" + suffix + "\"}"));
+            ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\"" + suffix),
+                              fromjson("{a: '" + prefix + "\"" + suffix + "'}"));
+            ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "'\n" + suffix),
+                              fromjson("{a: \"" + prefix + "'\\n" + suffix + "\"}"));
+            ASSERT_BSONOBJ_EQ(BSON("a" << prefix + "\xc3\xa9" + suffix),
+                              fromjson("{a: \"" + prefix + "\xc3\xa9" + suffix + "\"}"));
+            ASSERT_THROWS(fromjson("{a: \"" + prefix + "\x01" + suffix + "\"}"),
+                          AssertionException);
+            ASSERT_THROWS(fromjson("{a: \"" + prefix + suffix), AssertionException);
+        }
+    }
+};
+
+class ManyFields : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        for (int i = 0; i < 100; ++i) {
+            b.append(std::string("field") + std::to_string(i), std::to_string(i));
+            b.append(std::string("n") + std::to_string(i), -i);
+        }
+        return b.obj();
+    }
+    virtual string json() const {
+        std::string json = "{";
+        for (int i = 0; i < 100; ++i) {
+            json += (i ? ", " : " ");
+            json += "\"field" + std::to_string(i) + "\" : \"" + std::to_string(i) + "\", ";
+            json += "n" + std::to_string(i) + ": -" + std::to_string(i);
+        }
+        return json + " }";
+    }
+};
+
 }  // namespace FromJsonTests
 
 class All : public Suite {
@@ -2738,6 +2798,7 @@ public:
         add<JsonStringTests::TimestampTests>();
         add<JsonStringTests::NullString>();
         add<JsonStringTests::AllTypes>();
+        add<JsonStringTests::LongStringsWithEscapes>();
 
         add<FromJsonTests::Empty>();
         add<FromJsonTests::EmptyWithSpace>();
@@ -2775,6 +2836,8 @@ public:
         add<FromJsonTests::NumbersInFieldName>();
         add<FromJsonTests::EscapeFieldName>();
         add<FromJsonTests::EscapedUnicodeToUtf8>();
+        add<FromJsonTests::LongStringsWithEscapes>();
+        add<FromJsonTests::ManyFields>();
         add<FromJsonTests::Utf8AllOnes>();
         add<FromJsonTests::Utf8FirstByteOnes>();
         add<FromJsonTests::Utf8Invalid>();
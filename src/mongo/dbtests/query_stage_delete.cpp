@@ -44,9 +44,11 @@
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageDelete {
 
@@ -128,6 +130,11 @@ private:
 class QueryStageDeleteUpcomingObjectWasDeleted : public QueryStageDeleteBase {
 public:
     void run() {
+        // Delete one document at a time.
+        const int oldBatchSize = internalDeleteMaxBatchSize.load();
+        internalDeleteMaxBatchSize.store(1);
+        ON_BLOCK_EXIT([oldBatchSize] { internalDeleteMaxBatchSize.store(oldBatchSize); });
+
         dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
 
         Collection* coll = ctx.getCollection();
@@ -180,6 +187,74 @@ public:
     }
 };
 
+/**
+ * Test that a multi-delete buffers the documents returned by its child and deletes them in batches,
+ * skipping a buffered document which was deleted while the stage was yielded.
+ */
+class QueryStageDeleteBatchedObjectWasDeleted : public QueryStageDeleteBase {
+public:
+    void run() {
+        const size_t batchSize = 20;
+        const int oldBatchSize = internalDeleteMaxBatchSize.load();
+        internalDeleteMaxBatchSize.store(batchSize);
+        ON_BLOCK_EXIT([oldBatchSize] { internalDeleteMaxBatchSize.store(oldBatchSize); });
+
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        CollectionScanParams collScanParams;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_opCtx,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_opCtx, coll, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        // Buffer the first few documents without deleting any of them.
+        for (size_t i = 0; i < batchSize / 2; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(0U, stats->docsDeleted);
+
+        // Remove the first document, which is now in the batch.
+        deleteStage.saveState();
+        BSONObj targetDoc = coll->docFor(&_opCtx, recordIds[0]).value();
+        ASSERT(!targetDoc.isEmpty());
+        remove(targetDoc);
+        deleteStage.restoreState();
+
+        // The first batch is deleted once it is full, without the removed document.
+        while (stats->docsDeleted == 0) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(batchSize - 1, stats->docsDeleted);
+
+        // Remove the rest.
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_EQUALS(0U, coll->numRecords(&_opCtx));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -254,6 +329,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteUpcomingObjectWasDeleted>();
+        add<QueryStageDeleteBatchedObjectWasDeleted>();
         add<QueryStageDeleteReturnOldDoc>();
     }
 };
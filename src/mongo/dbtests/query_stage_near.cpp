@@ -43,8 +43,10 @@
 #include "mongo/db/exec/near.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -208,4 +210,58 @@ TEST_F(QueryStageNearTest, EmptyResults) {
     ASSERT_EQUALS(results.size(), 3u);
     assertAscendingAndValid(results);
 }
+
+TEST_F(QueryStageNearTest, BufferedMemoryIsBounded) {
+    const long long oldMaxBufferedBytes = internalQueryGeoNearMaxBufferedBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryGeoNearMaxBufferedBytes.store(oldMaxBufferedBytes); });
+
+    // All of the documents below are the same size.
+    size_t docBytes;
+    {
+        WorkingSet workingSet;
+        const WorkingSetID id = workingSet.allocate();
+        WorkingSetMember* member = workingSet.get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("distance" << 0.0));
+        workingSet.transitionToOwnedObj(id);
+        docBytes = member->getMemUsage();
+    }
+    internalQueryGeoNearMaxBufferedBytes.store(3 * docBytes);
+
+    // Results are returned interval by interval, so more documents than fit in the buffer at once
+    // can be returned overall.
+    {
+        WorkingSet workingSet;
+        MockNearStage nearStage(_opCtx, &workingSet);
+        for (int i = 0; i < 10; ++i) {
+            nearStage.addInterval({BSON("distance" << i + 0.5), BSON("distance" << i + 0.25)},
+                                  i,
+                                  i + 1);
+        }
+
+        vector<BSONObj> results = advanceStage(&nearStage, &workingSet);
+        ASSERT_EQUALS(results.size(), 20u);
+        assertAscendingAndValid(results);
+        ASSERT(nearStage.isEOF());
+    }
+
+    // An interval with more documents than fit in the buffer fails.
+    {
+        WorkingSet workingSet;
+        MockNearStage nearStage(_opCtx, &workingSet);
+        nearStage.addInterval({BSON("distance" << 0.1),
+                               BSON("distance" << 0.2),
+                               BSON("distance" << 0.3),
+                               BSON("distance" << 0.4)},
+                              0.0,
+                              1.0);
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state;
+        while (PlanStage::NEED_TIME == (state = nearStage.work(&id))) {
+        }
+        ASSERT_EQUALS(PlanStage::FAILURE, state);
+        ASSERT_EQUALS(ErrorCodes::OperationFailed,
+                      WorkingSetCommon::getMemberStatus(*workingSet.get(id)).code());
+    }
+}
 }
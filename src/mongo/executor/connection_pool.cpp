@@ -71,9 +71,9 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
-     * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
-     * out.
+     * and unlock the specific pool's mutex (and can leave unlocked), we want to start the client
+     * with the lock acquired, move it into the client, then re-acquire to decrement the counter on
+     * the way out.
      *
      * This callback also (perhaps overly aggressively) binds a shared pointer to the guard.
      * It is *always* safe to reference the original specific pool in the guarded function object.
@@ -87,11 +87,11 @@ public:
     template <typename Callback>
     auto guardCallback(Callback&& cb) {
         return [ cb = std::forward<Callback>(cb), anchor = shared_from_this() ](auto&&... args) {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
             ++(anchor->_activeClients);
 
             ON_BLOCK_EXIT([anchor]() {
-                stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+                stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
                 --(anchor->_activeClients);
             });
 
@@ -103,8 +103,24 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a new lock on this pool's mutex. Every member taking a unique_lock expects it to
+     * come from here.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Returns true once the pool has entered shutdown. Such a pool can no longer hand out
+     * connections and is only waiting for its outstanding clients to drain.
+     */
+    bool isShutdown(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _state == State::kInShutdown;
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on the
+     * pool to preserve the lock on _mutex
      */
     Future<ConnectionHandle> getConnection(const HostAndPort& hostAndPort,
                                            Milliseconds timeout,
@@ -126,8 +142,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on the
+     * pool to preserve the lock on _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -203,6 +219,9 @@ private:
 private:
     ConnectionPool* const _parent;
 
+    // Guards everything below
+    stdx::mutex _mutex;
+
     const HostAndPort _hostAndPort;
 
     LRUOwnershipPool _readyPool;
@@ -287,26 +306,37 @@ void ConnectionPool::shutdown() {
     // Grab all current pools (under the lock)
     auto pools = [&] {
         stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
         return _pools;
     }();
 
     for (const auto& pair : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto lk = pair.second->lock();
         pair.second->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"),
             std::move(lk));
     }
 }
 
-void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+std::shared_ptr<ConnectionPool::SpecificPool> ConnectionPool::_findPool(
+    const HostAndPort& hostAndPort) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     auto iter = _pools.find(hostAndPort);
 
     if (iter == _pools.end())
+        return nullptr;
+
+    return iter->second;
+}
+
+void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
+    auto pool = _findPool(hostAndPort);
+
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->processFailure(Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
                          std::move(lk));
 }
@@ -321,7 +351,7 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     for (const auto& pair : pools) {
         auto& pool = pair.second;
 
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto lk = pool->lock();
         if (pool->matchesTags(lk, tags))
             continue;
 
@@ -334,14 +364,12 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto pool = _findPool(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->mutateTags(lk, mutateFunc);
 }
 
@@ -353,31 +381,63 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                              Milliseconds timeout) {
-    std::shared_ptr<SpecificPool> pool;
+    const auto shutdownStatus =
+        Status(ErrorCodes::ShutdownInProgress, "Connection pool is shutting down");
+
+    while (true) {
+        auto pool = [&]() -> std::shared_ptr<SpecificPool> {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_inShutdown) {
+                return nullptr;
+            }
+
+            auto& slot = _pools[hostAndPort];
+            if (!slot) {
+                slot = std::make_shared<SpecificPool>(this, hostAndPort);
+            }
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+            return slot;
+        }();
 
-    auto iter = _pools.find(hostAndPort);
+        if (!pool) {
+            return Future<ConnectionHandle>::makeReady(shutdownStatus);
+        }
 
-    if (iter == _pools.end()) {
-        pool = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        _pools[hostAndPort] = pool;
-    } else {
-        pool = iter->second;
-    }
+        auto lk = pool->lock();
 
-    invariant(pool);
+        if (!pool->isShutdown(lk)) {
+            return pool->getConnection(hostAndPort, timeout, std::move(lk));
+        }
 
-    return pool->getConnection(hostAndPort, timeout, std::move(lk));
+        // The pool started shutting down between the lookup and taking its lock. If that is
+        // because it sat idle past the host timeout, replace it and retry rather than waiting for
+        // it to delist itself. Pools are never replaced after the whole pool has been shut down.
+        // Connections still checked out from the old pool are unaffected, since each
+        // ConnectionHandle returns its connection to the specific pool that handed it out.
+        stdx::lock_guard<stdx::mutex> mapLk(_mutex);
+        if (_inShutdown) {
+            return Future<ConnectionHandle>::makeReady(shutdownStatus);
+        }
+
+        auto iter = _pools.find(hostAndPort);
+        if (iter != _pools.end() && iter->second == pool) {
+            _pools.erase(iter);
+        }
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    // Grab all current pools (under the lock)
+    auto pools = [&] {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        return _pools;
+    }();
 
-    for (const auto& kv : _pools) {
+    for (const auto& kv : pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
+        auto lk = pool->lock();
         ConnectionStatsPer hostStats{pool->inUseConnections(lk),
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
@@ -387,28 +447,15 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+    auto pool = _findPool(hostAndPort);
+    if (pool) {
+        auto lk = pool->lock();
+        return pool->openConnections(lk);
     }
 
     return 0;
 }
 
-void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(conn->getHostAndPort());
-
-    invariant(iter != _pools.end(),
-              str::stream() << "Tried to return connection but no pool found for "
-                            << conn->getHostAndPort());
-
-    auto pool = iter->second;
-    pool->returnConnection(conn, std::move(lk));
-}
-
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
     : _parent(parent),
       _hostAndPort(hostAndPort),
@@ -693,7 +740,9 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
 
         updateStateInLock();
 
-        // pass it to the user
+        // pass it to the user. The handle's deleter holds on to this specific pool, rather than
+        // looking the pool up by host, so the connection always comes back to the pool that owns
+        // it even if the host has been given a new pool in the meantime.
         connPtr->resetToUnknown();
         lk.unlock();
         ConnectionHandle handle(connPtr,
@@ -806,9 +855,14 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
     if (_state == State::kInShutdown) {
         // If we're in shutdown, there is nothing to update. Our clients are all gone.
         if (_processingPool.empty() && !_activeClients) {
-            // If we have no more clients that require access to us, delist from the parent pool
-            LOG(2) << "Delisting connection pool for " << _hostAndPort;
-            _parent->_pools.erase(_hostAndPort);
+            // If we have no more clients that require access to us, delist from the parent pool.
+            // A replacement pool may already have been registered for the host, leave that be.
+            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
+            auto iter = _parent->_pools.find(_hostAndPort);
+            if (iter != _parent->_pools.end() && iter->second.get() == this) {
+                LOG(2) << "Delisting connection pool for " << _hostAndPort;
+                _parent->_pools.erase(iter);
+            }
         }
         return;
     }
@@ -878,7 +932,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // Set the shutdown timer, this gets reset on any request
         _requestTimer->setTimeout(timeout, [ this, anchor = shared_from_this() ]() {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
             if (_state != State::kIdle)
                 return;
 
@@ -158,7 +158,11 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
-    void returnConnection(ConnectionInterface* connection);
+    /**
+     * Returns the specific pool for the host, or nullptr if there isn't one. Only the map lookup
+     * happens under _mutex; callers take the specific pool's own mutex afterwards.
+     */
+    std::shared_ptr<SpecificPool> _findPool(const HostAndPort& hostAndPort) const;
 
     std::string _name;
 
@@ -168,10 +172,15 @@ private:
 
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the host to pool map only. Each specific pool has its own mutex which guards its
+    // connections and requests, so checkouts against different hosts do not contend. A specific
+    // pool's mutex may be held while acquiring this one (to delist itself), never the reverse.
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
+    // Set by shutdown(). Once set, no new specific pools are created and get() fails.
+    bool _inShutdown = false;
+
     EgressTagCloserManager* _manager;
 };
 
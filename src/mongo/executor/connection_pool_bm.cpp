@@ -0,0 +1,171 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/executor/connection_pool.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+/**
+ * Timer which never fires. The benchmark never lets a pool idle out or a request expire, so the
+ * timers only need to be cheap and safe to call from any thread.
+ */
+class BenchmarkTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+    void cancelTimeout() override {}
+};
+
+/**
+ * Connection which completes its setup and refreshes inline, standing in for a network interface
+ * that is always reachable. This keeps the measured cost down to the pool's own bookkeeping.
+ */
+class BenchmarkConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    BenchmarkConnection(const HostAndPort& hostAndPort, size_t generation)
+        : _hostAndPort(hostAndPort), _generation(generation) {}
+
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+    void cancelTimeout() override {}
+
+    void indicateSuccess() override {
+        _status = Status::OK();
+    }
+
+    void indicateFailure(Status status) override {
+        _status = std::move(status);
+    }
+
+    void indicateUsed() override {
+        _lastUsed = Date_t::now();
+    }
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+
+    bool isHealthy() override {
+        return true;
+    }
+
+private:
+    Date_t getLastUsed() const override {
+        return _lastUsed;
+    }
+
+    const Status& getStatus() const override {
+        return _status;
+    }
+
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        indicateUsed();
+        cb(this, Status::OK());
+    }
+
+    void resetToUnknown() override {
+        _status = ConnectionPool::kConnectionStateUnknown;
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        indicateUsed();
+        cb(this, Status::OK());
+    }
+
+    size_t getGeneration() const override {
+        return _generation;
+    }
+
+    const HostAndPort _hostAndPort;
+    const size_t _generation;
+    Date_t _lastUsed;
+    Status _status = Status::OK();
+};
+
+class BenchmarkFactory final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort, size_t generation) override {
+        return std::make_shared<BenchmarkConnection>(hostAndPort, generation);
+    }
+
+    std::shared_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return std::make_shared<BenchmarkTimer>();
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    void shutdown() override {}
+};
+
+/**
+ * Benchmark checking a connection out of the pool and returning it. The argument is the number of
+ * hosts the threads are spread over: with one host every thread contends on the same specific
+ * pool, with more hosts the threads only share the host map.
+ *
+ * All threads executing the benchmark use the same pool.
+ */
+void BM_ConnectionPoolCheckout(benchmark::State& state) {
+    static std::unique_ptr<ConnectionPool> pool;
+    if (state.thread_index == 0) {
+        pool = stdx::make_unique<ConnectionPool>(stdx::make_unique<BenchmarkFactory>(),
+                                                 "benchmark pool");
+    }
+
+    const HostAndPort host("host", 20000 + (state.thread_index % state.range(0)));
+
+    for (auto keepRunning : state) {
+        auto conn = pool->get(host, Milliseconds(5000)).get();
+        conn->indicateSuccess();
+    }
+
+    if (state.thread_index == 0) {
+        pool.reset();
+    }
+}
+
+BENCHMARK(BM_ConnectionPoolCheckout)
+    ->ThreadRange(1, ProcessInfo::getNumAvailableCores())
+    ->ArgName("hosts")
+    ->Arg(1)
+    ->Arg(16);
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
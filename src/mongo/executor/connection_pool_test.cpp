@@ -1379,6 +1379,48 @@ TEST_F(ConnectionPoolTest, DropConnectionsByTagInMultipleViaManager) {
     dropConnectionsByTagTest(pool, manager);
 }
 
+/**
+ * Verify that once the pool is shut down no new specific pools are created, and that a connection
+ * checked out before the shutdown can still be returned.
+ */
+TEST_F(ConnectionPoolTest, GetFailsAfterShutdown) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    ConnectionPool::ConnectionHandle conn;
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn = std::move(swConn.getValue());
+             });
+    ASSERT(conn);
+
+    pool.shutdown();
+
+    bool reachedA = false;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT_EQ(ErrorCodes::ShutdownInProgress, swConn.getStatus());
+                 reachedA = true;
+             });
+    ASSERT(reachedA);
+
+    bool reachedB = false;
+    pool.get(HostAndPort("localhost:30000"),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT_EQ(ErrorCodes::ShutdownInProgress, swConn.getStatus());
+                 reachedB = true;
+             });
+    ASSERT(reachedB);
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort("localhost:30000")), 0u);
+
+    doneWith(conn);
+    conn.reset();
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
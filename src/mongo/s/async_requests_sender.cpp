@@ -34,13 +34,19 @@
 
 #include "mongo/s/async_requests_sender.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/rpc/metadata/impersonated_user_metadata.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
@@ -51,11 +57,248 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderUseBaton, bool, true);
 
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderCoalescingWindowMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "AsyncRequestsSenderCoalescingWindowMS must be non-negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+/**
+ * Returns true if every caller sending 'cmdObj' can be handed the same response. This excludes
+ * commands bound to a session or transaction, which must reach the shard once per operation, and
+ * commands which can leave a cursor open on the shard, since a cursor can only have one owner.
+ */
+bool isCoalescable(const BSONObj& cmdObj) {
+    if (cmdObj.hasField("lsid") || cmdObj.hasField("txnNumber")) {
+        return false;
+    }
+
+    const StringData commandName = cmdObj.firstElementFieldName();
+    if (commandName == "count"_sd || commandName == "distinct"_sd) {
+        return true;
+    }
+
+    // A find confined to a single batch closes its cursor before responding.
+    return commandName == "find"_sd && cmdObj["singleBatch"].trueValue();
+}
+
+/**
+ * Coalesces identical requests bound for the same host into a single remote command.
+ *
+ * The first request for a given host, database, command, metadata and caller identity opens a
+ * batch which is sent AsyncRequestsSenderCoalescingWindowMS later. Identical requests scheduled in
+ * the meantime join that batch instead of going out on their own, and every member is handed the
+ * one response. A request only ever joins a batch which has not been sent yet, so each caller is
+ * guaranteed a response which was produced after its own request was made.
+ *
+ * The caller identity is the operation's authenticated users and roles, its client metadata and
+ * its logical session, so requests made on behalf of different users are never answered with
+ * each other's responses.
+ *
+ * Each member waits on the batch through its own TaskExecutor callback handle, so canceling one
+ * member (on interruption, for example) does not affect the others. The shared request is sent
+ * with the earliest deadline of its members.
+ */
+class RequestCoalescer {
+public:
+    using ResponseCallback = stdx::function<void(const executor::RemoteCommandResponse&)>;
+
+    static RequestCoalescer& get(ServiceContext* service);
+
+    /**
+     * Schedules 'request' on 'executor' on behalf of 'opCtx', joining the pending batch for an
+     * identical request from the same identity if there is one. 'cb' runs on an executor thread
+     * with the batch's response, or with CallbackCanceled if the returned handle is canceled
+     * before the response arrives.
+     */
+    StatusWith<executor::TaskExecutor::CallbackHandle> schedule(
+        OperationContext* opCtx,
+        executor::TaskExecutor* executor,
+        const executor::RemoteCommandRequest& request,
+        ResponseCallback cb);
+
+private:
+    struct Batch {
+        explicit Batch(executor::RemoteCommandRequest request) : request(std::move(request)) {}
+
+        // The shared request carries no OperationContext, since it can outlive every member's
+        // operation. The identity metadata the egress hook would take from the OperationContext
+        // is written into the request's metadata instead.
+        const executor::RemoteCommandRequest request;
+
+        // The earliest deadline of any member, on the executor's clock.
+        Date_t deadline = Date_t::max();
+
+        // Signaled once 'response' has been set.
+        executor::TaskExecutor::EventHandle responseReady;
+        executor::RemoteCommandResponse response;
+
+        // Number of requests served by this batch, for logging.
+        size_t members = 0;
+    };
+
+    // Batches are per executor because the members wait on an event belonging to it.
+    using Key = std::pair<executor::TaskExecutor*, std::string>;
+
+    static std::string _makeKey(const executor::RemoteCommandRequest& request,
+                                const boost::optional<LogicalSessionId>& lsid);
+
+    /**
+     * Returns 'metadata' with the impersonated users and roles and the client metadata of 'opCtx'
+     * appended, as the egress metadata hook would for a request sent on behalf of 'opCtx'.
+     */
+    static BSONObj _appendIdentityMetadata(OperationContext* opCtx, const BSONObj& metadata);
+
+    /**
+     * Sends the batch's request, or fails the batch if the executor refused to run the dispatch.
+     */
+    void _dispatch(executor::TaskExecutor* executor,
+                   const Key& key,
+                   std::shared_ptr<Batch> batch,
+                   Status status);
+
+    stdx::mutex _mutex;
+    std::map<Key, std::shared_ptr<Batch>> _pending;
+};
+
+const auto getRequestCoalescer = ServiceContext::declareDecoration<RequestCoalescer>();
+
+RequestCoalescer& RequestCoalescer::get(ServiceContext* service) {
+    return getRequestCoalescer(service);
+}
+
+std::string RequestCoalescer::_makeKey(const executor::RemoteCommandRequest& request,
+                                       const boost::optional<LogicalSessionId>& lsid) {
+    str::stream key;
+    key << request.target.toString() << '\0' << request.dbname << '\0';
+    key << StringData(request.cmdObj.objdata(), request.cmdObj.objsize());
+    key << StringData(request.metadata.objdata(), request.metadata.objsize());
+    if (lsid) {
+        const auto lsidObj = lsid->toBSON();
+        key << StringData(lsidObj.objdata(), lsidObj.objsize());
+    }
+    return key;
+}
+
+BSONObj RequestCoalescer::_appendIdentityMetadata(OperationContext* opCtx,
+                                                  const BSONObj& metadata) {
+    BSONObjBuilder bob;
+    bob.appendElements(metadata);
+    rpc::writeAuthDataToImpersonatedUserMetadata(opCtx, &bob);
+    ClientMetadataIsMasterState::writeToMetadata(opCtx, &bob);
+    return bob.obj();
+}
+
+StatusWith<executor::TaskExecutor::CallbackHandle> RequestCoalescer::schedule(
+    OperationContext* opCtx,
+    executor::TaskExecutor* executor,
+    const executor::RemoteCommandRequest& request,
+    ResponseCallback cb) {
+    executor::RemoteCommandRequest sharedRequest(request.target,
+                                                 request.dbname,
+                                                 request.cmdObj,
+                                                 _appendIdentityMetadata(opCtx, request.metadata),
+                                                 nullptr);
+    Key key{executor, _makeKey(sharedRequest, opCtx->getLogicalSessionId())};
+
+    const auto remaining = opCtx->getRemainingMaxTimeMillis();
+    const auto deadline =
+        remaining == Milliseconds::max() ? Date_t::max() : executor->now() + remaining;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& batch = _pending[key];
+    if (!batch) {
+        auto newBatch = std::make_shared<Batch>(std::move(sharedRequest));
+
+        auto swEvent = executor->makeEvent();
+        if (!swEvent.isOK()) {
+            _pending.erase(key);
+            return swEvent.getStatus();
+        }
+        newBatch->responseReady = std::move(swEvent.getValue());
+
+        const auto window = Milliseconds(AsyncRequestsSenderCoalescingWindowMS.load());
+        auto swDispatch = executor->scheduleWorkAt(
+            executor->now() + window,
+            [this, executor, key, newBatch](const executor::TaskExecutor::CallbackArgs& args) {
+                _dispatch(executor, key, newBatch, args.status);
+            });
+        if (!swDispatch.isOK()) {
+            _pending.erase(key);
+            return swDispatch.getStatus();
+        }
+
+        batch = std::move(newBatch);
+    }
+
+    ++batch->members;
+    batch->deadline = std::min(batch->deadline, deadline);
+
+    return executor->onEvent(
+        batch->responseReady,
+        [ batch, cb = std::move(cb) ](const executor::TaskExecutor::CallbackArgs& args) {
+            if (!args.status.isOK()) {
+                cb(executor::RemoteCommandResponse(args.status));
+                return;
+            }
+            cb(batch->response);
+        });
+}
+
+void RequestCoalescer::_dispatch(executor::TaskExecutor* executor,
+                                 const Key& key,
+                                 std::shared_ptr<Batch> batch,
+                                 Status status) {
+    Date_t deadline;
+    {
+        // Close the batch, later requests start a new one.
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _pending.find(key);
+        invariant(it != _pending.end() && it->second == batch);
+        _pending.erase(it);
+        deadline = batch->deadline;
+    }
+
+    LOG(3) << "Sending " << batch->members << " coalesced requests to " << batch->request.target
+           << " as one";
+
+    auto request = batch->request;
+    if (status.isOK() && deadline != Date_t::max()) {
+        const auto now = executor->now();
+        if (deadline <= now) {
+            status = Status(ErrorCodes::ExceededTimeLimit,
+                            "Operation timed out before the coalesced request was sent");
+        } else {
+            request.timeout = deadline - now;
+        }
+    }
+
+    if (status.isOK()) {
+        auto swHandle = executor->scheduleRemoteCommand(
+            request,
+            [executor, batch](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                batch->response = cbData.response;
+                executor->signalEvent(batch->responseReady);
+            });
+        if (swHandle.isOK()) {
+            return;
+        }
+        status = swHandle.getStatus();
+    }
+
+    batch->response = executor::RemoteCommandResponse(std::move(status));
+    executor->signalEvent(batch->responseReady);
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -234,13 +477,28 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
     executor::RemoteCommandRequest request(
         *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
 
-    auto callbackStatus = _executor->scheduleRemoteCommand(
-        request,
-        [ remoteIndex, producer = _responseQueue.producer ](
-            const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
-            producer.push(Job{cbData, remoteIndex});
-        },
-        _baton);
+    auto callbackStatus = [&] {
+        if (AsyncRequestsSenderCoalescingWindowMS.load() > 0 && isCoalescable(remote.cmdObj)) {
+            // The shared request is not run on our baton, since it outlives this operation if
+            // other requests have joined it.
+            return RequestCoalescer::get(_opCtx->getServiceContext())
+                .schedule(_opCtx,
+                          _executor,
+                          request,
+                          [ remoteIndex, producer = _responseQueue.producer ](
+                              const executor::RemoteCommandResponse& response) {
+                              producer.push(Job{response, remoteIndex});
+                          });
+        }
+
+        return _executor->scheduleRemoteCommand(
+            request,
+            [ remoteIndex, producer = _responseQueue.producer ](
+                const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                producer.push(Job{cbData.response, remoteIndex});
+            },
+            _baton);
+    }();
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
@@ -265,11 +523,11 @@ void AsyncRequestsSender::_makeProgress() {
     remote.cbHandle = executor::TaskExecutor::CallbackHandle();
 
     // Store the response or error.
-    if (job->cbData.response.status.isOK()) {
-        remote.swResponse = std::move(job->cbData.response);
+    if (job->response.status.isOK()) {
+        remote.swResponse = std::move(job->response);
     } else {
         // TODO: call participant.markAsCommandSent on "transaction already started" errors?
-        remote.swResponse = std::move(job->cbData.response.status);
+        remote.swResponse = std::move(job->response.status);
     }
 }
 
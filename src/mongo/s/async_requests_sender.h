@@ -39,6 +39,7 @@
 #include "mongo/client/read_preference.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_id.h"
 #include "mongo/util/interruptible.h"
@@ -48,6 +49,10 @@
 
 namespace mongo {
 
+// How long a request which can be coalesced waits for identical requests to join it before it is
+// sent. Zero disables coalescing.
+extern AtomicInt32 AsyncRequestsSenderCoalescingWindowMS;
+
 /**
  * The AsyncRequestsSender allows for sending requests to a set of remote shards in parallel.
  * Work on remote nodes is accomplished by scheduling remote work in a TaskExecutor's event loop.
@@ -79,6 +84,9 @@ namespace mongo {
  *     }
  * }
  *
+ * Identical count, distinct and single batch find requests from concurrent operations may be
+ * coalesced into a single remote command, see AsyncRequestsSenderCoalescingWindowMS.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -211,7 +219,7 @@ private:
      * off thread, and this wraps up the arguments for that call.
      */
     struct Job {
-        executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
+        executor::RemoteCommandResponse response;
         size_t remoteIndex;
     };
 
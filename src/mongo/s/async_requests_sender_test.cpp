@@ -0,0 +1,203 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/remote_command_targeter_factory_mock.h"
+#include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/json.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/s/async_requests_sender.h"
+#include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/sharding_router_test_fixture.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using executor::NetworkInterfaceMock;
+using executor::RemoteCommandRequest;
+
+const HostAndPort kTestConfigShardHost = HostAndPort("FakeConfigHost", 12345);
+const ShardId kTestShardId("FakeShard1");
+const HostAndPort kTestShardHost = HostAndPort("FakeShard1Host", 12345);
+
+const int kCoalescingWindowMS = 10;
+
+class AsyncRequestsSenderTest : public ShardingTestFixture {
+public:
+    void setUp() override {
+        ShardingTestFixture::setUp();
+
+        configTargeter()->setFindHostReturnValue(kTestConfigShardHost);
+
+        ShardType shardType;
+        shardType.setName(kTestShardId.toString());
+        shardType.setHost(kTestShardHost.toString());
+
+        auto targeter = stdx::make_unique<RemoteCommandTargeterMock>();
+        targeter->setConnectionStringReturnValue(ConnectionString(kTestShardHost));
+        targeter->setFindHostReturnValue(kTestShardHost);
+        targeterFactory()->addTargeterToReturn(ConnectionString(kTestShardHost),
+                                               std::move(targeter));
+
+        setupShards({shardType});
+    }
+
+    void tearDown() override {
+        AsyncRequestsSenderCoalescingWindowMS.store(0);
+        ShardingTestFixture::tearDown();
+    }
+
+protected:
+    /**
+     * Makes an ARS which sends 'cmdObj' to the test shard 'numRequests' times.
+     */
+    std::unique_ptr<AsyncRequestsSender> makeARS(const BSONObj& cmdObj, size_t numRequests) {
+        std::vector<AsyncRequestsSender::Request> requests;
+        for (size_t i = 0; i < numRequests; ++i) {
+            requests.emplace_back(kTestShardId, cmdObj);
+        }
+
+        return stdx::make_unique<AsyncRequestsSender>(
+            operationContext(),
+            executor(),
+            "testdb",
+            requests,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            Shard::RetryPolicy::kNoRetry);
+    }
+
+    /**
+     * Runs the network forward past the coalescing window so pending batches get sent.
+     */
+    void closeCoalescingWindow() {
+        NetworkInterfaceMock::InNetworkGuard guard(network());
+        network()->runUntil(network()->now() + Milliseconds(kCoalescingWindowMS));
+    }
+
+    bool hasReadyRequests() {
+        NetworkInterfaceMock::InNetworkGuard guard(network());
+        return network()->hasReadyRequests();
+    }
+};
+
+TEST_F(AsyncRequestsSenderTest, IdenticalRequestsAreCoalesced) {
+    AsyncRequestsSenderCoalescingWindowMS.store(kCoalescingWindowMS);
+
+    auto ars = makeARS(fromjson("{count: 'testcoll', query: {a: 1}}"), 2);
+
+    auto future = launchAsync([&] {
+        size_t numResponses = 0;
+        while (!ars->done()) {
+            auto response = ars->next();
+            ASSERT_OK(response.swResponse.getStatus());
+            ASSERT_EQ(5, response.swResponse.getValue().data["n"].numberInt());
+            ++numResponses;
+        }
+        ASSERT_EQ(2U, numResponses);
+    });
+
+    closeCoalescingWindow();
+
+    onCommand([](const RemoteCommandRequest& request) {
+        ASSERT_EQ("testcoll", request.cmdObj.firstElement().valueStringData());
+        return BSON("ok" << 1 << "n" << 5);
+    });
+
+    future.timed_get(kFutureTimeout);
+
+    ASSERT_FALSE(hasReadyRequests());
+}
+
+TEST_F(AsyncRequestsSenderTest, CoalescedRequestCarriesCallerDeadline) {
+    AsyncRequestsSenderCoalescingWindowMS.store(kCoalescingWindowMS);
+    operationContext()->setDeadlineAfterNowBy(Seconds(30), ErrorCodes::MaxTimeMSExpired);
+
+    auto ars = makeARS(fromjson("{count: 'testcoll', query: {a: 1}}"), 2);
+
+    auto future = launchAsync([&] {
+        while (!ars->done()) {
+            ASSERT_OK(ars->next().swResponse.getStatus());
+        }
+    });
+
+    closeCoalescingWindow();
+
+    onCommand([](const RemoteCommandRequest& request) {
+        ASSERT_NOT_EQUALS(RemoteCommandRequest::kNoTimeout, request.timeout);
+        ASSERT_LTE(request.timeout, Milliseconds(Seconds(30)));
+        return BSON("ok" << 1 << "n" << 5);
+    });
+
+    future.timed_get(kFutureTimeout);
+
+    ASSERT_FALSE(hasReadyRequests());
+}
+
+TEST_F(AsyncRequestsSenderTest, FindWhichCanLeaveACursorOpenIsNotCoalesced) {
+    AsyncRequestsSenderCoalescingWindowMS.store(kCoalescingWindowMS);
+
+    auto ars = makeARS(fromjson("{find: 'testcoll', filter: {a: 1}}"), 2);
+
+    auto future = launchAsync([&] {
+        while (!ars->done()) {
+            ASSERT_OK(ars->next().swResponse.getStatus());
+        }
+    });
+
+    for (int i = 0; i < 2; ++i) {
+        onCommand([](const RemoteCommandRequest& request) {
+            return fromjson("{ok: 1, cursor: {id: 0, ns: 'testdb.testcoll', firstBatch: []}}");
+        });
+    }
+
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(AsyncRequestsSenderTest, RequestsAreNotCoalescedByDefault) {
+    auto ars = makeARS(fromjson("{count: 'testcoll', query: {a: 1}}"), 2);
+
+    auto future = launchAsync([&] {
+        while (!ars->done()) {
+            ASSERT_OK(ars->next().swResponse.getStatus());
+        }
+    });
+
+    for (int i = 0; i < 2; ++i) {
+        onCommand([](const RemoteCommandRequest& request) { return BSON("ok" << 1 << "n" << 5); });
+    }
+
+    future.timed_get(kFutureTimeout);
+}
+
+}  // namespace
+}  // namespace mongo
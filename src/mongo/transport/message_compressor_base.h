@@ -38,10 +38,17 @@
 #include <type_traits>
 
 namespace mongo {
+/**
+ * The numeric IDs below are sent on the wire in every OP_COMPRESSED message header and must agree
+ * with every peer that negotiates the same compressor by name. They can never be changed or
+ * reused. ID 3 is assigned to zstd upstream, so compressors added here take IDs from the top of
+ * the range, away from the IDs that upstream assigns in sequence.
+ */
 enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
     kZlib = 2,
+    kLZ4 = 128,
     kExtended = 255,
 };
 
@@ -55,7 +62,7 @@ public:
     virtual ~MessageCompressorBase() = default;
 
     /*
-     * Returns the name for subclass compressors (e.g. "snappy", "zlib", or "noop")
+     * Returns the name for subclass compressors (e.g. "snappy", "zlib", "lz4", or "noop")
      */
     const std::string& getName() const {
         return _name;
@@ -116,6 +123,34 @@ public:
         return _decompressBytesOut.loadRelaxed();
     }
 
+    /*
+     * This returns the total time in microseconds spent in compressData
+     */
+    int64_t getCompressorMicros() const {
+        return _compressMicros.loadRelaxed();
+    }
+
+    /*
+     * This returns the total time in microseconds spent in decompressData
+     */
+    int64_t getDecompressorMicros() const {
+        return _decompressMicros.loadRelaxed();
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for time spent in compressData
+     */
+    void counterHitCompressMicros(int64_t micros) {
+        _compressMicros.addAndFetch(micros);
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for time spent in decompressData
+     */
+    void counterHitDecompressMicros(int64_t micros) {
+        _decompressMicros.addAndFetch(micros);
+    }
+
 
 protected:
     /*
@@ -150,5 +185,8 @@ private:
 
     AtomicInt64 _decompressBytesIn;
     AtomicInt64 _decompressBytesOut;
+
+    AtomicInt64 _compressMicros;
+    AtomicInt64 _decompressMicros;
 };
 }  // namespace mongo
@@ -0,0 +1,109 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_lz4.h"
+#include "mongo/transport/message_compressor_registry.h"
+
+#include <algorithm>
+#include <limits>
+#include <lz4.h>
+
+namespace mongo {
+
+LZ4MessageCompressor::LZ4MessageCompressor() : MessageCompressorBase(MessageCompressor::kLZ4) {}
+
+std::size_t LZ4MessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    // LZ4_compressBound() returns 0 for inputs larger than LZ4_MAX_INPUT_SIZE, which then fail in
+    // compressData(). Messages are bounded by MaxMessageSizeBytes so this never happens in practice.
+    return static_cast<std::size_t>(::LZ4_compressBound(static_cast<int>(inputSize)));
+}
+
+StatusWith<std::size_t> LZ4MessageCompressor::compressData(ConstDataRange input,
+                                                           DataRange output) {
+    if (input.length() > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE)) {
+        return {ErrorCodes::BadValue, "Input too large for lz4 compression"};
+    }
+    if (output.length() < getMaxCompressedSize(input.length())) {
+        return {ErrorCodes::BadValue, "Output too small for max size of compressed input"};
+    }
+
+    // The bound check above guarantees that the compressed output fits, so the output length can
+    // be clamped to what LZ4 is able to address.
+    const int outCapacity = static_cast<int>(
+        std::min(output.length(), static_cast<std::size_t>(std::numeric_limits<int>::max())));
+    int outLength = ::LZ4_compress_default(input.data(),
+                                           const_cast<char*>(output.data()),
+                                           static_cast<int>(input.length()),
+                                           outCapacity);
+    if (outLength <= 0) {
+        return Status{ErrorCodes::BadValue, "Could not compress input"};
+    }
+
+    counterHitCompress(input.length(), outLength);
+    return {static_cast<std::size_t>(outLength)};
+}
+
+StatusWith<std::size_t> LZ4MessageCompressor::decompressData(ConstDataRange input,
+                                                             DataRange output) {
+    if (input.length() > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+        output.length() > static_cast<std::size_t>(LZ4_MAX_INPUT_SIZE)) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    // LZ4 blocks don't carry their own uncompressed length, so the output range must be sized
+    // exactly from the compression header, just like with snappy.
+    int ret = ::LZ4_decompress_safe(input.data(),
+                                    const_cast<char*>(output.data()),
+                                    static_cast<int>(input.length()),
+                                    static_cast<int>(output.length()));
+    if (ret < 0 || static_cast<std::size_t>(ret) != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return {output.length()};
+}
+
+
+MONGO_INITIALIZER_GENERAL(LZ4MessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(stdx::make_unique<LZ4MessageCompressor>());
+    return Status::OK();
+}
+}  // namespace mongo
@@ -37,6 +37,12 @@ namespace mongo {
 namespace {
 const auto kBytesIn = "bytesIn"_sd;
 const auto kBytesOut = "bytesOut"_sd;
+const auto kRatio = "ratio"_sd;
+const auto kMicros = "micros"_sd;
+
+double compressionRatio(int64_t uncompressed, int64_t compressed) {
+    return compressed > 0 ? static_cast<double>(uncompressed) / compressed : 0.0;
+}
 }  // namespace
 
 void appendMessageCompressionStats(BSONObjBuilder* b) {
@@ -52,13 +58,20 @@ void appendMessageCompressionStats(BSONObjBuilder* b) {
         BSONObjBuilder base(compressionSection.subobjStart(name));
 
         BSONObjBuilder compressorSection(base.subobjStart("compressor"));
-        compressorSection << kBytesIn << compressor->getCompressorBytesIn() << kBytesOut
-                          << compressor->getCompressorBytesOut();
+        const auto compressorBytesIn = compressor->getCompressorBytesIn();
+        const auto compressorBytesOut = compressor->getCompressorBytesOut();
+        compressorSection << kBytesIn << compressorBytesIn << kBytesOut << compressorBytesOut
+                          << kRatio << compressionRatio(compressorBytesIn, compressorBytesOut)
+                          << kMicros << compressor->getCompressorMicros();
         compressorSection.doneFast();
 
         BSONObjBuilder decompressorSection(base.subobjStart("decompressor"));
-        decompressorSection << kBytesIn << compressor->getDecompressorBytesIn() << kBytesOut
-                            << compressor->getDecompressorBytesOut();
+        const auto decompressorBytesIn = compressor->getDecompressorBytesIn();
+        const auto decompressorBytesOut = compressor->getDecompressorBytesOut();
+        decompressorSection << kBytesIn << decompressorBytesIn << kBytesOut
+                            << decompressorBytesOut << kRatio
+                            << compressionRatio(decompressorBytesOut, decompressorBytesIn)
+                            << kMicros << compressor->getDecompressorMicros();
         decompressorSection.doneFast();
         base.doneFast();
     }
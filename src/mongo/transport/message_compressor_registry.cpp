@@ -34,6 +34,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_lz4.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
@@ -56,6 +57,8 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "snappy"_sd;
         case MessageCompressor::kZlib:
             return "zlib"_sd;
+        case MessageCompressor::kLZ4:
+            return "lz4"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
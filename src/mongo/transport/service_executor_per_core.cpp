@@ -0,0 +1,382 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_per_core.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/thread_idle_callback.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+// The number of reactors (and reactor worker threads) to run. If the value is -1 (the default),
+// then it will be set to the number of available cores.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorReactors, int, -1);
+
+// Each worker thread will run its own reactor for this many milliseconds before checking whether
+// another reactor needs help.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorRunTimeMillis, int, 10);
+
+// When stealing work, a worker thread runs the other reactor for this many milliseconds.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorStealRunTimeMillis, int, 1);
+
+// A busy reactor must have at least this many queued tasks before other worker threads steal work
+// from it. Setting this to zero disables work stealing.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorStealThreshold, int, 2);
+
+// The number of idle threads kept ready to run tasks that may block, so that they never run on
+// the reactor threads. If the value is -1 (the default), then it will be set to number of
+// cores / 2. Setting this to zero runs every task on the reactor threads.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(perCoreServiceExecutorOffloadReservedThreads, int, -1);
+
+// Tasks scheduled with MayRecurse may be called recursively if the recursion depth is below this
+// value.
+MONGO_EXPORT_SERVER_PARAMETER(perCoreServiceExecutorRecursionLimit, int, 8);
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kTotalOffloaded = "totalOffloaded"_sd;
+constexpr auto kThreadsInUse = "threadsInUse"_sd;
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kReactors = "reactors"_sd;
+constexpr auto kOffload = "offload"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "perCore"_sd;
+
+struct ServerParameterOptions : public ServiceExecutorPerCore::Options {
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{std::max(perCoreServiceExecutorRunTimeMillis.load(), 1)};
+    }
+
+    Milliseconds workStealingRunTime() const final {
+        return Milliseconds{std::max(perCoreServiceExecutorStealRunTimeMillis.load(), 1)};
+    }
+
+    int workStealingThreshold() const final {
+        return perCoreServiceExecutorStealThreshold.load();
+    }
+
+    int offloadReservedThreads() const final {
+        int value = perCoreServiceExecutorOffloadReservedThreads;
+        if (value == -1) {
+            value = std::max(static_cast<int>(ProcessInfo::getNumAvailableCores() / 2), 2);
+            log() << "No offload thread count configured for executor. "
+                  << "Using number of cores / 2: " << value;
+        }
+        return value;
+    }
+
+    int recursionLimit() const final {
+        return perCoreServiceExecutorRecursionLimit.load();
+    }
+};
+
+}  // namespace
+
+thread_local ServiceExecutorPerCore::Core* ServiceExecutorPerCore::_localCore = nullptr;
+thread_local ServiceExecutorPerCore::Core* ServiceExecutorPerCore::_localHomeCore = nullptr;
+thread_local ServiceExecutorPerCore::Core* ServiceExecutorPerCore::_localOffloadedFromCore =
+    nullptr;
+thread_local int ServiceExecutorPerCore::_localRecursionDepth = 0;
+thread_local int64_t ServiceExecutorPerCore::_localThreadIdleCounter = 0;
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::vector<ReactorHandle> reactors)
+    : ServiceExecutorPerCore(
+          ctx, std::move(reactors), stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorPerCore::ServiceExecutorPerCore(ServiceContext* ctx,
+                                               std::vector<ReactorHandle> reactors,
+                                               std::unique_ptr<Options> config)
+    : _config(std::move(config)) {
+    invariant(!reactors.empty());
+    for (auto& reactor : reactors) {
+        _cores.emplace_back(stdx::make_unique<Core>(std::move(reactor)));
+    }
+
+    auto offloadThreads = _config->offloadReservedThreads();
+    if (offloadThreads > 0) {
+        _offloadExecutor = stdx::make_unique<ServiceExecutorReserved>(
+            ctx, "per-core offload", static_cast<size_t>(offloadThreads));
+    }
+}
+
+ServiceExecutorPerCore::~ServiceExecutorPerCore() {
+    invariant(!_isRunning.load());
+}
+
+size_t ServiceExecutorPerCore::configuredReactorCount() {
+    int value = perCoreServiceExecutorReactors;
+    if (value <= 0) {
+        value = std::max(static_cast<int>(ProcessInfo::getNumAvailableCores()), 1);
+        log() << "No reactor count configured for executor. Using number of cores: " << value;
+    }
+    return static_cast<size_t>(value);
+}
+
+Status ServiceExecutorPerCore::start() {
+    invariant(!_isRunning.load());
+    _isRunning.store(true);
+
+    if (_offloadExecutor) {
+        auto status = _offloadExecutor->start();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    for (size_t coreId = 0; coreId < _cores.size(); coreId++) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            _threadsRunning++;
+        }
+
+        auto status = launchServiceWorkerThread([this, coreId] { _workerThreadRoutine(coreId); });
+        if (!status.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            _threadsRunning--;
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorPerCore::shutdown(Milliseconds timeout) {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    _isRunning.store(false);
+
+    for (auto& core : _cores) {
+        core->reactor->stop();
+    }
+
+    bool result;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
+        result = _deathCondition.wait_for(
+            lk, timeout.toSystemDuration(), [&] { return _threadsRunning == 0; });
+    }
+
+    if (!result) {
+        return {ErrorCodes::ExceededTimeLimit,
+                "per-core executor couldn't shutdown all worker threads within time limit."};
+    }
+
+    if (_offloadExecutor) {
+        return _offloadExecutor->shutdown(timeout);
+    }
+
+    return Status::OK();
+}
+
+bool ServiceExecutorPerCore::_shouldOffload(ServiceExecutorTaskName taskName) const {
+    // Processing a message can block on locks, disk or remote hosts, everything else only waits
+    // on the network through the reactor.
+    if (!_offloadExecutor)
+        return false;
+
+    return taskName == ServiceExecutorTaskName::kSSMProcessMessage ||
+        taskName == ServiceExecutorTaskName::kSSMExhaustMessage;
+}
+
+ServiceExecutorPerCore::Core* ServiceExecutorPerCore::_pickCore() {
+    return _cores[_nextCore.fetchAndAdd(1) % _cores.size()].get();
+}
+
+Status ServiceExecutorPerCore::schedule(Task task,
+                                        ScheduleFlags flags,
+                                        ServiceExecutorTaskName taskName) {
+    if (!_isRunning.load()) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    // Tasks scheduled from a reactor thread stay on that reactor so that a connection keeps
+    // running on the core its socket belongs to. Tasks scheduled by an offloaded task go back to
+    // the core it was offloaded from. Anything else (new sessions) is spread across the reactors.
+    auto core = _localCore ? _localCore
+                           : _localOffloadedFromCore ? _localOffloadedFromCore : _pickCore();
+
+    if (_shouldOffload(taskName)) {
+        _totalOffloaded.addAndFetch(1);
+        auto offloadedTask = [ core, task = std::move(task) ] {
+            auto previousCore = _localOffloadedFromCore;
+            _localOffloadedFromCore = core;
+            const auto guard =
+                MakeGuard([previousCore] { _localOffloadedFromCore = previousCore; });
+            task();
+        };
+        return _offloadExecutor->schedule(std::move(offloadedTask), flags, taskName);
+    }
+
+    auto wrappedTask = [ this, core, task = std::move(task), flags ] {
+        core->tasksQueued.subtractAndFetch(1);
+        if (_localRecursionDepth++ == 0) {
+            core->threadsInUse.addAndFetch(1);
+        }
+        const auto guard = MakeGuard([core] {
+            if (--_localRecursionDepth == 0) {
+                core->threadsInUse.subtractAndFetch(1);
+            }
+            core->totalExecuted.addAndFetch(1);
+        });
+
+        if (_localHomeCore != core) {
+            core->totalStolen.addAndFetch(1);
+        }
+
+        task();
+
+        if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
+            (_localThreadIdleCounter++ & 0xf) == 0) {
+            markThreadIdle();
+        }
+    };
+
+    core->tasksQueued.addAndFetch(1);
+    core->totalQueued.addAndFetch(1);
+
+    // Dispatching only runs the task inline if the current thread is already running this
+    // reactor, otherwise it is equivalent to posting it.
+    if ((flags & kMayRecurse) && (_localCore == core) &&
+        (_localRecursionDepth + 1 < _config->recursionLimit())) {
+        core->reactor->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    } else {
+        core->reactor->schedule(Reactor::kPost, std::move(wrappedTask));
+    }
+
+    return Status::OK();
+}
+
+void ServiceExecutorPerCore::_workerThreadRoutine(size_t coreId) {
+    {
+        std::string threadName = str::stream() << "reactor-" << coreId;
+        setThreadName(threadName);
+    }
+
+    log() << "Started new reactor worker thread " << coreId;
+
+    auto core = _cores[coreId].get();
+    _localCore = core;
+    _localHomeCore = core;
+
+    const auto guard = MakeGuard([this] {
+        _localCore = nullptr;
+        _localHomeCore = nullptr;
+
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        _threadsRunning--;
+        _deathCondition.notify_one();
+    });
+
+    while (_isRunning.load()) {
+        core->reactor->runFor(_config->workerThreadRunTime());
+
+        if (_config->workStealingThreshold() > 0) {
+            _stealWork(core);
+        }
+    }
+}
+
+void ServiceExecutorPerCore::_stealWork(Core* home) {
+    // Only steal from reactors whose own thread is busy running a task, an idle reactor thread
+    // will pick up its queued tasks by itself.
+    Core* victim = nullptr;
+    int victimQueued = _config->workStealingThreshold() - 1;
+    for (auto& core : _cores) {
+        if (core.get() == home || core->threadsInUse.load() == 0)
+            continue;
+
+        auto queued = core->tasksQueued.load();
+        if (queued > victimQueued) {
+            victim = core.get();
+            victimQueued = queued;
+        }
+    }
+
+    if (!victim)
+        return;
+
+    LOG(3) << "Stealing " << victimQueued << " queued tasks from a busy reactor";
+
+    // Tasks that run while stealing are scheduled back onto the victim's reactor, since that is
+    // where their sockets live.
+    _localCore = victim;
+    victim->reactor->runFor(_config->workStealingRunTime());
+    _localCore = home;
+}
+
+void ServiceExecutorPerCore::appendStats(BSONObjBuilder* bob) const {
+    int64_t totalQueued = 0;
+    int64_t totalExecuted = 0;
+    int64_t totalStolen = 0;
+    int threadsInUse = 0;
+    for (auto& core : _cores) {
+        totalQueued += core->totalQueued.load();
+        totalExecuted += core->totalExecuted.load();
+        totalStolen += core->totalStolen.load();
+        threadsInUse += core->threadsInUse.load();
+    }
+
+    int threadsRunning;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+        threadsRunning = static_cast<int>(_threadsRunning);
+    }
+
+    *bob << kExecutorLabel << kExecutorName                         //
+         << kReactors << static_cast<int>(_cores.size())            //
+         << kTotalQueued << totalQueued                             //
+         << kTotalExecuted << totalExecuted                         //
+         << kTotalStolen << totalStolen                             //
+         << kTotalOffloaded << _totalOffloaded.load()               //
+         << kThreadsInUse << threadsInUse                           //
+         << kThreadsRunning << threadsRunning;
+
+    if (_offloadExecutor) {
+        BSONObjBuilder offloadSection(bob->subobjStart(kOffload));
+        _offloadExecutor->appendStats(&offloadSection);
+        offloadSection.doneFast();
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
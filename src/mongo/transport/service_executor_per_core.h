@@ -0,0 +1,157 @@
+
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_reserved.h"
+#include "mongo/transport/service_executor_task_names.h"
+#include "mongo/transport/transport_layer.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * This is an ASIO-based thread-per-core ServiceExecutor. It runs one worker thread per reactor,
+ * and the TransportLayer spreads accepted sockets across those reactors, so every connection has
+ * an affinity to one reactor and all of its networking and scheduling stays on that reactor's
+ * queue instead of one queue shared by every connection.
+ *
+ * Worker threads that find another reactor backed up while its own thread is busy running a task
+ * will steal work by running that reactor for a short time slice.
+ *
+ * Tasks that process messages may block on locks or disk, so they are offloaded to a pool of
+ * threads that grows as needed and never run on the reactor threads.
+ */
+class ServiceExecutorPerCore final : public ServiceExecutor {
+public:
+    struct Options {
+        virtual ~Options() = default;
+
+        // The amount of time each worker thread runs its own reactor before checking whether it
+        // should steal work from another reactor.
+        virtual Milliseconds workerThreadRunTime() const = 0;
+
+        // The amount of time a worker thread runs another reactor when stealing work from it.
+        virtual Milliseconds workStealingRunTime() const = 0;
+
+        // The minimum number of tasks that must be queued on a busy reactor before other worker
+        // threads steal work from it. A value of zero disables work stealing.
+        virtual int workStealingThreshold() const = 0;
+
+        // The number of idle threads the offload pool keeps ready to run blocking tasks. A value
+        // of zero disables offloading and runs every task on the reactor threads.
+        virtual int offloadReservedThreads() const = 0;
+
+        // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
+        // before stack unwinding is forced.
+        virtual int recursionLimit() const = 0;
+    };
+
+    ServiceExecutorPerCore(ServiceContext* ctx, std::vector<ReactorHandle> reactors);
+    ServiceExecutorPerCore(ServiceContext* ctx,
+                           std::vector<ReactorHandle> reactors,
+                           std::unique_ptr<Options> config);
+
+    ~ServiceExecutorPerCore();
+
+    /**
+     * Returns the number of reactors the TransportLayer should create for this executor. If the
+     * perCoreServiceExecutorReactors parameter is not set, this is the number of available cores.
+     */
+    static size_t configuredReactorCount();
+
+    Status start() final;
+    Status shutdown(Milliseconds timeout) final;
+    Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) final;
+
+    Mode transportMode() const final {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const final;
+
+private:
+    struct Core {
+        explicit Core(ReactorHandle reactorHandle) : reactor(std::move(reactorHandle)) {}
+
+        ReactorHandle reactor;
+
+        // The number of tasks scheduled on this reactor that have not started running yet.
+        AtomicWord<int> tasksQueued{0};
+
+        // Whether a thread is currently running a task on this reactor.
+        AtomicWord<int> threadsInUse{0};
+
+        AtomicWord<int64_t> totalQueued{0};
+        AtomicWord<int64_t> totalExecuted{0};
+        AtomicWord<int64_t> totalStolen{0};
+    };
+
+    bool _shouldOffload(ServiceExecutorTaskName taskName) const;
+    Core* _pickCore();
+    void _workerThreadRoutine(size_t coreId);
+    void _stealWork(Core* home);
+
+    std::unique_ptr<Options> _config;
+
+    std::vector<std::unique_ptr<Core>> _cores;
+    AtomicWord<unsigned> _nextCore{0};
+
+    std::unique_ptr<ServiceExecutorReserved> _offloadExecutor;
+
+    AtomicWord<bool> _isRunning{false};
+
+    mutable stdx::mutex _threadsMutex;
+    stdx::condition_variable _deathCondition;
+    size_t _threadsRunning = 0;
+
+    AtomicWord<int64_t> _totalOffloaded{0};
+
+    // The core whose reactor the current thread is running, and the core the current thread
+    // belongs to. These differ while a worker thread is stealing work.
+    static thread_local Core* _localCore;
+    static thread_local Core* _localHomeCore;
+    // The core an offloaded task was scheduled from, set while the task runs on an offload thread
+    // so that the work it schedules goes back to the same reactor.
+    static thread_local Core* _localOffloadedFromCore;
+    static thread_local int _localRecursionDepth;
+    static thread_local int64_t _localThreadIdleCounter;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -36,6 +36,7 @@
 
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/service_executor_per_core.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/unittest/unittest.h"
@@ -84,6 +85,28 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     }
 };
 
+struct TestPerCoreOptions : public ServiceExecutorPerCore::Options {
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{10};
+    }
+
+    Milliseconds workStealingRunTime() const final {
+        return Milliseconds{1};
+    }
+
+    int workStealingThreshold() const final {
+        return 0;
+    }
+
+    int offloadReservedThreads() const final {
+        return 1;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+};
+
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
  * the methods not needed by ServiceExecutors.
  *
@@ -177,6 +200,24 @@ protected:
     std::unique_ptr<ServiceExecutorSynchronous> executor;
 };
 
+class ServiceExecutorPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = ServiceContext::make();
+        setGlobalServiceContext(std::move(scOwned));
+
+        std::vector<ReactorHandle> reactors;
+        for (int i = 0; i < 2; i++) {
+            reactors.push_back(std::make_shared<ASIOReactor>());
+        }
+        auto configOwned = stdx::make_unique<TestPerCoreOptions>();
+        executor = stdx::make_unique<ServiceExecutorPerCore>(
+            getGlobalServiceContext(), std::move(reactors), std::move(configOwned));
+    }
+
+    std::unique_ptr<ServiceExecutorPerCore> executor;
+};
+
 void scheduleBasicTask(ServiceExecutor* exec, bool expectSuccess) {
     stdx::condition_variable cond;
     stdx::mutex mutex;
@@ -207,6 +248,128 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, TasksStayOnTheirReactor) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::condition_variable cond;
+    stdx::mutex mutex;
+    boost::optional<stdx::thread::id> firstThread;
+    boost::optional<stdx::thread::id> secondThread;
+
+    auto secondTask = [&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        secondThread = stdx::this_thread::get_id();
+        cond.notify_all();
+    };
+    auto firstTask = [&] {
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            firstThread = stdx::this_thread::get_id();
+        }
+        ASSERT_OK(executor->schedule(std::move(secondTask),
+                                     ServiceExecutor::kDeferredTask,
+                                     ServiceExecutorTaskName::kSSMSourceMessage));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(std::move(firstTask),
+                                 ServiceExecutor::kEmptyFlags,
+                                 ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return secondThread.is_initialized(); });
+
+    ASSERT_TRUE(firstThread.is_initialized());
+    ASSERT_TRUE(*firstThread == *secondThread);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, ProcessMessageIsOffloaded) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::condition_variable cond;
+    stdx::mutex mutex;
+    boost::optional<stdx::thread::id> reactorThread;
+    boost::optional<stdx::thread::id> offloadThread;
+
+    auto offloadTask = [&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        offloadThread = stdx::this_thread::get_id();
+        cond.notify_all();
+    };
+    auto reactorTask = [&] {
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            reactorThread = stdx::this_thread::get_id();
+        }
+        ASSERT_OK(executor->schedule(std::move(offloadTask),
+                                     ServiceExecutor::kMayRecurse,
+                                     ServiceExecutorTaskName::kSSMProcessMessage));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(std::move(reactorTask),
+                                 ServiceExecutor::kEmptyFlags,
+                                 ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return offloadThread.is_initialized(); });
+
+    ASSERT_TRUE(reactorThread.is_initialized());
+    ASSERT_TRUE(*reactorThread != *offloadThread);
+}
+
+TEST_F(ServiceExecutorPerCoreFixture, TasksReturnToTheirReactorAfterOffload) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // New sessions are spread round-robin across the two reactors, so run several sessions to be
+    // sure that at least one of them would move to the other reactor if affinity were lost.
+    for (int i = 0; i < 4; i++) {
+        stdx::condition_variable cond;
+        stdx::mutex mutex;
+        boost::optional<stdx::thread::id> reactorThread;
+        boost::optional<stdx::thread::id> returnThread;
+
+        auto returnTask = [&] {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            returnThread = stdx::this_thread::get_id();
+            cond.notify_all();
+        };
+        auto offloadTask = [&] {
+            ASSERT_OK(executor->schedule(std::move(returnTask),
+                                         ServiceExecutor::kDeferredTask,
+                                         ServiceExecutorTaskName::kSSMSourceMessage));
+        };
+        auto reactorTask = [&] {
+            {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                reactorThread = stdx::this_thread::get_id();
+            }
+            ASSERT_OK(executor->schedule(std::move(offloadTask),
+                                         ServiceExecutor::kMayRecurse,
+                                         ServiceExecutorTaskName::kSSMProcessMessage));
+        };
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ASSERT_OK(executor->schedule(std::move(reactorTask),
+                                     ServiceExecutor::kEmptyFlags,
+                                     ServiceExecutorTaskName::kSSMStartSession));
+        cond.wait(lk, [&] { return returnThread.is_initialized(); });
+
+        ASSERT_TRUE(reactorThread.is_initialized());
+        ASSERT_TRUE(*reactorThread == *returnThread);
+    }
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
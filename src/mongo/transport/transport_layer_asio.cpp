@@ -237,6 +237,10 @@ TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
 #endif
       _sep(sep),
       _listenerOptions(opts) {
+    _ingressReactors.push_back(_ingressReactor);
+    for (size_t i = 1; i < opts.ingressReactors; i++) {
+        _ingressReactors.push_back(std::make_shared<ASIOReactor>());
+    }
 }
 
 TransportLayerASIO::~TransportLayerASIO() = default;
@@ -830,6 +834,17 @@ ReactorHandle TransportLayerASIO::getReactor(WhichReactor which) {
     MONGO_UNREACHABLE;
 }
 
+std::vector<ReactorHandle> TransportLayerASIO::getIngressReactors() {
+    return {_ingressReactors.begin(), _ingressReactors.end()};
+}
+
+TransportLayerASIO::ASIOReactor& TransportLayerASIO::_nextIngressReactor() {
+    if (_ingressReactors.size() == 1) {
+        return *_ingressReactor;
+    }
+    return *_ingressReactors[_nextIngressReactorIdx.fetchAndAdd(1) % _ingressReactors.size()];
+}
+
 void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
     auto acceptCb = [this, &acceptor](const std::error_code& ec, GenericSocket peerSocket) mutable {
         if (!_running.load())
@@ -853,7 +868,7 @@ void TransportLayerASIO::_acceptConnection(GenericAcceptor& acceptor) {
         _acceptConnection(acceptor);
     };
 
-    acceptor.async_accept(*_ingressReactor, std::move(acceptCb));
+    acceptor.async_accept(_nextIngressReactor(), std::move(acceptCb));
 }
 
 #ifdef MONGO_CONFIG_SSL
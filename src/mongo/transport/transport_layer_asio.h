@@ -36,6 +36,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -109,6 +110,7 @@ public:
         Mode transportMode = Mode::kSynchronous;  // whether accepted sockets should be put into
                                                   // non-blocking mode after they're accepted
         size_t maxConns = DEFAULT_MAX_CONN;       // maximum number of active connections
+        size_t ingressReactors = 1;               // reactors accepted sockets are spread across
     };
 
     TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
@@ -128,6 +130,12 @@ public:
 
     ReactorHandle getReactor(WhichReactor which) final;
 
+    /**
+     * Returns all the reactors that accepted sockets are spread across. The first one is the
+     * reactor returned by getReactor(kIngress).
+     */
+    std::vector<ReactorHandle> getIngressReactors();
+
     Status start() final;
 
     void shutdown() final;
@@ -149,6 +157,8 @@ private:
 
     void _acceptConnection(GenericAcceptor& acceptor);
 
+    ASIOReactor& _nextIngressReactor();
+
     template <typename Endpoint>
     StatusWith<ASIOSessionHandle> _doSyncConnect(Endpoint endpoint,
                                                  const HostAndPort& peer,
@@ -164,6 +174,10 @@ private:
     // all the accepted sockets and all ingress networking activity. The _acceptorReactor contains
     // all the sockets in _acceptors.  The _egressReactor contains egress connections.
     //
+    // If more than one ingress reactor is requested through the options, the accepted sockets are
+    // spread across _ingressReactors in a round-robin fashion. _ingressReactor is always the first
+    // entry in _ingressReactors.
+    //
     // TransportLayerASIO should never call run() on the _ingressReactor.
     // In synchronous mode, this will cause a massive performance degradation due to
     // unnecessary wakeups on the asio thread for sockets we don't intend to interact
@@ -183,6 +197,8 @@ private:
     // other reactor associated state before we drop the refcount on the reactor, which may destroy
     // it.
     std::shared_ptr<ASIOReactor> _ingressReactor;
+    std::vector<std::shared_ptr<ASIOReactor>> _ingressReactors;
+    AtomicWord<unsigned> _nextIngressReactorIdx{0};
     std::shared_ptr<ASIOReactor> _egressReactor;
     std::shared_ptr<ASIOReactor> _acceptorReactor;
 
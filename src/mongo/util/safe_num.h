@@ -162,7 +162,11 @@ public:
     friend class mutablebson::Element;
     friend class mutablebson::Document;
 
-    // TODO: output to builder
+    /**
+     * Appends this number to 'bob' under 'fieldName' with its own type. Must not be called on an
+     * invalid SafeNum.
+     */
+    void toBSON(StringData fieldName, BSONObjBuilder* bob) const;
 
     //
     // accessors
@@ -20,6 +20,7 @@ Copyright (c) 2006, 2018, Percona and/or its affiliates. All rights reserved.
 
 #include <stdio.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -45,9 +46,37 @@ typedef struct {
     const EVP_CIPHER *cipher;
     int iv_len;
     unsigned char key[KEY_LEN];
+    // identifies the cipher and key currently loaded into this encryptor
+    // see cipher_ctx_acquire
+    uint64_t key_gen;
     uint32_t (*wiredtiger_checksum_crc32c)(const void *, size_t);
 } PERCONA_ENCRYPTOR;
 
+// Expanding the AES key schedule and allocating a cipher context for every block
+// is a significant part of the encryption cost for small pages. Every thread
+// keeps a few initialized contexts per direction, each tagged with the key
+// generation it was initialized with. A context with a matching generation only
+// needs its IV reset.
+// Key generations are never reused, so a stale context can't be mistaken for a
+// fresh one even if an encryptor is freed and another one is allocated at the
+// same address.
+#define CIPHER_CTX_CACHE_SIZE 4
+
+typedef struct {
+    EVP_CIPHER_CTX *ctx;
+    uint64_t key_gen; // 0 means no key is loaded
+} CACHED_CIPHER_CTX;
+
+typedef struct {
+    // [0] - decryption, [1] - encryption
+    CACHED_CIPHER_CTX entries[2][CIPHER_CTX_CACHE_SIZE];
+} CIPHER_CTX_CACHE;
+
+static uint64_t last_key_gen = 0;
+static pthread_key_t cipher_ctx_cache_key;
+static pthread_once_t cipher_ctx_cache_once = PTHREAD_ONCE_INIT;
+static bool cipher_ctx_cache_enabled = false;
+
 
 static const bool printDebugMessages = false;
 #define DBG if (printDebugMessages)
@@ -166,6 +195,87 @@ static int dump_config_arg(PERCONA_ENCRYPTOR *pe, WT_SESSION *session, WT_CONFIG
     return 0;
 }
 
+static void next_key_gen(PERCONA_ENCRYPTOR *pe) {
+    __atomic_store_n(&pe->key_gen,
+                     __atomic_add_fetch(&last_key_gen, 1, __ATOMIC_RELAXED),
+                     __ATOMIC_RELEASE);
+}
+
+static void free_cipher_ctx_cache(void *p) {
+    CIPHER_CTX_CACHE *cache = (CIPHER_CTX_CACHE*)p;
+    for (int enc = 0; enc < 2; ++enc) {
+        for (int i = 0; i < CIPHER_CTX_CACHE_SIZE; ++i) {
+            if (cache->entries[enc][i].ctx)
+                EVP_CIPHER_CTX_free(cache->entries[enc][i].ctx);
+        }
+    }
+    free(cache);
+}
+
+static void init_cipher_ctx_cache(void) {
+    cipher_ctx_cache_enabled =
+        pthread_key_create(&cipher_ctx_cache_key, free_cipher_ctx_cache) == 0;
+}
+
+static CIPHER_CTX_CACHE *get_cipher_ctx_cache(void) {
+    pthread_once(&cipher_ctx_cache_once, init_cipher_ctx_cache);
+    if (!cipher_ctx_cache_enabled)
+        return NULL;
+    CIPHER_CTX_CACHE *cache = pthread_getspecific(cipher_ctx_cache_key);
+    if (!cache) {
+        if ((cache = calloc(1, sizeof(CIPHER_CTX_CACHE))) == NULL)
+            return NULL;
+        if (pthread_setspecific(cipher_ctx_cache_key, cache) != 0) {
+            free(cache);
+            return NULL;
+        }
+    }
+    return cache;
+}
+
+static void cipher_ctx_release(CACHED_CIPHER_CTX *cc, CACHED_CIPHER_CTX *local, int ret) {
+    if (cc != local) {
+        // don't trust the state of a context which has failed
+        if (ret != 0)
+            cc->key_gen = 0;
+        return;
+    }
+    EVP_CIPHER_CTX_free(local->ctx);
+    local->ctx = NULL;
+}
+
+// Returns a cipher context ready to process a block with the given IV.
+// If the calling thread has no cache the context is allocated in 'local'.
+// Returns NULL on failure, OpenSSL errors are left in the error queue.
+// Every successful call should be paired with cipher_ctx_release.
+// Contexts which are not cached are freed on release.
+static CACHED_CIPHER_CTX *cipher_ctx_acquire(PERCONA_ENCRYPTOR *pe, int enc,
+    const uint8_t *iv, CACHED_CIPHER_CTX *local)
+{
+    uint64_t key_gen = __atomic_load_n(&pe->key_gen, __ATOMIC_ACQUIRE);
+    CIPHER_CTX_CACHE *cache = get_cipher_ctx_cache();
+    CACHED_CIPHER_CTX *cc = local;
+    if (cache)
+        cc = &cache->entries[enc][key_gen % CIPHER_CTX_CACHE_SIZE];
+
+    if (!cc->ctx) {
+        cc->key_gen = 0;
+        if ((cc->ctx = EVP_CIPHER_CTX_new()) == NULL)
+            return NULL;
+    }
+
+    // passing NULL cipher and key keeps the already expanded key schedule
+    int res = cc->key_gen == key_gen
+        ? EVP_CipherInit_ex(cc->ctx, NULL, NULL, NULL, iv, enc)
+        : EVP_CipherInit_ex(cc->ctx, pe->cipher, NULL, pe->key, iv, enc);
+    if (res != 1) {
+        cipher_ctx_release(cc, local, EINVAL);
+        return NULL;
+    }
+    cc->key_gen = key_gen;
+    return cc;
+}
+
 static int parse_customization_config(PERCONA_ENCRYPTOR *pe, WT_SESSION *session, WT_CONFIG_ARG *config) {
     WT_EXTENSION_API *wt_api = pe->wt_api;
     WT_CONFIG_PARSER *parser = NULL;
@@ -179,6 +289,7 @@ static int parse_customization_config(PERCONA_ENCRYPTOR *pe, WT_SESSION *session
                 ret = report_error(pe, session, EINVAL, "cannot get key by keyid");
                 break;
             }
+            next_key_gen(pe);
         }
     }
     parser->close(parser);
@@ -216,15 +327,9 @@ static int percona_encrypt_cbc(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
                 ENOMEM, "encrypt buffer not big enough"));
 
     *result_lenp = 0;
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX ctx_value;
-    EVP_CIPHER_CTX *ctx= &ctx_value;
-    EVP_CIPHER_CTX_init(ctx);
-#else
-    EVP_CIPHER_CTX *ctx= EVP_CIPHER_CTX_new();
-    if (unlikely(!ctx))
-        goto err;
-#endif
+    CACHED_CIPHER_CTX local = {NULL, 0};
+    CACHED_CIPHER_CTX *cc = NULL;
+    EVP_CIPHER_CTX *ctx = NULL;
 
 #ifdef DBG_ENC_EXT
     DEBUG_DATA *dbg_data = (DEBUG_DATA*)dst;
@@ -242,8 +347,9 @@ static int percona_encrypt_cbc(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
     store_IV(pe, iv);
     *result_lenp += pe->iv_len;
 
-    if(1 != EVP_EncryptInit_ex(ctx, pe->cipher, NULL, pe->key, iv))
+    if ((cc = cipher_ctx_acquire(pe, 1, iv, &local)) == NULL)
         goto err;
+    ctx = cc->ctx;
 
     if(1 != EVP_EncryptUpdate(ctx, dst + *result_lenp, &encrypted_len, src, src_len))
         goto err;
@@ -260,11 +366,8 @@ err:
     handleErrors(pe, session, &ret);
 
 cleanup:
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    if (cc)
+        cipher_ctx_release(cc, &local, ret);
     DBG_MSG("exiting encrypt %lu", *result_lenp);
 #ifdef DBG_ENC_EXT
     dbg_data->result_len = *result_lenp;
@@ -286,15 +389,9 @@ static int percona_encrypt_gcm(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
                 ENOMEM, "encrypt buffer not big enough"));
 
     *result_lenp = 0;
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX ctx_value;
-    EVP_CIPHER_CTX *ctx= &ctx_value;
-    EVP_CIPHER_CTX_init(ctx);
-#else
-    EVP_CIPHER_CTX *ctx= EVP_CIPHER_CTX_new();
-    if (unlikely(!ctx))
-        goto err;
-#endif
+    CACHED_CIPHER_CTX local = {NULL, 0};
+    CACHED_CIPHER_CTX *cc = NULL;
+    EVP_CIPHER_CTX *ctx = NULL;
 
     if (0 != get_iv_gcm(dst, pe->iv_len)) {
         ret = report_error(pe, session, EINVAL, "failed generating IV for GCM");
@@ -302,8 +399,9 @@ static int percona_encrypt_gcm(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
     }
     *result_lenp += pe->iv_len;
 
-    if(1 != EVP_EncryptInit_ex(ctx, pe->cipher, NULL, pe->key, dst))
+    if ((cc = cipher_ctx_acquire(pe, 1, dst, &local)) == NULL)
         goto err;
+    ctx = cc->ctx;
 
     // we don't provide any AAD data yet
 
@@ -327,11 +425,8 @@ err:
     handleErrors(pe, session, &ret);
 
 cleanup:
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    if (cc)
+        cipher_ctx_release(cc, &local, ret);
     DBG_MSG("exiting encrypt %lu", *result_lenp);
     return ret;
 }
@@ -348,15 +443,9 @@ static int percona_decrypt_cbc(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
     DBG_MSG("entering decrypt %lu %lu", src_len, dst_len);
 
     *result_lenp = 0;
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX ctx_value;
-    EVP_CIPHER_CTX *ctx= &ctx_value;
-    EVP_CIPHER_CTX_init(ctx);
-#else
-    EVP_CIPHER_CTX *ctx= EVP_CIPHER_CTX_new();
-    if (unlikely(!ctx))
-        goto err;
-#endif
+    CACHED_CIPHER_CTX local = {NULL, 0};
+    CACHED_CIPHER_CTX *cc = NULL;
+    EVP_CIPHER_CTX *ctx = NULL;
 
 #ifdef DBG_ENC_EXT
     DEBUG_DATA *dbg_data = (DEBUG_DATA*)src;
@@ -375,8 +464,9 @@ static int percona_decrypt_cbc(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
     src += CHKSUM_LEN;
     src_len -= CHKSUM_LEN;
 
-    if(1 != EVP_DecryptInit_ex(ctx, pe->cipher, NULL, pe->key, src))
+    if ((cc = cipher_ctx_acquire(pe, 0, src, &local)) == NULL)
         goto err;
+    ctx = cc->ctx;
     src += pe->iv_len;
     src_len -= pe->iv_len;
 
@@ -405,11 +495,8 @@ err:
     }
 
 cleanup:
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    if (cc)
+        cipher_ctx_release(cc, &local, ret);
     DBG_MSG("exiting decrypt %lu", *result_lenp);
     return ret;
 }
@@ -425,18 +512,13 @@ static int percona_decrypt_gcm(WT_ENCRYPTOR *encryptor, WT_SESSION *session,
     DBG_MSG("entering decrypt %lu %lu", src_len, dst_len);
 
     *result_lenp = 0;
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX ctx_value;
-    EVP_CIPHER_CTX *ctx= &ctx_value;
-    EVP_CIPHER_CTX_init(ctx);
-#else
-    EVP_CIPHER_CTX *ctx= EVP_CIPHER_CTX_new();
-    if (unlikely(!ctx))
-        goto err;
-#endif
+    CACHED_CIPHER_CTX local = {NULL, 0};
+    CACHED_CIPHER_CTX *cc = NULL;
+    EVP_CIPHER_CTX *ctx = NULL;
 
-    if(1 != EVP_DecryptInit_ex(ctx, pe->cipher, NULL, pe->key, src))
+    if ((cc = cipher_ctx_acquire(pe, 0, src, &local)) == NULL)
         goto err;
+    ctx = cc->ctx;
     src += pe->iv_len;
     src_len -= pe->iv_len;
 
@@ -468,11 +550,8 @@ err:
     }
 
 cleanup:
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-    EVP_CIPHER_CTX_cleanup(ctx);
-#else
-    EVP_CIPHER_CTX_free(ctx);
-#endif
+    if (cc)
+        cipher_ctx_release(cc, &local, ret);
     DBG_MSG("exiting decrypt %lu", *result_lenp);
     return ret;
 }
@@ -605,6 +684,7 @@ int percona_encryption_extension_init(WT_CONNECTION *connection, WT_CONFIG_ARG *
         goto failure;
 
     pe->iv_len = EVP_CIPHER_iv_length(pe->cipher);
+    next_key_gen(pe);
     DBG_MSG("IV len is %d", pe->iv_len);
     DBG_MSG("key len is %d", EVP_CIPHER_key_length(pe->cipher));
 